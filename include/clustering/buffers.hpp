@@ -7,6 +7,10 @@
 
 namespace nbs {
     namespace cluster {
+        // Most dimensions k-means buffers hold centroid sums for, as buffers are
+        // allocated without knowing the dimensions of the particles.
+        constexpr size_t MAX_KMEANS_DIMENSIONS = 3;
+
         namespace detail {
             struct NearestCentroid {
                 ui32          idx;
@@ -16,6 +20,13 @@ namespace nbs {
             struct NearestCentroidList {
                 ui32* indices;
             };
+
+            // A particle of an oversized cluster that capping may move out of it.
+            struct CapCandidate {
+                ui32          cluster_idx;
+                NBS_PRECISION distance_2;
+                ui32          particle_idx;
+            };
         }  // namespace detail
 
         template <KMeansOptions, typename = void>
@@ -27,6 +38,11 @@ namespace nbs {
             typename std::enable_if_t<!Options.centroid_subset_optimisation>> {
             detail::NearestCentroid* particle_nearest_centroid;
             bool*                    cluster_modified_in_iteration;
+            // Sums of the positions of the particles joining each cluster, a
+            // cluster's Dimensions sums at [cluster_idx * Dimensions].
+            NBS_ACCUMULATION_PRECISION* centroid_sums;
+            // Particles capping may move, only allocated if cluster sizes are capped.
+            detail::CapCandidate* cap_candidates;
         };
 
         template <KMeansOptions Options>
@@ -35,8 +51,9 @@ namespace nbs {
             typename std::enable_if_t<Options.centroid_subset_optimisation>> {
             detail::NearestCentroid*     particle_nearest_centroid;
             bool*                        cluster_modified_in_iteration;
+            NBS_ACCUMULATION_PRECISION*  centroid_sums;
+            detail::CapCandidate*        cap_candidates;
             detail::NearestCentroidList* nearest_centroid_lists;
-            ui32*                        nearest_centroid_indices;
         };
 
         template <KMeansOptions Options>
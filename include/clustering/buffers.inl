@@ -5,14 +5,18 @@ void nbs::cluster::allocate_kmeans_buffers(
     buffers.particle_nearest_centroid
         = new detail::NearestCentroid[Options.particle_count];
     buffers.cluster_modified_in_iteration = new bool[Options.cluster_count];
+    buffers.centroid_sums
+        = new NBS_ACCUMULATION_PRECISION[Options.cluster_count * MAX_KMEANS_DIMENSIONS];
+    buffers.cap_candidates = Options.max_cluster_size > 0
+                                 ? new detail::CapCandidate[Options.particle_count]
+                                 : nullptr;
 
     if constexpr (Options.centroid_subset_optimisation) {
-        buffers.nearest_centroid_indices = new size_t[Options.cluster_count];
         buffers.nearest_centroid_lists
             = new detail::NearestCentroidList[Options.particle_count];
 
         for (size_t i = 0; i < Options.particle_count; ++i) {
-            buffers.nearest_centroid_lists[i]
+            buffers.nearest_centroid_lists[i].indices
                 = new ui32[Options.centroid_subset.k_prime];
         }
     }
@@ -24,13 +28,14 @@ void nbs::cluster::deallocate_kmeans_buffers(
 ) {
     if constexpr (Options.centroid_subset_optimisation) {
         for (size_t i = 0; i < Options.particle_count; ++i) {
-            delete[] buffers.nearest_centroid_lists[i];
+            delete[] buffers.nearest_centroid_lists[i].indices;
         }
 
         delete[] buffers.nearest_centroid_lists;
-        delete[] buffers.nearest_centroid_indices;
     }
 
+    delete[] buffers.cap_candidates;
+    delete[] buffers.centroid_sums;
     delete[] buffers.cluster_modified_in_iteration;
     delete[] buffers.particle_nearest_centroid;
 }
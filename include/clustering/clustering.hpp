@@ -1,2 +1,4 @@
 #include "k_means.hpp"
 #include "kpp.hpp"
+#include "moments.hpp"
+#include "recluster.hpp"
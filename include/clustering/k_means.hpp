@@ -8,9 +8,45 @@
 #include "clustering/buffers.hpp"
 #include "clustering/cluster.hpp"
 #include "clustering/options.hpp"
+#include "parallel/reduce.hpp"
 
 namespace nbs {
     namespace cluster {
+        namespace detail {
+            /**
+             * \brief Moves the particles furthest from the centroid of each cluster
+             * holding more than Options.max_cluster_size particles to the nearest
+             * centroid with room, until none hold more. Particle counts of clusters
+             * and nearest centroids in buffers are updated, and the centroids of the
+             * clusters particles left or joined are recalculated from their
+             * particles.
+             */
+            template <
+                size_t                        Dimensions,
+                ClusteredParticle<Dimensions> ParticleType,
+                KMeansOptions                 Options>
+            void cap_cluster_sizes(
+                const ParticleType*                       particles,
+                IN OUT Cluster<Dimensions, ParticleType>* clusters,
+                IN OUT KMeansBuffers<Options>             buffers
+            );
+        }  // namespace detail
+
+        /**
+         * \brief Clusters particles by k-means, starting from initial_clusters.
+         *
+         * If moved_particles is given, indexed by cluster_metadata_idx, particles not
+         * flagged keep the nearest centroid held for them in buffers from the last
+         * clustering, so only particles that have moved are reconsidered. Only valid
+         * for a warm start, so ignored if front loaded.
+         *
+         * Nearest centroids are found on the threads of pool if given, while the sums
+         * for the new centroids are made serially in a fixed order, so clusterings
+         * do not depend on the number of threads.
+         *
+         * If Options.max_cluster_size is set, clusters are capped to that size once
+         * converged, see detail::cap_cluster_sizes.
+         */
         template <
             size_t                        Dimensions,
             ClusteredParticle<Dimensions> ParticleType,
@@ -19,7 +55,9 @@ namespace nbs {
             IN OUT CALLER_DELETE ParticleType* particles,
             IN OUT CALLER_DELETE Cluster<Dimensions, ParticleType>* initial_clusters,
             OUT CALLER_DELETE Cluster<Dimensions, ParticleType>* final_clusters,
-            IN OUT KMeansBuffers<Options> buffers
+            IN OUT KMeansBuffers<Options> buffers,
+            const bool*                   moved_particles = nullptr,
+            parallel::ThreadPool*         pool            = nullptr
         );
     }  // namespace cluster
 }  // namespace nbs
@@ -1,5 +1,155 @@
 #include "nearest_centroid.hpp"
 
+template <
+    size_t                             Dimensions,
+    nbs::ClusteredParticle<Dimensions> ParticleType,
+    nbs::cluster::KMeansOptions        Options>
+void nbs::cluster::detail::cap_cluster_sizes(
+    const ParticleType*                       particles,
+    IN OUT Cluster<Dimensions, ParticleType>* clusters,
+    IN OUT KMeansBuffers<Options>             buffers
+) {
+    using Candidate = detail::CapCandidate;
+
+    // Particles of oversized clusters, which may be moved out of them.
+    Candidate* candidates      = buffers.cap_candidates;
+    size_t     candidate_count = 0;
+    for (ui32 particle_idx = 0; particle_idx < Options.particle_count; ++particle_idx) {
+        const ParticleType& particle = particles[particle_idx];
+        const ui32          cluster_idx
+            = buffers.particle_nearest_centroid[particle.cluster_metadata_idx].idx;
+
+        if (clusters[cluster_idx].particle_count <= Options.max_cluster_size) continue;
+
+        candidates[candidate_count++] = Candidate{
+            .cluster_idx = cluster_idx,
+            .distance_2  = distance_2<Dimensions, Options>(
+                particle.position, clusters[cluster_idx].centroid.position
+            ),
+            .particle_idx = particle_idx };
+    }
+
+    if (candidate_count == 0) return;
+
+    // Furthest particles of each cluster first, ties broken by index so that the
+    // particles moved do not depend on where they sit.
+    std::sort(
+        candidates,
+        candidates + candidate_count,
+        [&particles](const Candidate& lhs, const Candidate& rhs) {
+            if (lhs.cluster_idx != rhs.cluster_idx) {
+                return lhs.cluster_idx < rhs.cluster_idx;
+            }
+            if (lhs.distance_2 != rhs.distance_2) {
+                return lhs.distance_2 > rhs.distance_2;
+            }
+            return particles[lhs.particle_idx].cluster_metadata_idx
+                   < particles[rhs.particle_idx].cluster_metadata_idx;
+        }
+    );
+
+    // Clusters particles are moved out of or into, whose centroids are then stale.
+    bool* touched = buffers.cluster_modified_in_iteration;
+    std::fill_n(touched, Options.cluster_count, false);
+
+    for (size_t candidate_idx = 0; candidate_idx < candidate_count; ++candidate_idx) {
+        const Candidate&                   candidate = candidates[candidate_idx];
+        Cluster<Dimensions, ParticleType>& cluster   = clusters[candidate.cluster_idx];
+
+        if (cluster.particle_count <= Options.max_cluster_size) continue;
+
+        const ParticleType& particle = particles[candidate.particle_idx];
+        NearestCentroid&    nearest_centroid
+            = buffers.particle_nearest_centroid[particle.cluster_metadata_idx];
+
+        // As the clusters have room for every particle, some cluster has room while
+        // this one is oversized.
+        nearest_centroid.distance = std::numeric_limits<NBS_PRECISION>::max();
+        for (ui32 cluster_idx = 0; cluster_idx < Options.cluster_count; ++cluster_idx) {
+            if (clusters[cluster_idx].particle_count >= Options.max_cluster_size) {
+                continue;
+            }
+
+            const NBS_PRECISION centroid_distance_2 = distance_2<Dimensions, Options>(
+                particle.position, clusters[cluster_idx].centroid.position
+            );
+
+            if (centroid_distance_2 < nearest_centroid.distance) {
+                nearest_centroid.idx      = cluster_idx;
+                nearest_centroid.distance = centroid_distance_2;
+            }
+        }
+        assert(nearest_centroid.idx != candidate.cluster_idx);
+
+        --cluster.particle_count;
+        ++clusters[nearest_centroid.idx].particle_count;
+
+        touched[candidate.cluster_idx] = true;
+        touched[nearest_centroid.idx]  = true;
+    }
+
+    /************
+       Recalculate the centroids of touched clusters from their particles.
+                                                                 ************/
+
+    NBS_ACCUMULATION_PRECISION* centroid_sums = buffers.centroid_sums;
+    std::fill_n(centroid_sums, Options.cluster_count * Dimensions, 0);
+
+    // As in k_means, periodic positions are summed as offsets from the old centroid.
+    for (ui32 particle_idx = 0; particle_idx < Options.particle_count; ++particle_idx) {
+        const ParticleType& particle = particles[particle_idx];
+        const ui32          cluster_idx
+            = buffers.particle_nearest_centroid[particle.cluster_metadata_idx].idx;
+
+        if (!touched[cluster_idx]) continue;
+
+        vec<Dimensions, NBS_PRECISION> position = particle.position;
+        if constexpr (Options.periodic) {
+            position = spatial::nearest_image<Dimensions>(
+                position - clusters[cluster_idx].centroid.position, Options.box_size
+            );
+        }
+
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            centroid_sums[cluster_idx * Dimensions + dim] += position[dim];
+        }
+    }
+
+    for (ui32 cluster_idx = 0; cluster_idx < Options.cluster_count; ++cluster_idx) {
+        if (!touched[cluster_idx]) continue;
+
+        Cluster<Dimensions, ParticleType>& cluster = clusters[cluster_idx];
+
+        vec<Dimensions, NBS_PRECISION>   mean;
+        const NBS_ACCUMULATION_PRECISION particle_count = cluster.particle_count;
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            mean[dim] = centroid_sums[cluster_idx * Dimensions + dim] / particle_count;
+        }
+
+        if constexpr (Options.periodic) {
+            cluster.centroid.position = spatial::wrap_position<Dimensions>(
+                cluster.centroid.position + mean, Options.box_size
+            );
+        } else {
+            cluster.centroid.position = mean;
+        }
+    }
+
+    // Distances to the moved centroids, for the approaching centroid test of the next
+    // warm start.
+    for (ui32 particle_idx = 0; particle_idx < Options.particle_count; ++particle_idx) {
+        const ParticleType& particle = particles[particle_idx];
+        NearestCentroid&    nearest_centroid
+            = buffers.particle_nearest_centroid[particle.cluster_metadata_idx];
+
+        if (!touched[nearest_centroid.idx]) continue;
+
+        nearest_centroid.distance = distance_2<Dimensions, Options>(
+            particle.position, clusters[nearest_centroid.idx].centroid.position
+        );
+    }
+}
+
 template <
     size_t                             Dimensions,
     nbs::ClusteredParticle<Dimensions> ParticleType,
@@ -8,18 +158,27 @@ void nbs::cluster::k_means(
     IN OUT CALLER_DELETE ParticleType* particles,
     IN OUT CALLER_DELETE Cluster<Dimensions, ParticleType>* initial_clusters,
     OUT CALLER_DELETE Cluster<Dimensions, ParticleType>* final_clusters,
-    IN OUT KMeansBuffers<Options> buffers
+    IN OUT KMeansBuffers<Options> buffers,
+    const bool*                   moved_particles /*= nullptr*/,
+    parallel::ThreadPool*         pool /*= nullptr*/
 ) {
+    static_assert(
+        Options.max_cluster_size == 0
+            || static_cast<size_t>(Options.max_cluster_size) * Options.cluster_count
+                   >= Options.particle_count,
+        "Capped clusters must have room for every particle."
+    );
+
     /************
        Set up particle nearest centroids if front loaded.
                                                 ************/
 
     if constexpr (Options.front_loaded) {
-        for (size_t particle_idx = 0; particle_idx < Options.particle_count;
-             ++particle_idx)
-        {
-            buffers.particle_nearest_centroid[particle_idx].idx = 0;
-        }
+        parallel::parallel_for(
+            pool, 0, Options.particle_count, Options.grain, [&](size_t particle_idx) {
+                buffers.particle_nearest_centroid[particle_idx].idx = 0;
+            }
+        );
     }
 
     /************
@@ -33,6 +192,14 @@ void nbs::cluster::k_means(
         final_clusters[cluster_idx].centroid = initial_clusters[cluster_idx].centroid;
     }
 
+    // Sums of the positions of the particles joining each cluster, kept wider than
+    // particle positions so that centroids of large clusters stay accurate.
+    static_assert(
+        Dimensions <= MAX_KMEANS_DIMENSIONS,
+        "K-means buffers hold centroid sums for at most three dimensions."
+    );
+    NBS_ACCUMULATION_PRECISION* centroid_sums = buffers.centroid_sums;
+
     /************
        Perform k-means algorithm.
                         ************/
@@ -43,20 +210,135 @@ void nbs::cluster::k_means(
         // Complete if max iterations has been reached.
         if (++iterations > Options.max_iterations) break;
 
-        // Each iteration starts at zero changes!
-        changes_in_iteration = 0;
         std::fill_n(
             buffers.cluster_modified_in_iteration, Options.cluster_count, false
         );
 
+        // Determine the nearest centroid to the given particle.
+        auto update_nearest_centroid = [&](ui32                     global_particle_idx,
+                                           detail::NearestCentroid& nearest_centroid) {
+            // If we're front loaded, that means we're starting from no known
+            // clusters so just set distance to minimum possible.
+            //     This will result in the right behaviour when we search for
+            //     the nearest centroid, with calculation performed the first
+            //     time over all centroids.
+            if constexpr (Options.front_loaded) {
+                if (iterations == 0) {
+                    nearest_centroid.distance
+                        = std::numeric_limits<NBS_PRECISION>::min();
+                }
+            }
+
+            //
+            // Calculate nearest centroid for the current particle, using subset of
+            // clusters if we can, and rebuilding that subset if we must.
+            //
+
+            if constexpr (Options.centroid_subset_optimisation) {
+                const ParticleType& particle = particles[global_particle_idx];
+
+                // Subsets are held per particle, so may be built on any thread.
+                detail::NearestCentroidList& cluster_subset
+                    = buffers.nearest_centroid_lists[particle.cluster_metadata_idx];
+
+                if constexpr (Options.centroid_subset.do_rebuild) {
+                    if (iterations == 0)
+                        detail::nearest_centroid<Dimensions, ParticleType, Options>(
+                            particle, nearest_centroid, initial_clusters
+                        );
+                    else if (iterations == 1) {
+                        detail::nearest_centroid_and_build_list<
+                            Dimensions,
+                            ParticleType,
+                            Options>(
+                            particle, nearest_centroid, initial_clusters, cluster_subset
+                        );
+                    } else {
+                        detail::nearest_centroid_from_subset<
+                            Dimensions,
+                            ParticleType,
+                            Options>(
+                            particle, nearest_centroid, initial_clusters, cluster_subset
+                        );
+                    }
+                } else {
+                    detail::nearest_centroid_from_subset<
+                        Dimensions,
+                        ParticleType,
+                        Options>(
+                        particle, nearest_centroid, initial_clusters, cluster_subset
+                    );
+                }
+            } else {
+                detail::nearest_centroid<Dimensions, ParticleType, Options>(
+                    particles[global_particle_idx],
+                    nearest_centroid,
+                    initial_clusters
+                );
+            }
+        };
+
         //
         // Iterate each particle of the population on which the clusters are being
-        // built. For each particle, determine which centroid it is nearest to and add
-        // its position to a new centroid which will then take its position as the
-        // average position of the associated particles.
+        // built, determining which centroid it is nearest to. Each initial cluster is
+        // handed out to the pool, and its particles within it, counting particles
+        // that change cluster.
+        //
+        auto assign_particle = [&](size_t global_particle_idx) -> ui32 {
+            detail::NearestCentroid& nearest_centroid
+                = buffers.particle_nearest_centroid[particles[global_particle_idx]
+                                                        .cluster_metadata_idx];
+            const ui32 initial_nearest_centroid_idx = nearest_centroid.idx;
+
+            // Particles that have not moved since they were last clustered keep
+            // their nearest centroid, which we only know if not front loaded.
+            bool reconsider_particle = true;
+            if constexpr (!Options.front_loaded) {
+                reconsider_particle
+                    = moved_particles == nullptr
+                      || moved_particles[particles[global_particle_idx]
+                                             .cluster_metadata_idx];
+            }
+
+            if (reconsider_particle) {
+                update_nearest_centroid(
+                    static_cast<ui32>(global_particle_idx), nearest_centroid
+                );
+            }
+
+            return initial_nearest_centroid_idx != nearest_centroid.idx ? 1 : 0;
+        };
+
+        auto assign_cluster = [&](size_t initial_cluster_idx) {
+            const Cluster<Dimensions, ParticleType>& initial_cluster
+                = initial_clusters[initial_cluster_idx];
+
+            return parallel::parallel_reduce(
+                pool,
+                initial_cluster.particle_offset,
+                initial_cluster.particle_offset + initial_cluster.particle_count,
+                Options.grain,
+                ui32{ 0 },
+                assign_particle,
+                std::plus<>{}
+            );
+        };
+
+        // Only look at first cluster in buffer if front loaded.
+        constexpr size_t assigned_cluster_count
+            = Options.front_loaded ? 1 : Options.cluster_count;
+
+        changes_in_iteration = parallel::parallel_reduce(
+            pool, 0, assigned_cluster_count, 1, ui32{ 0 }, assign_cluster, std::plus<>{}
+        );
+
         //
-        // Iterate each initial cluster and then iterate particles held by that cluster.
-        for (ui32 initial_cluster_idx = 0; initial_cluster_idx < Options.cluster_count;
+        // Add each particle's position to the new centroid of the cluster it is
+        // nearest, which will then take its position as the average position of the
+        // associated particles. Done serially, so the sums do not depend on how the
+        // particles were shared out above.
+        //
+        for (ui32 initial_cluster_idx = 0; initial_cluster_idx < assigned_cluster_count;
              ++initial_cluster_idx)
         {
             // Get handle on cluster we're looking at.
@@ -69,82 +351,31 @@ void nbs::cluster::k_means(
             {
                 ui32 global_particle_idx
                     = initial_cluster.particle_offset + in_cluster_particle_idx;
-                detail::NearestCentroid& nearest_centroid
+                const detail::NearestCentroid& nearest_centroid
                     = buffers.particle_nearest_centroid[particles[global_particle_idx]
                                                             .cluster_metadata_idx];
-                detail::NearestCentroid initial_nearest_centroid = nearest_centroid;
-
-                // If we're front loaded, that means we're starting from no known
-                // clusters so just set distance to minimum possible.
-                //     This will result in the right behaviour when we search for
-                //     the nearest centroid, with calculation performed the first
-                //     time over all centroids.
-                if constexpr (Options.front_loaded) {
-                    if (iterations == 0) {
-                        nearest_centroid.distance
-                            = std::numeric_limits<NBS_PRECISION>::min();
-                    }
-                }
 
-                //
-                // Calculate nearest centroid for the current particle, using subset of
-                // clusters if we can, and rebuilding that subset if we must.
-                //
-
-                if constexpr (Options.centroid_subset_optimisation) {
-                    if constexpr (Options.centroid_subset.do_rebuild) {
-                        if (iterations == 0)
-                            detail::nearest_centroid<Dimensions, ParticleType, Options>(
-                                particles[global_particle_idx],
-                                nearest_centroid,
-                                initial_clusters
-                            );
-                        else if (iterations == 1) {
-                            detail::nearest_centroid_and_build_list<
-                                Dimensions,
-                                ParticleType,
-                                Options>(
-                                particles[global_particle_idx],
-                                nearest_centroid,
-                                initial_clusters,
-                                buffers.nearest_centroids_lists[global_particle_idx]
-                            );
-                        } else {
-                            detail::nearest_centroid_from_subset<
-                                Dimensions,
-                                ParticleType,
-                                Options>(
-                                particles[global_particle_idx],
-                                nearest_centroid,
-                                initial_clusters,
-                                buffers.nearest_centroids_lists[global_particle_idx]
-                            );
-                        }
-                    } else {
-                        detail::nearest_centroid_from_subset<
-                            Dimensions,
-                            ParticleType,
-                            Options>(
-                            particles[global_particle_idx],
-                            nearest_centroid,
-                            initial_clusters,
-                            buffers.nearest_centroids_lists[global_particle_idx]
-                        );
-                    }
-                } else {
-                    detail::nearest_centroid<Dimensions, ParticleType, Options>(
-                        particles[global_particle_idx],
-                        nearest_centroid,
-                        initial_clusters
+                // In a periodic box, positions are summed as offsets from the centroid
+                // the particle was assigned to, so that clusters straddling the edges
+                // of the box average to where their particles are.
+                vec<Dimensions, NBS_PRECISION> position
+                    = particles[global_particle_idx].position;
+                if constexpr (Options.periodic) {
+                    position = spatial::nearest_image<Dimensions>(
+                        position
+                            - initial_clusters[nearest_centroid.idx].centroid.position,
+                        Options.box_size
                     );
                 }
 
+                NBS_ACCUMULATION_PRECISION* centroid_sum
+                    = centroid_sums + nearest_centroid.idx * Dimensions;
+
                 // If this is the first particle to join a cluster this round, then set
                 // values, otherwise add the new values in.
                 if (!buffers.cluster_modified_in_iteration[nearest_centroid.idx]) {
                     for (size_t dim = 0; dim < Dimensions; ++dim) {
-                        final_clusters[nearest_centroid.idx].centroid.position[dim]
-                            = particles[global_particle_idx].position[dim];
+                        centroid_sum[dim] = position[dim];
                     }
 
                     final_clusters[nearest_centroid.idx].particle_count = 1;
@@ -152,30 +383,40 @@ void nbs::cluster::k_means(
                     buffers.cluster_modified_in_iteration[nearest_centroid.idx] = true;
                 } else {
                     for (size_t dim = 0; dim < Dimensions; ++dim) {
-                        final_clusters[nearest_centroid.idx].centroid.position[dim]
-                            += particles[global_particle_idx].position[dim];
+                        centroid_sum[dim] += position[dim];
                     }
 
                     ++(final_clusters[nearest_centroid.idx].particle_count);
                 }
-
-                // If the particle has changed cluster, then update changes in
-                // iteration and its current cluster index.
-                if (initial_nearest_centroid.idx != nearest_centroid.idx) {
-                    ++changes_in_iteration;
-                }
             }
-
-            // Only look at first cluster in buffer if front loaded.
-            if constexpr (Options.front_loaded) break;
         }
 
         // Using total particles associated with each centroid, calculate the new
         // centroid for that group by taking the average of their positions.
+        // Clusters no particle joined keep their centroid, but are empty.
         for (ui32 cluster_idx = 0; cluster_idx < Options.cluster_count; ++cluster_idx) {
-            final_clusters[cluster_idx].centroid.position
-                /= static_cast<NBS_PRECISION>(final_clusters[cluster_idx].particle_count
-                );
+            if (!buffers.cluster_modified_in_iteration[cluster_idx]) {
+                final_clusters[cluster_idx].centroid
+                    = initial_clusters[cluster_idx].centroid;
+                final_clusters[cluster_idx].particle_count = 0;
+                continue;
+            }
+
+            const NBS_ACCUMULATION_PRECISION particle_count
+                = final_clusters[cluster_idx].particle_count;
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                final_clusters[cluster_idx].centroid.position[dim]
+                    = centroid_sums[cluster_idx * Dimensions + dim] / particle_count;
+            }
+
+            if constexpr (Options.periodic) {
+                final_clusters[cluster_idx].centroid.position
+                    = spatial::wrap_position<Dimensions>(
+                        initial_clusters[cluster_idx].centroid.position
+                            + final_clusters[cluster_idx].centroid.position,
+                        Options.box_size
+                    );
+            }
 
             initial_clusters[cluster_idx].centroid
                 = final_clusters[cluster_idx].centroid;
@@ -184,6 +425,12 @@ void nbs::cluster::k_means(
         debug_printf("Changes in iteration: %d\n", changes_in_iteration);
     } while (changes_in_iteration > Options.acceptable_changes_per_iteration);
 
+    if constexpr (Options.max_cluster_size > 0) {
+        detail::cap_cluster_sizes<Dimensions, ParticleType, Options>(
+            particles, final_clusters, buffers
+        );
+    }
+
     // Once we are done figuring how many particles are in each of the clusters, update
     // the final cluster particle offsets into the underlying particle array.
     size_t curr_offset = 0;
@@ -5,8 +5,19 @@
 
 #include "particle.hpp"
 
+#include "clustering/cluster.hpp"
+#include "clustering/nearest_centroid.hpp"
+#include "clustering/options.hpp"
+#include "parallel/scan.hpp"
+
 namespace nbs {
     namespace cluster {
+        /**
+         * \brief Chooses initial centroids by k-means++, each particle being chosen
+         * with probability proportional to its squared distance to the nearest
+         * centroid already chosen. Distances are found on the threads of pool if
+         * given, and choices depend only on seed, not the number of threads.
+         */
         template <
             size_t                        Dimensions,
             ClusteredParticle<Dimensions> ParticleType,
@@ -14,7 +25,8 @@ namespace nbs {
         void
         kpp(const ParticleType* particles,
             IN OUT Cluster<Dimensions, ParticleType>* clusters,
-            ui32*                                     seed = nullptr);
+            ui32*                                     seed = nullptr,
+            parallel::ThreadPool*                     pool = nullptr);
     }  // namespace cluster
 }  // namespace nbs
 
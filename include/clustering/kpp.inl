@@ -5,15 +5,22 @@ template <
 void nbs::cluster::kpp(
     const ParticleType* particles,
     IN OUT Cluster<Dimensions, ParticleType>* clusters,
-    ui32*                                     seed /*= nullptr*/
+    ui32*                                     seed /*= nullptr*/,
+    parallel::ThreadPool*                     pool /*= nullptr*/
 ) {
     /************
        Set up metadata for k++ algorithm.
                                 ************/
 
-    bool* particle_chosen_as_centroid = new bool[Options.particle_count]{};
+    // Squared distance of each particle to its nearest chosen centroid, zero for
+    // particles chosen as centroids, and the running sum of those distances.
+    NBS_PRECISION* minimum_distance_2s    = new NBS_PRECISION[Options.particle_count];
+    NBS_PRECISION* cumulative_distance_2s = new NBS_PRECISION[Options.particle_count];
 
-    NBS_PRECISION* cumulative_distance_2s = new NBS_PRECISION[Options.particle_count]{};
+    // Block totals of the running sum, for scanning without allocating.
+    NBS_PRECISION* scan_scratch = new NBS_PRECISION[parallel::scan_block_count(
+        Options.particle_count, Options.grain
+    )];
 
     ui32 _seed;
     if (seed) {
@@ -29,6 +36,13 @@ void nbs::cluster::kpp(
 
     std::default_random_engine generator(_seed);
 
+    parallel::parallel_for(
+        pool, 0, Options.particle_count, Options.grain, [&](size_t particle_idx) {
+            minimum_distance_2s[particle_idx]
+                = std::numeric_limits<NBS_PRECISION>::max();
+        }
+    );
+
     /************
        Make initial choice of a centroid.
                                 ************/
@@ -37,8 +51,7 @@ void nbs::cluster::kpp(
         std::uniform_int_distribution<ui32> distribution(0, Options.particle_count - 1);
         ui32                                initial_choice = distribution(generator);
 
-        clusters[0].centroid                        = particles[initial_choice];
-        particle_chosen_as_centroid[initial_choice] = true;
+        clusters[0].centroid = particles[initial_choice];
     }
 
     /************
@@ -46,60 +59,40 @@ void nbs::cluster::kpp(
                                                  ************/
 
     for (ui32 cluster_idx = 1; cluster_idx < Options.cluster_count; ++cluster_idx) {
-        NBS_PRECISION total_distance_2 = 0.0;
-
         //
-        // For each particle of the dataset not so far chosen as a centroid, determine
-        // the minimum distance to a chosen centroid and select one of those particles
-        // to be the next centroid with probability proportional to distance^2 from
-        // nearest centroid.
+        // For each particle of the dataset, determine the minimum distance to a chosen
+        // centroid and select one of the particles to be the next centroid with
+        // probability proportional to distance^2 from nearest centroid. Only the last
+        // chosen centroid can have come nearer since the last choice.
         //
 
-        // Calculate distances for each particle not so far chosen as a centroid.
-        for (ui32 particle_idx = 0; particle_idx < Options.particle_count;
-             ++particle_idx)
-        {
-            // Skip particles already chosen as a centroid.
-            if (particle_chosen_as_centroid[particle_idx]) {
-                if (particle_idx == 0) {
-                    cumulative_distance_2s[0] = 0.0;
-                } else {
-                    cumulative_distance_2s[particle_idx]
-                        = cumulative_distance_2s[particle_idx - 1];
-                }
-                continue;
-            }
+        const vec<Dimensions, NBS_PRECISION>& last_chosen_centroid
+            = clusters[cluster_idx - 1].centroid.position;
 
-            // Calculate distance to nearest chosen centroid.
-            NBS_PRECISION minimum_distance_2_to_chosen_centroids
-                = std::numeric_limits<NBS_PRECISION>::max();
-            for (ui32 chosen_cluster_idx = 0; chosen_cluster_idx < cluster_idx;
-                 ++chosen_cluster_idx)
-            {
-                NBS_PRECISION distance_2_to_chosen_centroid = math::distance2(
-                    particles[particle_idx].position,
-                    clusters[chosen_cluster_idx].centroid.position
+        parallel::parallel_for(
+            pool, 0, Options.particle_count, Options.grain, [&](size_t particle_idx) {
+                minimum_distance_2s[particle_idx] = std::min(
+                    minimum_distance_2s[particle_idx],
+                    detail::distance_2<Dimensions, Options>(
+                        particles[particle_idx].position, last_chosen_centroid
+                    )
                 );
-
-                if (distance_2_to_chosen_centroid
-                    < minimum_distance_2_to_chosen_centroids)
-                {
-                    minimum_distance_2_to_chosen_centroids
-                        = distance_2_to_chosen_centroid;
-                }
             }
+        );
 
-            // Place the calculated distance into metadata.
-            if (particle_idx == 0) {
-                cumulative_distance_2s[particle_idx]
-                    = minimum_distance_2_to_chosen_centroids;
-            } else {
-                cumulative_distance_2s[particle_idx]
-                    = cumulative_distance_2s[particle_idx - 1]
-                      + minimum_distance_2_to_chosen_centroids;
-            }
-            total_distance_2 += minimum_distance_2_to_chosen_centroids;
-        }
+        parallel::parallel_inclusive_scan(
+            pool,
+            minimum_distance_2s,
+            cumulative_distance_2s,
+            Options.particle_count,
+            Options.grain,
+            NBS_PRECISION{ 0 },
+            std::plus<>{},
+            scan_scratch
+        );
+
+        const NBS_PRECISION total_distance_2
+            = cumulative_distance_2s[Options.particle_count - 1];
 
         // Select a particle to be next chosen centroid with probability proportional to
         // distance^2 to nearest existing centroid.
@@ -108,21 +101,24 @@ void nbs::cluster::kpp(
         );
         NBS_PRECISION choice = distribution(generator);
 
-        for (ui32 particle_idx = 0; particle_idx < Options.particle_count;
-             ++particle_idx)
-        {
-            if (cumulative_distance_2s[particle_idx] > choice) {
-                clusters[cluster_idx].centroid            = particles[particle_idx];
-                particle_chosen_as_centroid[particle_idx] = true;
-                break;
-            }
-        }
+        // The first particle whose running sum passes the choice.
+        const NBS_PRECISION* chosen = std::upper_bound(
+            cumulative_distance_2s,
+            cumulative_distance_2s + Options.particle_count,
+            choice
+        );
+        const size_t chosen_particle_idx = std::min<size_t>(
+            chosen - cumulative_distance_2s, Options.particle_count - 1
+        );
+
+        clusters[cluster_idx].centroid = particles[chosen_particle_idx];
     }
 
     /************
        Clean-up.
        ************/
 
-    delete[] particle_chosen_as_centroid;
+    delete[] minimum_distance_2s;
     delete[] cumulative_distance_2s;
+    delete[] scan_scratch;
 }
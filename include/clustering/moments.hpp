@@ -0,0 +1,45 @@
+#ifndef N_BODY_SIM_CLUSTERING_MOMENTS_HPP
+#define N_BODY_SIM_CLUSTERING_MOMENTS_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "clustering/cluster.hpp"
+#include "spatial/periodic.hpp"
+
+namespace nbs {
+    namespace cluster {
+        template <size_t Dimensions>
+        struct ClusterMoments {
+            NBS_PRECISION                  mass;
+            vec<Dimensions, NBS_PRECISION> centre;
+            // Traceless quadrupole, sum of m (3 d d^T - |d|^2 I) about centre.
+            mat<Dimensions, Dimensions, NBS_PRECISION> quadrupole;
+            // Distance from centre to the furthest particle of the cluster.
+            NBS_PRECISION radius;
+        };
+
+        /**
+         * \brief Calculates the mass, mass-weighted centre, quadrupole and radius of
+         * each cluster from the particles it currently holds.
+         *
+         * If box_size is non-zero, space wraps with that period on every axis and
+         * particles are taken at their nearest image to the cluster's centroid, so
+         * clusters straddling the edges of the box keep their shape. Centres are then
+         * wrapped into [0, box_size)^D.
+         */
+        template <size_t Dimensions, ClusteredParticle<Dimensions> ParticleType>
+        void calculate_cluster_moments(
+            const ParticleType*                      particles,
+            const Cluster<Dimensions, ParticleType>* clusters,
+            size_t                                   cluster_count,
+            OUT ClusterMoments<Dimensions>*          moments,
+            NBS_PRECISION                            box_size = 0
+        );
+    }  // namespace cluster
+}  // namespace nbs
+
+#include "moments.inl"
+
+#endif  // N_BODY_SIM_CLUSTERING_MOMENTS_HPP
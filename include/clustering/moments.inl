@@ -0,0 +1,69 @@
+template <size_t Dimensions, nbs::ClusteredParticle<Dimensions> ParticleType>
+void nbs::cluster::calculate_cluster_moments(
+    const ParticleType*                      particles,
+    const Cluster<Dimensions, ParticleType>* clusters,
+    size_t                                   cluster_count,
+    OUT ClusterMoments<Dimensions>*          moments,
+    NBS_PRECISION                            box_size /*= 0*/
+) {
+    // Position of a particle relative to reference, to its nearest image if periodic.
+    auto offset_from = [box_size](
+                           const vec<Dimensions, NBS_PRECISION>& position,
+                           const vec<Dimensions, NBS_PRECISION>& reference
+                       ) {
+        if (box_size > 0) {
+            return spatial::nearest_image<Dimensions>(position - reference, box_size);
+        }
+        return position - reference;
+    };
+
+    for (size_t cluster_idx = 0; cluster_idx < cluster_count; ++cluster_idx) {
+        const auto&                 cluster        = clusters[cluster_idx];
+        ClusterMoments<Dimensions>& cluster_moment = moments[cluster_idx];
+
+        cluster_moment.mass       = 0;
+        cluster_moment.centre     = {};
+        cluster_moment.quadrupole = {};
+        cluster_moment.radius     = 0;
+
+        if (cluster.particle_count == 0) continue;
+
+        // Mass-weighted centre, summed as offsets from the centroid if periodic.
+        const vec<Dimensions, NBS_PRECISION> centroid
+            = box_size > 0 ? cluster.centroid.position
+                           : vec<Dimensions, NBS_PRECISION>{};
+        for (size_t offset = 0; offset < cluster.particle_count; ++offset) {
+            const auto& particle = particles[cluster.particle_offset + offset];
+
+            const NBS_PRECISION mass  = mass_of(particle);
+            cluster_moment.mass      += mass;
+            cluster_moment.centre    += offset_from(particle.position, centroid) * mass;
+        }
+        cluster_moment.centre = centroid + cluster_moment.centre / cluster_moment.mass;
+        if (box_size > 0) {
+            cluster_moment.centre
+                = spatial::wrap_position<Dimensions>(cluster_moment.centre, box_size);
+        }
+
+        // Quadrupole and radius about that centre.
+        NBS_PRECISION radius_2 = 0;
+        for (size_t offset = 0; offset < cluster.particle_count; ++offset) {
+            const auto& particle = particles[cluster.particle_offset + offset];
+
+            const NBS_PRECISION                  mass = mass_of(particle);
+            const vec<Dimensions, NBS_PRECISION> d
+                = offset_from(particle.position, cluster_moment.centre);
+            const NBS_PRECISION d_2 = math::dot(d, d);
+
+            for (size_t col = 0; col < Dimensions; ++col) {
+                for (size_t row = 0; row < Dimensions; ++row) {
+                    cluster_moment.quadrupole[col][row]
+                        += mass * (3 * d[col] * d[row] - (col == row ? d_2 : 0));
+                }
+            }
+
+            radius_2 = std::max(radius_2, d_2);
+        }
+        cluster_moment.radius = math::sqrt(radius_2);
+    }
+}
@@ -8,10 +8,21 @@
 #include "clustering/buffers.hpp"
 #include "clustering/cluster.hpp"
 #include "clustering/options.hpp"
+#include "spatial/periodic.hpp"
 
 namespace nbs {
     namespace cluster {
         namespace detail {
+            /**
+             * \brief Squared distance between two positions, between nearest images
+             * if clustering is periodic.
+             */
+            template <size_t Dimensions, KMeansOptions Options>
+            NBS_PRECISION distance_2(
+                const vec<Dimensions, NBS_PRECISION>& a,
+                const vec<Dimensions, NBS_PRECISION>& b
+            );
+
             template <
                 size_t                        Dimensions,
                 ClusteredParticle<Dimensions> ParticleType,
@@ -40,8 +51,7 @@ namespace nbs {
                 const ParticleType&                      particle,
                 OUT NearestCentroid&                     nearest_centroid,
                 const Cluster<Dimensions, ParticleType>* clusters,
-                OUT NearestCentroidList&                 cluster_subset,
-                KMeansBuffers<Options>                   buffers
+                OUT NearestCentroidList&                 cluster_subset
             );
         };  // namespace detail
     }       // namespace cluster
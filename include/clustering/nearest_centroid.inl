@@ -1,3 +1,17 @@
+template <size_t Dimensions, nbs::cluster::KMeansOptions Options>
+NBS_PRECISION nbs::cluster::detail::distance_2(
+    const vec<Dimensions, NBS_PRECISION>& a, const vec<Dimensions, NBS_PRECISION>& b
+) {
+    if constexpr (Options.periodic) {
+        const vec<Dimensions, NBS_PRECISION> displacement
+            = spatial::nearest_image<Dimensions>(b - a, Options.box_size);
+
+        return math::dot(displacement, displacement);
+    } else {
+        return math::distance2(a, b);
+    }
+}
+
 template <
     size_t                             Dimensions,
     nbs::ClusteredParticle<Dimensions> ParticleType,
@@ -7,7 +21,7 @@ void nbs::cluster::detail::nearest_centroid(
     IN OUT NearestCentroid&                  nearest_centroid,
     const Cluster<Dimensions, ParticleType>* clusters
 ) {
-    NBS_PRECISION new_distance_2_to_current_cluster = math::distance2(
+    NBS_PRECISION new_distance_2_to_current_cluster = distance_2<Dimensions, Options>(
         particle.position, clusters[nearest_centroid.idx].centroid.position
     );
 
@@ -29,7 +43,7 @@ void nbs::cluster::detail::nearest_centroid(
     for (ui32 cluster_idx = 0; cluster_idx < Options.cluster_count; ++cluster_idx) {
         if (cluster_idx == nearest_centroid.idx) continue;
 
-        NBS_PRECISION centroid_distance_2 = math::distance2(
+        NBS_PRECISION centroid_distance_2 = distance_2<Dimensions, Options>(
             particle.position, clusters[cluster_idx].centroid.position
         );
 
@@ -50,7 +64,7 @@ void nbs::cluster::detail::nearest_centroid_from_subset(
     const Cluster<Dimensions, ParticleType>* clusters,
     detail::NearestCentroidList              cluster_subset
 ) {
-    NBS_PRECISION new_distance_2_to_current_cluster = math::distance2(
+    NBS_PRECISION new_distance_2_to_current_cluster = distance_2<Dimensions, Options>(
         particle.position, clusters[nearest_centroid.idx].centroid.position
     );
 
@@ -77,7 +91,7 @@ void nbs::cluster::detail::nearest_centroid_from_subset(
 
         if (cluster_idx == nearest_centroid.idx) continue;
 
-        NBS_PRECISION centroid_distance_2 = math::distance2(
+        NBS_PRECISION centroid_distance_2 = distance_2<Dimensions, Options>(
             particle.position, clusters[cluster_idx].centroid.position
         );
 
@@ -96,34 +110,34 @@ void nbs::cluster::detail::nearest_centroid_and_build_list(
     const ParticleType&                      particle,
     OUT NearestCentroid&                     nearest_centroid,
     const Cluster<Dimensions, ParticleType>* clusters,
-    OUT detail::NearestCentroidList& cluster_subset,
-    KMeansBuffers<Options>           buffers
+    OUT detail::NearestCentroidList& cluster_subset
 ) {
     // Optimisation by making a subset of centroids to consider for a given particle.
     //     This is based on the paper "Faster k-means Cluster Estimation" by Khandelwal
     //     S., Awekar A.
 
-    // Place indices in order.
-    for (ui32 i = 0; i < Options.cluster_count; ++i)
-        buffers.nearest_centroid_indices[i] = i;
+    // Place indices in order, on the stack so that particles may be handled on any
+    // number of threads at once.
+    std::array<ui32, Options.cluster_count> centroid_indices;
+    for (ui32 i = 0; i < Options.cluster_count; ++i) centroid_indices[i] = i;
 
     // Transformer from index to distance to particle building the cluster subset for.
     auto index_to_distance = [&particle, &clusters](ui32 idx) {
-        return math::distance2(particle.position, clusters[idx].centroid.position);
+        return distance_2<Dimensions, Options>(
+            particle.position, clusters[idx].centroid.position
+        );
     };
 
     // Sort indices according to distance to particle.
-    std::ranges::sort(
-        buffers.nearest_centroid_indices, std::less<>{}, index_to_distance
-    );
+    std::ranges::sort(centroid_indices, std::less<>{}, index_to_distance);
 
     // Set cluster subset.
     for (ui32 idx = 0; idx < Options.centroid_subset.k_prime; ++idx) {
-        cluster_subset.indices[idx] = buffers.nearest_centroid_indices[idx];
+        cluster_subset.indices[idx] = centroid_indices[idx];
     }
 
-    nearest_centroid.idx      = buffers.nearest_centroid_indices[0];
-    nearest_centroid.distance = math::distance2(
-        particle, clusters[buffers.nearest_centroid_indices[0]].centroid.position
+    nearest_centroid.idx      = centroid_indices[0];
+    nearest_centroid.distance = distance_2<Dimensions, Options>(
+        particle.position, clusters[centroid_indices[0]].centroid.position
     );
 }
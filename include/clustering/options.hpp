@@ -14,11 +14,40 @@ namespace nbs {
             bool approaching_centroid_optimisation = true;
             bool centroid_subset_optimisation      = false;
 
+            // Whether space wraps with period box_size on every axis, distances are
+            // then to nearest images and centroids are kept in [0, box_size)^D.
+            bool          periodic = false;
+            NBS_PRECISION box_size = 1;
+
+            // Number of particles handed to a thread at a time.
+            ui32 grain = 1024;
+
+            // If not zero, once converged the particles furthest from the centroid of
+            // any cluster larger than this are moved to the nearest centroid with
+            // room, bounding the cost of direct sums within clusters. Must leave room
+            // for every particle.
+            ui32 max_cluster_size = 0;
+
             struct {
                 ui32 k_prime    = 30;
                 bool do_rebuild = true;
             } centroid_subset = {};
         };
+
+        struct ReclusterOptions {
+            // Options of the warm-started k-means reclustering, which must not be
+            // front loaded.
+            KMeansOptions k_means = {};
+            // Recluster once the RMS displacement of any cluster's particles since
+            // they were last clustered passes this fraction of the cluster's spread,
+            // its RMS radius, at that time.
+            NBS_PRECISION drift_threshold = 0.25;
+            // Or once the spread of any cluster has grown by this fraction.
+            NBS_PRECISION spread_growth_threshold = 0.25;
+            // Only particles displaced by more than this fraction of their cluster's
+            // spread are reconsidered when reclustering.
+            NBS_PRECISION move_threshold = 0.05;
+        };
     }  // namespace cluster
 }  // namespace nbs
 
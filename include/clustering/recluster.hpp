@@ -0,0 +1,137 @@
+#ifndef N_BODY_SIM_CLUSTERING_RECLUSTER_HPP
+#define N_BODY_SIM_CLUSTERING_RECLUSTER_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "clustering/buffers.hpp"
+#include "clustering/cluster.hpp"
+#include "clustering/k_means.hpp"
+#include "clustering/options.hpp"
+#include "parallel/thread_pool.hpp"
+#include "spatial/periodic.hpp"
+
+namespace nbs {
+    namespace cluster {
+        namespace detail {
+            /**
+             * \brief Offset of position from origin, to its nearest image if
+             * clustering is periodic.
+             */
+            template <size_t Dimensions, KMeansOptions Options>
+            vec<Dimensions, NBS_PRECISION> offset(
+                const vec<Dimensions, NBS_PRECISION>& origin,
+                const vec<Dimensions, NBS_PRECISION>& position
+            );
+        }  // namespace detail
+
+        struct ReclusterCounters {
+            // Times drift has been measured.
+            size_t checks;
+            // Times drift was past a threshold and particles were reclustered.
+            size_t reclusters;
+            // Particles reconsidered over all reclusters.
+            size_t particles_reconsidered;
+            // Largest RMS displacement and spread growth of any cluster at the last
+            // check, as fractions of the cluster's spread when last clustered.
+            NBS_PRECISION last_drift;
+            NBS_PRECISION last_spread_growth;
+        };
+
+        /**
+         * \brief State for reclustering particles only once their clusters have
+         * drifted. Per-particle state is indexed by cluster_metadata_idx so that it
+         * survives the re-sorting of particles.
+         */
+        template <size_t Dimensions, ReclusterOptions Options>
+        struct ReclusterBuffers {
+            KMeansBuffers<Options.k_means> k_means;
+            // Position of each particle when last clustered.
+            vec<Dimensions, NBS_PRECISION>* reference_positions;
+            // Spread of each cluster when last clustered.
+            NBS_PRECISION* reference_spreads;
+            // RMS displacement and growth in spread of each cluster at the last check,
+            // as fractions of its reference spread.
+            NBS_PRECISION* drifts;
+            NBS_PRECISION* spread_growths;
+            // Particles displaced beyond the move threshold at the last check.
+            bool*             moved;
+            ReclusterCounters counters;
+        };
+
+        template <size_t Dimensions, ReclusterOptions Options>
+        void allocate_recluster_buffers(
+            OUT CALLER_DELETE ReclusterBuffers<Dimensions, Options>& buffers
+        );
+
+        template <size_t Dimensions, ReclusterOptions Options>
+        void deallocate_recluster_buffers(
+            OUT CALLER_DELETE ReclusterBuffers<Dimensions, Options>& buffers
+        );
+
+        /**
+         * \brief Takes clusters as freshly clustered, recording the particle
+         * positions and cluster spreads that drift is measured from, and each
+         * particle's cluster as its nearest centroid for warm-starting k-means.
+         * Particles must be sorted by cluster.
+         */
+        template <
+            size_t                        Dimensions,
+            ClusteredParticle<Dimensions> ParticleType,
+            ReclusterOptions              Options>
+        void reset_drift_reference(
+            const ParticleType*                          particles,
+            const Cluster<Dimensions, ParticleType>*     clusters,
+            OUT ReclusterBuffers<Dimensions, Options>& buffers,
+            parallel::ThreadPool*                        pool = nullptr
+        );
+
+        /**
+         * \brief Measures how far each cluster has drifted since the drift reference
+         * was last reset, flagging the particles that have moved.
+         *
+         * \return Whether the drift or spread growth of any cluster has passed its
+         * threshold.
+         */
+        template <
+            size_t                        Dimensions,
+            ClusteredParticle<Dimensions> ParticleType,
+            ReclusterOptions              Options>
+        bool has_drifted(
+            const ParticleType*                           particles,
+            const Cluster<Dimensions, ParticleType>*      clusters,
+            IN OUT ReclusterBuffers<Dimensions, Options>& buffers,
+            parallel::ThreadPool*                         pool = nullptr
+        );
+
+        /**
+         * \brief Reclusters particles by k-means, warm-started from clusters and
+         * reconsidering only particles that have moved, if they have drifted past a
+         * threshold, then resets the drift reference. Cheap enough to call every
+         * step, so that clusters stay fit for force calculation without paying for
+         * k-means while they are.
+         *
+         * \param clusters The current clusters, updated if reclustered.
+         * \param scratch_clusters Space for as many clusters, for k-means to build
+         * the new clusters in.
+         * \return Whether particles were reclustered, in which case they have been
+         * re-sorted by cluster.
+         */
+        template <
+            size_t                        Dimensions,
+            ClusteredParticle<Dimensions> ParticleType,
+            ReclusterOptions              Options>
+        bool recluster_if_drifted(
+            IN OUT ParticleType*                          particles,
+            IN OUT Cluster<Dimensions, ParticleType>*     clusters,
+            OUT Cluster<Dimensions, ParticleType>*        scratch_clusters,
+            IN OUT ReclusterBuffers<Dimensions, Options>& buffers,
+            parallel::ThreadPool*                         pool = nullptr
+        );
+    }  // namespace cluster
+}  // namespace nbs
+
+#include "recluster.inl"
+
+#endif  // N_BODY_SIM_CLUSTERING_RECLUSTER_HPP
@@ -0,0 +1,228 @@
+template <size_t Dimensions, nbs::cluster::KMeansOptions Options>
+nbs::vec<Dimensions, NBS_PRECISION> nbs::cluster::detail::offset(
+    const vec<Dimensions, NBS_PRECISION>& origin,
+    const vec<Dimensions, NBS_PRECISION>& position
+) {
+    if constexpr (Options.periodic) {
+        return spatial::nearest_image<Dimensions>(position - origin, Options.box_size);
+    } else {
+        return position - origin;
+    }
+}
+
+template <size_t Dimensions, nbs::cluster::ReclusterOptions Options>
+void nbs::cluster::allocate_recluster_buffers(
+    OUT CALLER_DELETE ReclusterBuffers<Dimensions, Options>& buffers
+) {
+    allocate_kmeans_buffers<Options.k_means>(buffers.k_means);
+
+    buffers.reference_positions
+        = new vec<Dimensions, NBS_PRECISION>[Options.k_means.particle_count];
+    buffers.reference_spreads = new NBS_PRECISION[Options.k_means.cluster_count];
+    buffers.drifts            = new NBS_PRECISION[Options.k_means.cluster_count];
+    buffers.spread_growths    = new NBS_PRECISION[Options.k_means.cluster_count];
+    buffers.moved             = new bool[Options.k_means.particle_count]{};
+
+    buffers.counters = {};
+}
+
+template <size_t Dimensions, nbs::cluster::ReclusterOptions Options>
+void nbs::cluster::deallocate_recluster_buffers(
+    OUT CALLER_DELETE ReclusterBuffers<Dimensions, Options>& buffers
+) {
+    deallocate_kmeans_buffers<Options.k_means>(buffers.k_means);
+
+    delete[] buffers.reference_positions;
+    delete[] buffers.reference_spreads;
+    delete[] buffers.drifts;
+    delete[] buffers.spread_growths;
+    delete[] buffers.moved;
+}
+
+template <
+    size_t                             Dimensions,
+    nbs::ClusteredParticle<Dimensions> ParticleType,
+    nbs::cluster::ReclusterOptions     Options>
+void nbs::cluster::reset_drift_reference(
+    const ParticleType*                        particles,
+    const Cluster<Dimensions, ParticleType>*   clusters,
+    OUT ReclusterBuffers<Dimensions, Options>& buffers,
+    parallel::ThreadPool*                      pool /*= nullptr*/
+) {
+    auto reset_cluster = [&](size_t cluster_idx) {
+        const auto& cluster = clusters[cluster_idx];
+
+        vec<Dimensions, NBS_PRECISION> offset_sum{};
+        NBS_PRECISION                  offset_2_sum = 0;
+
+        for (size_t offset = 0; offset < cluster.particle_count; ++offset) {
+            const ParticleType& particle = particles[cluster.particle_offset + offset];
+
+            const vec<Dimensions, NBS_PRECISION> to_particle
+                = detail::offset<Dimensions, Options.k_means>(
+                    cluster.centroid.position, particle.position
+                );
+            const NBS_PRECISION distance_2 = math::dot(to_particle, to_particle);
+
+            offset_sum   += to_particle;
+            offset_2_sum += distance_2;
+
+            buffers.reference_positions[particle.cluster_metadata_idx]
+                = particle.position;
+            buffers.moved[particle.cluster_metadata_idx] = false;
+
+            // Particles are sorted by the cluster k-means last placed them in, which
+            // is where a warm start must begin them.
+            buffers.k_means.particle_nearest_centroid[particle.cluster_metadata_idx]
+                = { static_cast<ui32>(cluster_idx), distance_2 };
+        }
+
+        buffers.drifts[cluster_idx]         = 0;
+        buffers.spread_growths[cluster_idx] = 0;
+
+        if (cluster.particle_count == 0) {
+            buffers.reference_spreads[cluster_idx] = 0;
+            return;
+        }
+
+        const NBS_PRECISION inv_count
+            = NBS_PRECISION{ 1 } / static_cast<NBS_PRECISION>(cluster.particle_count);
+        const vec<Dimensions, NBS_PRECISION> mean_offset = offset_sum * inv_count;
+
+        buffers.reference_spreads[cluster_idx] = std::sqrt(std::max(
+            offset_2_sum * inv_count - math::dot(mean_offset, mean_offset),
+            NBS_PRECISION{ 0 }
+        ));
+    };
+
+    parallel::parallel_for(pool, 0, Options.k_means.cluster_count, 1, reset_cluster);
+}
+
+template <
+    size_t                             Dimensions,
+    nbs::ClusteredParticle<Dimensions> ParticleType,
+    nbs::cluster::ReclusterOptions     Options>
+bool nbs::cluster::has_drifted(
+    const ParticleType*                           particles,
+    const Cluster<Dimensions, ParticleType>*      clusters,
+    IN OUT ReclusterBuffers<Dimensions, Options>& buffers,
+    parallel::ThreadPool*                         pool /*= nullptr*/
+) {
+    auto measure_cluster = [&](size_t cluster_idx) {
+        const auto& cluster = clusters[cluster_idx];
+
+        const NBS_PRECISION reference_spread = buffers.reference_spreads[cluster_idx];
+
+        // A cluster of one particle, or of coincident particles, has no spread to
+        // measure drift against, nor movement, so its particles are all reconsidered
+        // when reclustering.
+        if (reference_spread <= 0) {
+            for (size_t offset = 0; offset < cluster.particle_count; ++offset) {
+                buffers.moved[particles[cluster.particle_offset + offset]
+                                  .cluster_metadata_idx]
+                    = true;
+            }
+
+            buffers.drifts[cluster_idx]         = 0;
+            buffers.spread_growths[cluster_idx] = 0;
+            return;
+        }
+
+        const NBS_PRECISION move_distance = Options.move_threshold * reference_spread;
+        const NBS_PRECISION move_distance_2 = move_distance * move_distance;
+
+        vec<Dimensions, NBS_PRECISION> offset_sum{};
+        NBS_PRECISION                  offset_2_sum       = 0;
+        NBS_PRECISION                  displacement_2_sum = 0;
+
+        for (size_t offset = 0; offset < cluster.particle_count; ++offset) {
+            const ParticleType& particle = particles[cluster.particle_offset + offset];
+
+            const vec<Dimensions, NBS_PRECISION> displacement
+                = detail::offset<Dimensions, Options.k_means>(
+                    buffers.reference_positions[particle.cluster_metadata_idx],
+                    particle.position
+                );
+            const NBS_PRECISION displacement_2 = math::dot(displacement, displacement);
+
+            const vec<Dimensions, NBS_PRECISION> to_particle
+                = detail::offset<Dimensions, Options.k_means>(
+                    cluster.centroid.position, particle.position
+                );
+
+            offset_sum         += to_particle;
+            offset_2_sum       += math::dot(to_particle, to_particle);
+            displacement_2_sum += displacement_2;
+
+            buffers.moved[particle.cluster_metadata_idx]
+                = displacement_2 > move_distance_2;
+        }
+
+        const NBS_PRECISION inv_count
+            = NBS_PRECISION{ 1 } / static_cast<NBS_PRECISION>(cluster.particle_count);
+        const vec<Dimensions, NBS_PRECISION> mean_offset = offset_sum * inv_count;
+
+        const NBS_PRECISION spread = std::sqrt(std::max(
+            offset_2_sum * inv_count - math::dot(mean_offset, mean_offset),
+            NBS_PRECISION{ 0 }
+        ));
+
+        buffers.drifts[cluster_idx]
+            = std::sqrt(displacement_2_sum * inv_count) / reference_spread;
+        buffers.spread_growths[cluster_idx] = spread / reference_spread - 1;
+    };
+
+    parallel::parallel_for(pool, 0, Options.k_means.cluster_count, 1, measure_cluster);
+
+    buffers.counters.last_drift = *std::max_element(
+        buffers.drifts, buffers.drifts + Options.k_means.cluster_count
+    );
+    buffers.counters.last_spread_growth = *std::max_element(
+        buffers.spread_growths, buffers.spread_growths + Options.k_means.cluster_count
+    );
+    ++buffers.counters.checks;
+
+    return buffers.counters.last_drift > Options.drift_threshold
+           || buffers.counters.last_spread_growth > Options.spread_growth_threshold;
+}
+
+template <
+    size_t                             Dimensions,
+    nbs::ClusteredParticle<Dimensions> ParticleType,
+    nbs::cluster::ReclusterOptions     Options>
+bool nbs::cluster::recluster_if_drifted(
+    IN OUT ParticleType*                          particles,
+    IN OUT Cluster<Dimensions, ParticleType>*     clusters,
+    OUT Cluster<Dimensions, ParticleType>*        scratch_clusters,
+    IN OUT ReclusterBuffers<Dimensions, Options>& buffers,
+    parallel::ThreadPool*                         pool /*= nullptr*/
+) {
+    static_assert(
+        !Options.k_means.front_loaded,
+        "Reclustering warm starts k-means from the current clusters, so must not be "
+        "front loaded."
+    );
+
+    const bool drifted = has_drifted<Dimensions, ParticleType, Options>(
+        particles, clusters, buffers, pool
+    );
+
+    if (!drifted) return false;
+
+    buffers.counters.particles_reconsidered += static_cast<size_t>(std::count(
+        buffers.moved, buffers.moved + Options.k_means.particle_count, true
+    ));
+    ++buffers.counters.reclusters;
+
+    k_means<Dimensions, ParticleType, Options.k_means>(
+        particles, clusters, scratch_clusters, buffers.k_means, buffers.moved, pool
+    );
+
+    std::copy_n(scratch_clusters, Options.k_means.cluster_count, clusters);
+
+    reset_drift_reference<Dimensions, ParticleType, Options>(
+        particles, clusters, buffers, pool
+    );
+
+    return true;
+}
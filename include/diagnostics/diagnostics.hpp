@@ -0,0 +1,136 @@
+#ifndef N_BODY_SIM_DIAGNOSTICS_DIAGNOSTICS_HPP
+#define N_BODY_SIM_DIAGNOSTICS_DIAGNOSTICS_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "parallel/reduce.hpp"
+
+namespace nbs {
+    namespace diagnostics {
+        /**
+         * \brief Energy, momentum and virial of a system at one step.
+         */
+        template <size_t Dimensions>
+        struct Diagnostics {
+            NBS_PRECISION kinetic_energy;
+            // Half the sum of particle potentials, as each pair is in both of its
+            // particles' potentials. Zero if particles have no potential member.
+            NBS_PRECISION                  potential_energy;
+            vec<Dimensions, NBS_PRECISION> momentum;
+            // Sum of position . force, equal to the potential energy under gravity
+            // alone. Not meaningful in a periodic box.
+            NBS_PRECISION virial;
+        };
+
+        template <size_t Dimensions>
+        NBS_PRECISION total_energy(const Diagnostics<Dimensions>& diagnostics);
+
+        /**
+         * \brief 2 K / -W, which is one for a system in virial equilibrium.
+         */
+        template <size_t Dimensions>
+        NBS_PRECISION virial_ratio(const Diagnostics<Dimensions>& diagnostics);
+
+        // Consecutive particles whose diagnostics are summed together by an
+        // accumulator.
+        constexpr size_t DIAGNOSTICS_BLOCK_SIZE = 512;
+
+        /**
+         * \brief Sums of diagnostics over each block of particles, so that they can
+         * be accumulated by a parallel pass over particles that is being made anyway,
+         * such as the last kick of a step, without synchronisation. Each block is
+         * summed in particle order and blocks are combined in a fixed tree, so the
+         * diagnostics do not depend on the number of threads.
+         */
+        template <size_t Dimensions>
+        struct DiagnosticsAccumulator {
+            Diagnostics<Dimensions>* block_sums;
+            // Block sums are combined in here, leaving them to be reduced again.
+            Diagnostics<Dimensions>* reduce_scratch;
+            size_t                   block_count;
+        };
+
+        template <size_t Dimensions>
+        void allocate_diagnostics_accumulator(
+            OUT CALLER_DELETE DiagnosticsAccumulator<Dimensions>& accumulator,
+            size_t                                                particle_count
+        );
+
+        template <size_t Dimensions>
+        void deallocate_diagnostics_accumulator(
+            OUT CALLER_DELETE DiagnosticsAccumulator<Dimensions>& accumulator
+        );
+
+        template <size_t Dimensions>
+        void reset_diagnostics_accumulator(
+            OUT DiagnosticsAccumulator<Dimensions>& accumulator
+        );
+
+        /**
+         * \brief Adds the kinetic energy, momentum, virial and half potential of
+         * particle to sums.
+         */
+        template <size_t Dimensions, DynamicParticle<Dimensions> ParticleType>
+        void accumulate_particle_diagnostics(
+            IN OUT Diagnostics<Dimensions>& sums, const ParticleType& particle
+        );
+
+        template <size_t Dimensions>
+        Diagnostics<Dimensions>
+        reduce_diagnostics(const DiagnosticsAccumulator<Dimensions>& accumulator);
+
+        /**
+         * \brief Time series of the diagnostics of the last capacity steps recorded,
+         * held as a ring, along with those of the first step for measuring drift.
+         */
+        template <size_t Dimensions>
+        struct DiagnosticsSeries {
+            Diagnostics<Dimensions>* steps;
+            NBS_PRECISION*           times;
+            size_t                   capacity;
+            // Steps recorded in total, which may be more than are held.
+            size_t                  count;
+            Diagnostics<Dimensions> initial;
+        };
+
+        template <size_t Dimensions>
+        void allocate_diagnostics_series(
+            OUT CALLER_DELETE DiagnosticsSeries<Dimensions>& series, size_t capacity
+        );
+
+        template <size_t Dimensions>
+        void deallocate_diagnostics_series(
+            OUT CALLER_DELETE DiagnosticsSeries<Dimensions>& series
+        );
+
+        template <size_t Dimensions>
+        void record_diagnostics(
+            IN OUT DiagnosticsSeries<Dimensions>& series,
+            NBS_PRECISION                         time,
+            const Diagnostics<Dimensions>&        diagnostics
+        );
+
+        /**
+         * \brief Diagnostics of the step recorded steps_ago steps before the latest,
+         * which must still be held.
+         */
+        template <size_t Dimensions>
+        const Diagnostics<Dimensions>& recorded_diagnostics(
+            const DiagnosticsSeries<Dimensions>& series, size_t steps_ago = 0
+        );
+
+        /**
+         * \brief Change in total energy from the first step recorded to the latest,
+         * relative to the first.
+         */
+        template <size_t Dimensions>
+        NBS_PRECISION relative_energy_error(const DiagnosticsSeries<Dimensions>& series
+        );
+    }  // namespace diagnostics
+}  // namespace nbs
+
+#include "diagnostics.inl"
+
+#endif  // N_BODY_SIM_DIAGNOSTICS_DIAGNOSTICS_HPP
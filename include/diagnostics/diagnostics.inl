@@ -0,0 +1,144 @@
+template <size_t Dimensions>
+NBS_PRECISION
+nbs::diagnostics::total_energy(const Diagnostics<Dimensions>& diagnostics) {
+    return diagnostics.kinetic_energy + diagnostics.potential_energy;
+}
+
+template <size_t Dimensions>
+NBS_PRECISION
+nbs::diagnostics::virial_ratio(const Diagnostics<Dimensions>& diagnostics) {
+    return -2 * diagnostics.kinetic_energy / diagnostics.virial;
+}
+
+template <size_t Dimensions>
+void nbs::diagnostics::allocate_diagnostics_accumulator(
+    OUT CALLER_DELETE DiagnosticsAccumulator<Dimensions>& accumulator,
+    size_t                                                particle_count
+) {
+    const size_t block_count
+        = (particle_count + DIAGNOSTICS_BLOCK_SIZE - 1) / DIAGNOSTICS_BLOCK_SIZE;
+
+    accumulator.block_sums     = new Diagnostics<Dimensions>[block_count]{};
+    accumulator.reduce_scratch = new Diagnostics<Dimensions>[block_count];
+    accumulator.block_count    = block_count;
+}
+
+template <size_t Dimensions>
+void nbs::diagnostics::deallocate_diagnostics_accumulator(
+    OUT CALLER_DELETE DiagnosticsAccumulator<Dimensions>& accumulator
+) {
+    delete[] accumulator.block_sums;
+    delete[] accumulator.reduce_scratch;
+
+    accumulator.block_sums     = nullptr;
+    accumulator.reduce_scratch = nullptr;
+    accumulator.block_count    = 0;
+}
+
+template <size_t Dimensions>
+void nbs::diagnostics::reset_diagnostics_accumulator(
+    OUT DiagnosticsAccumulator<Dimensions>& accumulator
+) {
+    for (size_t block_idx = 0; block_idx < accumulator.block_count; ++block_idx) {
+        accumulator.block_sums[block_idx] = {};
+    }
+}
+
+template <size_t Dimensions, nbs::DynamicParticle<Dimensions> ParticleType>
+void nbs::diagnostics::accumulate_particle_diagnostics(
+    IN OUT Diagnostics<Dimensions>& sums, const ParticleType& particle
+) {
+    const NBS_PRECISION mass = mass_of(particle);
+
+    sums.kinetic_energy += mass * math::dot(particle.velocity, particle.velocity) / 2;
+    sums.momentum       += particle.velocity * mass;
+    sums.virial         += math::dot(particle.position, particle.force);
+
+    if constexpr (PotentialParticle<ParticleType>) {
+        sums.potential_energy += particle.potential / 2;
+    }
+}
+
+template <size_t Dimensions>
+nbs::diagnostics::Diagnostics<Dimensions> nbs::diagnostics::reduce_diagnostics(
+    const DiagnosticsAccumulator<Dimensions>& accumulator
+) {
+    auto add = [](const Diagnostics<Dimensions>& lhs, const Diagnostics<Dimensions>& rhs
+               ) {
+        return Diagnostics<Dimensions>{
+            .kinetic_energy   = lhs.kinetic_energy + rhs.kinetic_energy,
+            .potential_energy = lhs.potential_energy + rhs.potential_energy,
+            .momentum         = lhs.momentum + rhs.momentum,
+            .virial           = lhs.virial + rhs.virial
+        };
+    };
+
+    // Combined in the scratch, so that the accumulator can be reduced again.
+    std::copy_n(
+        accumulator.block_sums, accumulator.block_count, accumulator.reduce_scratch
+    );
+
+    return parallel::tree_reduce(
+        accumulator.reduce_scratch,
+        accumulator.block_count,
+        Diagnostics<Dimensions>{},
+        add
+    );
+}
+
+template <size_t Dimensions>
+void nbs::diagnostics::allocate_diagnostics_series(
+    OUT CALLER_DELETE DiagnosticsSeries<Dimensions>& series, size_t capacity
+) {
+    series.steps    = new Diagnostics<Dimensions>[capacity]{};
+    series.times    = new NBS_PRECISION[capacity]{};
+    series.capacity = capacity;
+    series.count    = 0;
+    series.initial  = {};
+}
+
+template <size_t Dimensions>
+void nbs::diagnostics::deallocate_diagnostics_series(
+    OUT CALLER_DELETE DiagnosticsSeries<Dimensions>& series
+) {
+    delete[] series.steps;
+    delete[] series.times;
+
+    series.capacity = 0;
+    series.count    = 0;
+}
+
+template <size_t Dimensions>
+void nbs::diagnostics::record_diagnostics(
+    IN OUT DiagnosticsSeries<Dimensions>& series,
+    NBS_PRECISION                         time,
+    const Diagnostics<Dimensions>&        diagnostics
+) {
+    if (series.count == 0) series.initial = diagnostics;
+
+    const size_t slot = series.count % series.capacity;
+
+    series.steps[slot] = diagnostics;
+    series.times[slot] = time;
+
+    ++series.count;
+}
+
+template <size_t Dimensions>
+const nbs::diagnostics::Diagnostics<Dimensions>&
+nbs::diagnostics::recorded_diagnostics(
+    const DiagnosticsSeries<Dimensions>& series, size_t steps_ago /*= 0*/
+) {
+    assert(steps_ago < series.count && steps_ago < series.capacity);
+
+    return series.steps[(series.count - 1 - steps_ago) % series.capacity];
+}
+
+template <size_t Dimensions>
+NBS_PRECISION
+nbs::diagnostics::relative_energy_error(const DiagnosticsSeries<Dimensions>& series) {
+    const NBS_PRECISION initial_energy = total_energy(series.initial);
+    const NBS_PRECISION latest_energy  = total_energy(recorded_diagnostics(series));
+
+    return (latest_energy - initial_energy) / std::abs(initial_energy);
+}
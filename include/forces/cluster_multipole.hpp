@@ -0,0 +1,108 @@
+#ifndef N_BODY_SIM_FORCES_CLUSTER_MULTIPOLE_HPP
+#define N_BODY_SIM_FORCES_CLUSTER_MULTIPOLE_HPP
+
+#pragma once
+
+#include "clustering/moments.hpp"
+
+namespace nbs {
+    namespace forces {
+        /**
+         * \brief Whether a cluster is far enough from position for its multipole
+         * expansion to stand in for its particles, i.e. radius / distance is below
+         * opening_angle.
+         */
+        template <size_t Dimensions>
+        bool is_well_separated(
+            const vec<Dimensions, NBS_PRECISION>&      position,
+            const cluster::ClusterMoments<Dimensions>& moments,
+            NBS_PRECISION                              opening_angle
+        );
+
+        /**
+         * \brief Whether two clusters, of the given radii and with centres separated
+         * by separation, are far enough apart for each to act on every particle of
+         * the other through a local expansion, i.e. the sum of their radii over the
+         * distance between their centres is below opening_angle.
+         */
+        template <size_t Dimensions>
+        bool are_well_separated(
+            const vec<Dimensions, NBS_PRECISION>& separation,
+            NBS_PRECISION                         radius_1,
+            NBS_PRECISION                         radius_2,
+            NBS_PRECISION                         opening_angle
+        );
+
+        /**
+         * \brief Gravitational field (force per unit mass, G = 1) at position due to
+         * the monopole and quadrupole moments of a cluster.
+         */
+        template <size_t Dimensions>
+        vec<Dimensions, NBS_PRECISION> cluster_multipole_field(
+            const vec<Dimensions, NBS_PRECISION>&      position,
+            const cluster::ClusterMoments<Dimensions>& moments
+        );
+
+        /**
+         * \brief Gravitational potential energy per unit mass at position due to the
+         * monopole and quadrupole moments of a cluster, the counterpart of
+         * cluster_multipole_field.
+         */
+        template <size_t Dimensions>
+        NBS_PRECISION cluster_multipole_potential(
+            const vec<Dimensions, NBS_PRECISION>&      position,
+            const cluster::ClusterMoments<Dimensions>& moments
+        );
+
+        /**
+         * \brief Field of far clusters expanded about a centre, so that it can be
+         * evaluated at each particle near the centre for the cost of one cluster.
+         */
+        template <size_t Dimensions>
+        struct LocalExpansion {
+            // Potential energy per unit mass and field at the centre.
+            NBS_PRECISION                  potential;
+            vec<Dimensions, NBS_PRECISION> field;
+            // Derivative of the field along each axis, field_gradient[col][row] being
+            // d field[row] / d x[col], and of that along each axis in turn.
+            mat<Dimensions, Dimensions, NBS_PRECISION> field_gradient;
+            mat<Dimensions, Dimensions, NBS_PRECISION> field_curvature[Dimensions];
+        };
+
+        /**
+         * \brief Adds the field of a cluster to a local expansion about centre. The
+         * monopole is expanded to second order in the offset from centre, the
+         * quadrupole to zeroth, which drops terms of the same order in
+         * radius / distance as the multipole expansion itself.
+         */
+        template <size_t Dimensions>
+        void add_to_local_expansion(
+            IN OUT LocalExpansion<Dimensions>&         local,
+            const vec<Dimensions, NBS_PRECISION>&      centre,
+            const cluster::ClusterMoments<Dimensions>& moments
+        );
+
+        /**
+         * \brief Field of a local expansion at offset from its centre.
+         */
+        template <size_t Dimensions>
+        vec<Dimensions, NBS_PRECISION> local_expansion_field(
+            const LocalExpansion<Dimensions>&     local,
+            const vec<Dimensions, NBS_PRECISION>& offset
+        );
+
+        /**
+         * \brief Potential energy per unit mass of a local expansion at offset from
+         * its centre, the counterpart of local_expansion_field.
+         */
+        template <size_t Dimensions>
+        NBS_PRECISION local_expansion_potential(
+            const LocalExpansion<Dimensions>&     local,
+            const vec<Dimensions, NBS_PRECISION>& offset
+        );
+    }  // namespace forces
+}  // namespace nbs
+
+#include "cluster_multipole.inl"
+
+#endif  // N_BODY_SIM_FORCES_CLUSTER_MULTIPOLE_HPP
@@ -0,0 +1,146 @@
+template <size_t Dimensions>
+bool nbs::forces::is_well_separated(
+    const vec<Dimensions, NBS_PRECISION>&      position,
+    const cluster::ClusterMoments<Dimensions>& moments,
+    NBS_PRECISION                              opening_angle
+) {
+    const NBS_PRECISION distance_2 = math::distance2(position, moments.centre);
+
+    return moments.radius * moments.radius
+           < opening_angle * opening_angle * distance_2;
+}
+
+template <size_t Dimensions>
+bool nbs::forces::are_well_separated(
+    const vec<Dimensions, NBS_PRECISION>& separation,
+    NBS_PRECISION                         radius_1,
+    NBS_PRECISION                         radius_2,
+    NBS_PRECISION                         opening_angle
+) {
+    const NBS_PRECISION radii = radius_1 + radius_2;
+
+    return radii * radii
+           < opening_angle * opening_angle * math::dot(separation, separation);
+}
+
+template <size_t Dimensions>
+nbs::vec<Dimensions, NBS_PRECISION> nbs::forces::cluster_multipole_field(
+    const vec<Dimensions, NBS_PRECISION>&      position,
+    const cluster::ClusterMoments<Dimensions>& moments
+) {
+    // With r = position - centre, the potential is
+    //     phi = M / |r| + r.Q.r / (2 |r|^5)
+    // and the field its gradient
+    //     -M r / |r|^3 + Q r / |r|^5 - 5 (r.Q.r) r / (2 |r|^7)
+    const vec<Dimensions, NBS_PRECISION> r = position - moments.centre;
+
+    const NBS_PRECISION inverse_distance_2
+        = static_cast<NBS_PRECISION>(1) / math::dot(r, r);
+    const NBS_PRECISION inverse_distance   = math::sqrt(inverse_distance_2);
+    const NBS_PRECISION inverse_distance_3 = inverse_distance * inverse_distance_2;
+    const NBS_PRECISION inverse_distance_5 = inverse_distance_3 * inverse_distance_2;
+
+    const vec<Dimensions, NBS_PRECISION> q_r   = moments.quadrupole * r;
+    const NBS_PRECISION                  r_q_r = math::dot(r, q_r);
+
+    return r
+               * (-moments.mass * inverse_distance_3
+                  - r_q_r * 5 / 2 * inverse_distance_5 * inverse_distance_2)
+           + q_r * inverse_distance_5;
+}
+
+template <size_t Dimensions>
+NBS_PRECISION nbs::forces::cluster_multipole_potential(
+    const vec<Dimensions, NBS_PRECISION>&      position,
+    const cluster::ClusterMoments<Dimensions>& moments
+) {
+    // Potential energy is -phi, for phi as in cluster_multipole_field.
+    const vec<Dimensions, NBS_PRECISION> r = position - moments.centre;
+
+    const NBS_PRECISION inverse_distance_2
+        = static_cast<NBS_PRECISION>(1) / math::dot(r, r);
+    const NBS_PRECISION inverse_distance   = math::sqrt(inverse_distance_2);
+    const NBS_PRECISION inverse_distance_5
+        = inverse_distance * inverse_distance_2 * inverse_distance_2;
+
+    const NBS_PRECISION r_q_r = math::dot(r, moments.quadrupole * r);
+
+    return -moments.mass * inverse_distance - r_q_r / 2 * inverse_distance_5;
+}
+
+template <size_t Dimensions>
+void nbs::forces::add_to_local_expansion(
+    IN OUT LocalExpansion<Dimensions>&         local,
+    const vec<Dimensions, NBS_PRECISION>&      centre,
+    const cluster::ClusterMoments<Dimensions>& moments
+) {
+    local.field     += cluster_multipole_field(centre, moments);
+    local.potential += cluster_multipole_potential(centre, moments);
+
+    // With r = centre - cluster centre, the monopole field -M r / |r|^3 has gradient
+    //     M (3 r r^T / |r|^5 - I / |r|^3)
+    // and, along x_k, curvature
+    //     3 M (r_k I + e_k r^T + r e_k^T) / |r|^5 - 15 M r_k r r^T / |r|^7
+    const vec<Dimensions, NBS_PRECISION> r = centre - moments.centre;
+
+    const NBS_PRECISION inverse_distance_2
+        = static_cast<NBS_PRECISION>(1) / math::dot(r, r);
+    const NBS_PRECISION inverse_distance   = math::sqrt(inverse_distance_2);
+    const NBS_PRECISION inverse_distance_3 = inverse_distance * inverse_distance_2;
+    const NBS_PRECISION inverse_distance_5 = inverse_distance_3 * inverse_distance_2;
+    const NBS_PRECISION inverse_distance_7 = inverse_distance_5 * inverse_distance_2;
+
+    const NBS_PRECISION mass = moments.mass;
+
+    for (size_t col = 0; col < Dimensions; ++col) {
+        for (size_t row = 0; row < Dimensions; ++row) {
+            local.field_gradient[col][row]
+                += mass
+                   * (3 * r[col] * r[row] * inverse_distance_5
+                      - (col == row ? inverse_distance_3 : 0));
+
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                const NBS_PRECISION deltas = (col == row ? r[dim] : 0)
+                                             + (dim == col ? r[row] : 0)
+                                             + (dim == row ? r[col] : 0);
+
+                local.field_curvature[dim][col][row]
+                    += mass
+                       * (3 * deltas * inverse_distance_5
+                          - 15 * r[dim] * r[col] * r[row] * inverse_distance_7);
+            }
+        }
+    }
+}
+
+template <size_t Dimensions>
+nbs::vec<Dimensions, NBS_PRECISION> nbs::forces::local_expansion_field(
+    const LocalExpansion<Dimensions>&     local,
+    const vec<Dimensions, NBS_PRECISION>& offset
+) {
+    vec<Dimensions, NBS_PRECISION> field
+        = local.field + local.field_gradient * offset;
+
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        field += (local.field_curvature[dim] * offset) * (offset[dim] / 2);
+    }
+
+    return field;
+}
+
+template <size_t Dimensions>
+NBS_PRECISION nbs::forces::local_expansion_potential(
+    const LocalExpansion<Dimensions>&     local,
+    const vec<Dimensions, NBS_PRECISION>& offset
+) {
+    // Potential energy is minus the integral of the field from the centre.
+    NBS_PRECISION potential = local.potential - math::dot(local.field, offset)
+                              - math::dot(offset, local.field_gradient * offset) / 2;
+
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        potential -= math::dot(offset, local.field_curvature[dim] * offset)
+                     * offset[dim] / 6;
+    }
+
+    return potential;
+}
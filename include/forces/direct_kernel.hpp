@@ -0,0 +1,96 @@
+#ifndef N_BODY_SIM_FORCES_DIRECT_KERNEL_HPP
+#define N_BODY_SIM_FORCES_DIRECT_KERNEL_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "forces/laws.hpp"
+
+namespace nbs {
+    namespace forces {
+        /**
+         * \brief Structure-of-arrays copy of a range of particles for the direct
+         * kernels. Capacity is kept a multiple of the SIMD width so kernels can load
+         * whole tiles past the last particle. Positions are held relative to origin
+         * in compute precision. Value-initialise before first use.
+         */
+        template <size_t Dimensions>
+        struct DirectKernelScratch {
+            NBS_COMPUTE_PRECISION*         positions[Dimensions];
+            NBS_COMPUTE_PRECISION*         forces[Dimensions];
+            NBS_COMPUTE_PRECISION*         masses;
+            NBS_COMPUTE_PRECISION*         potentials;
+            size_t                         capacity;
+            vec<Dimensions, NBS_PRECISION> origin;
+        };
+
+        /**
+         * \brief Ensures scratch can hold count particles, only allocating when it
+         * must grow.
+         */
+        template <size_t Dimensions>
+        void reserve_direct_kernel_scratch(
+            IN OUT CALLER_DELETE DirectKernelScratch<Dimensions>& scratch, size_t count
+        );
+
+        template <size_t Dimensions>
+        void deallocate_direct_kernel_scratch(
+            OUT CALLER_DELETE DirectKernelScratch<Dimensions>& scratch
+        );
+
+        /**
+         * \brief Copies positions and masses of count particles into scratch and
+         * zeroes the scratch forces, including the padding up to the next whole tile.
+         * Positions are taken relative to the first particle, which keeps them small
+         * enough for compute precision however far the particles are from zero.
+         */
+        template <size_t Dimensions, Particle<Dimensions> ParticleType>
+        void gather_direct_kernel_scratch(
+            const ParticleType*                  particles,
+            size_t                               count,
+            OUT DirectKernelScratch<Dimensions>& scratch
+        );
+
+        /**
+         * \brief Adds scratch forces onto particle.force of count particles, and
+         * scratch potentials onto particle.potential if they have one.
+         */
+        template <size_t Dimensions, ForceParticle<Dimensions> ParticleType>
+        void scatter_direct_kernel_scratch(
+            const DirectKernelScratch<Dimensions>& scratch,
+            size_t                                 count,
+            IN OUT ParticleType*                   particles
+        );
+
+        /**
+         * \brief Accumulates the force of every pair of the count particles in
+         * scratch into scratch forces. Each pair is evaluated once and applied to
+         * both particles; the j particles of each row are processed a SIMD-width tile
+         * at a time with forces on i held in registers until the row is done.
+         *
+         * With WithPotential, the potential energy of each pair is accumulated into
+         * the scratch potentials of both particles alongside.
+         */
+        template <size_t Dimensions, ForceLaw Law, bool WithPotential = false>
+        void direct_sum_symmetric(
+            IN OUT DirectKernelScratch<Dimensions>& scratch, size_t count
+        );
+
+        /**
+         * \brief Accumulates the force on the target particle from each of the
+         * other count particles in scratch into its scratch force. For when only a
+         * few particles of a range need their forces, where the symmetric kernel
+         * would evaluate every pair. With WithPotential, also accumulates its
+         * potential energy into its scratch potential.
+         */
+        template <size_t Dimensions, ForceLaw Law, bool WithPotential = false>
+        void direct_sum_onto(
+            IN OUT DirectKernelScratch<Dimensions>& scratch, size_t count, size_t target
+        );
+    }  // namespace forces
+}  // namespace nbs
+
+#include "direct_kernel.inl"
+
+#endif  // N_BODY_SIM_FORCES_DIRECT_KERNEL_HPP
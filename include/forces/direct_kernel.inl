@@ -0,0 +1,324 @@
+template <size_t Dimensions>
+void nbs::forces::reserve_direct_kernel_scratch(
+    IN OUT CALLER_DELETE DirectKernelScratch<Dimensions>& scratch, size_t count
+) {
+    const size_t padded_count
+        = (count + simd::f32_width - 1) / simd::f32_width * simd::f32_width;
+
+    if (padded_count <= scratch.capacity) return;
+
+    deallocate_direct_kernel_scratch(scratch);
+
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        scratch.positions[dim] = new NBS_COMPUTE_PRECISION[padded_count]{};
+        scratch.forces[dim]    = new NBS_COMPUTE_PRECISION[padded_count]{};
+    }
+    scratch.masses     = new NBS_COMPUTE_PRECISION[padded_count]{};
+    scratch.potentials = new NBS_COMPUTE_PRECISION[padded_count]{};
+    scratch.capacity   = padded_count;
+}
+
+template <size_t Dimensions>
+void nbs::forces::deallocate_direct_kernel_scratch(
+    OUT CALLER_DELETE DirectKernelScratch<Dimensions>& scratch
+) {
+    if (scratch.capacity == 0) return;
+
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        delete[] scratch.positions[dim];
+        delete[] scratch.forces[dim];
+    }
+    delete[] scratch.masses;
+    delete[] scratch.potentials;
+
+    scratch.capacity = 0;
+}
+
+template <size_t Dimensions, nbs::Particle<Dimensions> ParticleType>
+void nbs::forces::gather_direct_kernel_scratch(
+    const ParticleType*                  particles,
+    size_t                               count,
+    OUT DirectKernelScratch<Dimensions>& scratch
+) {
+    reserve_direct_kernel_scratch(scratch, count);
+
+    if (count > 0) scratch.origin = particles[0].position;
+
+    // Differences are taken in storage precision, so only their rounding to compute
+    // precision is lost.
+    for (size_t idx = 0; idx < count; ++idx) {
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            scratch.positions[dim][idx]
+                = particles[idx].position[dim] - scratch.origin[dim];
+        }
+        scratch.masses[idx] = mass_of(particles[idx]);
+    }
+
+    // Padding has zero mass, so contributes nothing even when it is loaded.
+    const size_t padded_count
+        = (count + simd::f32_width - 1) / simd::f32_width * simd::f32_width;
+    for (size_t idx = count; idx < padded_count; ++idx) {
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            scratch.positions[dim][idx] = 0;
+        }
+        scratch.masses[idx] = 0;
+    }
+
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        std::fill_n(scratch.forces[dim], padded_count, 0);
+    }
+    std::fill_n(scratch.potentials, padded_count, 0);
+}
+
+template <size_t Dimensions, nbs::ForceParticle<Dimensions> ParticleType>
+void nbs::forces::scatter_direct_kernel_scratch(
+    const DirectKernelScratch<Dimensions>& scratch,
+    size_t                                 count,
+    IN OUT ParticleType*                   particles
+) {
+    for (size_t idx = 0; idx < count; ++idx) {
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            particles[idx].force[dim] += scratch.forces[dim][idx];
+        }
+
+        if constexpr (PotentialParticle<ParticleType>) {
+            particles[idx].potential += scratch.potentials[idx];
+        }
+    }
+}
+
+template <size_t Dimensions, nbs::forces::ForceLaw Law, bool WithPotential>
+void nbs::forces::direct_sum_symmetric(
+    IN OUT DirectKernelScratch<Dimensions>& scratch, size_t count
+) {
+    static_assert(
+        !WithPotential || PotentialLaw<Law>,
+        "Potentials can only be accumulated for laws that define one."
+    );
+
+    NBS_COMPUTE_PRECISION* const* positions = scratch.positions;
+    NBS_COMPUTE_PRECISION* const* forces    = scratch.forces;
+    const NBS_COMPUTE_PRECISION*  masses    = scratch.masses;
+
+#if defined(NBS_SIMD_F32_KERNELS)
+    const __m256i lane_offsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i count_v      = _mm256_set1_epi32(static_cast<i32>(count));
+
+    for (size_t i = 0; i < count; ++i) {
+        __m256 position_i[Dimensions];
+        __m256 force_i[Dimensions];
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            position_i[dim] = _mm256_set1_ps(positions[dim][i]);
+            force_i[dim]    = _mm256_setzero_ps();
+        }
+        const __m256  mass_i      = _mm256_set1_ps(masses[i]);
+        const __m256i i_v         = _mm256_set1_epi32(static_cast<i32>(i));
+        __m256        potential_i = _mm256_setzero_ps();
+
+        // Start at the tile holding i + 1, masking off lanes at or before i.
+        for (size_t j = (i + 1) / simd::f32_width * simd::f32_width; j < count;
+             j += simd::f32_width)
+        {
+            const __m256i j_v = _mm256_add_epi32(
+                _mm256_set1_epi32(static_cast<i32>(j)), lane_offsets
+            );
+            const __m256i lane_valid = _mm256_and_si256(
+                _mm256_cmpgt_epi32(j_v, i_v), _mm256_cmpgt_epi32(count_v, j_v)
+            );
+
+            __m256 displacement[Dimensions];
+            __m256 distance_2 = _mm256_setzero_ps();
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                displacement[dim] = _mm256_sub_ps(
+                    _mm256_loadu_ps(positions[dim] + j), position_i[dim]
+                );
+                distance_2 = _mm256_add_ps(
+                    distance_2, _mm256_mul_ps(displacement[dim], displacement[dim])
+                );
+            }
+
+            // Coincident particles exert no force on one another.
+            const __m256 valid = _mm256_and_ps(
+                _mm256_castsi256_ps(lane_valid),
+                _mm256_cmp_ps(distance_2, _mm256_setzero_ps(), _CMP_GT_OQ)
+            );
+
+            const __m256 mass_product
+                = _mm256_mul_ps(mass_i, _mm256_loadu_ps(masses + j));
+
+            const __m256 scale = _mm256_and_ps(
+                valid, _mm256_mul_ps(Law::scale(distance_2), mass_product)
+            );
+
+            if constexpr (WithPotential) {
+                const __m256 potential = _mm256_and_ps(
+                    valid, _mm256_mul_ps(Law::potential(distance_2), mass_product)
+                );
+
+                potential_i = _mm256_add_ps(potential_i, potential);
+                _mm256_storeu_ps(
+                    scratch.potentials + j,
+                    _mm256_add_ps(_mm256_loadu_ps(scratch.potentials + j), potential)
+                );
+            }
+
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                const __m256 force = _mm256_mul_ps(displacement[dim], scale);
+
+                force_i[dim] = _mm256_add_ps(force_i[dim], force);
+                _mm256_storeu_ps(
+                    forces[dim] + j,
+                    _mm256_sub_ps(_mm256_loadu_ps(forces[dim] + j), force)
+                );
+            }
+        }
+
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            forces[dim][i] += simd::horizontal_sum(force_i[dim]);
+        }
+
+        if constexpr (WithPotential) {
+            scratch.potentials[i] += simd::horizontal_sum(potential_i);
+        }
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        NBS_COMPUTE_PRECISION force_i[Dimensions] = {};
+        NBS_COMPUTE_PRECISION potential_i         = 0;
+
+        for (size_t j = i + 1; j < count; ++j) {
+            NBS_COMPUTE_PRECISION displacement[Dimensions];
+            NBS_COMPUTE_PRECISION distance_2 = 0;
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                displacement[dim]  = positions[dim][j] - positions[dim][i];
+                distance_2        += displacement[dim] * displacement[dim];
+            }
+
+            if (distance_2 == 0) continue;
+
+            const NBS_COMPUTE_PRECISION scale
+                = Law::scale(distance_2) * masses[i] * masses[j];
+
+            if constexpr (WithPotential) {
+                const NBS_COMPUTE_PRECISION potential
+                    = Law::potential(distance_2) * masses[i] * masses[j];
+
+                potential_i           += potential;
+                scratch.potentials[j] += potential;
+            }
+
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                force_i[dim]   += displacement[dim] * scale;
+                forces[dim][j] -= displacement[dim] * scale;
+            }
+        }
+
+        for (size_t dim = 0; dim < Dimensions; ++dim) forces[dim][i] += force_i[dim];
+
+        if constexpr (WithPotential) scratch.potentials[i] += potential_i;
+    }
+#endif
+}
+
+template <size_t Dimensions, nbs::forces::ForceLaw Law, bool WithPotential>
+void nbs::forces::direct_sum_onto(
+    IN OUT DirectKernelScratch<Dimensions>& scratch, size_t count, size_t target
+) {
+    static_assert(
+        !WithPotential || PotentialLaw<Law>,
+        "Potentials can only be accumulated for laws that define one."
+    );
+
+    NBS_COMPUTE_PRECISION* const* positions = scratch.positions;
+    NBS_COMPUTE_PRECISION* const* forces    = scratch.forces;
+    const NBS_COMPUTE_PRECISION*  masses    = scratch.masses;
+
+#if defined(NBS_SIMD_F32_KERNELS)
+    __m256 position_target[Dimensions];
+    __m256 force_target[Dimensions];
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        position_target[dim] = _mm256_set1_ps(positions[dim][target]);
+        force_target[dim]    = _mm256_setzero_ps();
+    }
+    const __m256 mass_target      = _mm256_set1_ps(masses[target]);
+    __m256       potential_target = _mm256_setzero_ps();
+
+    // Padding has zero mass and the target is coincident with itself, so only
+    // coincident particles need masking.
+    for (size_t j = 0; j < count; j += simd::f32_width) {
+        __m256 displacement[Dimensions];
+        __m256 distance_2 = _mm256_setzero_ps();
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            displacement[dim] = _mm256_sub_ps(
+                _mm256_loadu_ps(positions[dim] + j), position_target[dim]
+            );
+            distance_2 = _mm256_add_ps(
+                distance_2, _mm256_mul_ps(displacement[dim], displacement[dim])
+            );
+        }
+
+        const __m256 valid
+            = _mm256_cmp_ps(distance_2, _mm256_setzero_ps(), _CMP_GT_OQ);
+
+        const __m256 mass_product
+            = _mm256_mul_ps(mass_target, _mm256_loadu_ps(masses + j));
+
+        const __m256 scale
+            = _mm256_and_ps(valid, _mm256_mul_ps(Law::scale(distance_2), mass_product));
+
+        if constexpr (WithPotential) {
+            potential_target = _mm256_add_ps(
+                potential_target,
+                _mm256_and_ps(
+                    valid, _mm256_mul_ps(Law::potential(distance_2), mass_product)
+                )
+            );
+        }
+
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            force_target[dim] = _mm256_add_ps(
+                force_target[dim], _mm256_mul_ps(displacement[dim], scale)
+            );
+        }
+    }
+
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        forces[dim][target] += simd::horizontal_sum(force_target[dim]);
+    }
+
+    if constexpr (WithPotential) {
+        scratch.potentials[target] += simd::horizontal_sum(potential_target);
+    }
+#else
+    NBS_COMPUTE_PRECISION force_target[Dimensions] = {};
+    NBS_COMPUTE_PRECISION potential_target         = 0;
+
+    for (size_t j = 0; j < count; ++j) {
+        NBS_COMPUTE_PRECISION displacement[Dimensions];
+        NBS_COMPUTE_PRECISION distance_2 = 0;
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            displacement[dim]  = positions[dim][j] - positions[dim][target];
+            distance_2        += displacement[dim] * displacement[dim];
+        }
+
+        if (distance_2 == 0) continue;
+
+        const NBS_COMPUTE_PRECISION scale
+            = Law::scale(distance_2) * masses[target] * masses[j];
+
+        if constexpr (WithPotential) {
+            potential_target += Law::potential(distance_2) * masses[target] * masses[j];
+        }
+
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            force_target[dim] += displacement[dim] * scale;
+        }
+    }
+
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        forces[dim][target] += force_target[dim];
+    }
+
+    if constexpr (WithPotential) scratch.potentials[target] += potential_target;
+#endif
+}
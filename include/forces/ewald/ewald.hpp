@@ -0,0 +1,45 @@
+#ifndef N_BODY_SIM_FORCES_EWALD_EWALD_HPP
+#define N_BODY_SIM_FORCES_EWALD_EWALD_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "forces/ewald/options.hpp"
+#include "forces/ewald/table.hpp"
+#include "parallel/thread_pool.hpp"
+#include "spatial/periodic.hpp"
+
+namespace nbs {
+    namespace forces {
+        namespace ewald {
+            /**
+             * \brief Calculates the Newtonian gravitational force on each particle
+             * in the periodic box [0, box_size)^3 from every other particle and all
+             * of their images, by direct summation over nearest images with the
+             * Ewald correction interpolated from the table. Forces are attractive
+             * with G = 1 and particle masses from mass_of, and overwrite
+             * particle.force.
+             *
+             * Exact to the accuracy of the table, so suited to small boxes and to
+             * checking faster periodic solvers, see forces/pm/pm.hpp.
+             *
+             * \param particles The particles to calculate forces for, which may lie
+             * outside the box, their order is left untouched.
+             * \param table Table allocated with allocate_ewald_table.
+             * \param pool Pool over which particles are parallelised, if null the
+             * calculation is serial.
+             */
+            template <ForceParticle<3> ParticleType, EwaldOptions Options>
+            void calculate_forces(
+                IN OUT ParticleType*       particles,
+                const EwaldTable<Options>& table,
+                parallel::ThreadPool*      pool = nullptr
+            );
+        }  // namespace ewald
+    }      // namespace forces
+}  // namespace nbs
+
+#include "ewald.inl"
+
+#endif  // N_BODY_SIM_FORCES_EWALD_EWALD_HPP
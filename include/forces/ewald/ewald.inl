@@ -0,0 +1,35 @@
+template <
+    nbs::ForceParticle<3>            ParticleType,
+    nbs::forces::ewald::EwaldOptions Options>
+void nbs::forces::ewald::calculate_forces(
+    IN OUT ParticleType*       particles,
+    const EwaldTable<Options>& table,
+    parallel::ThreadPool*      pool /*= nullptr*/
+) {
+    auto particle_force = [&](size_t particle_idx) {
+        const vec<3, NBS_PRECISION>& position = particles[particle_idx].position;
+
+        vec<3, NBS_PRECISION> field = {};
+        for (size_t other_idx = 0; other_idx < Options.particle_count; ++other_idx) {
+            if (other_idx == particle_idx) continue;
+
+            const vec<3, NBS_PRECISION> displacement = spatial::nearest_image<3>(
+                particles[other_idx].position - position, Options.box_size
+            );
+            const NBS_PRECISION distance_2 = math::dot(displacement, displacement);
+            const NBS_PRECISION inverse_distance
+                = static_cast<NBS_PRECISION>(1) / math::sqrt(distance_2);
+
+            field += (displacement * inverse_distance * inverse_distance
+                          * inverse_distance
+                      + ewald_correction(table, displacement))
+                     * mass_of(particles[other_idx]);
+        }
+
+        particles[particle_idx].force = field * mass_of(particles[particle_idx]);
+    };
+
+    parallel::parallel_for(
+        pool, 0, Options.particle_count, Options.grain, particle_force
+    );
+}
@@ -0,0 +1,23 @@
+#ifndef N_BODY_SIM_FORCES_EWALD_OPTIONS_HPP
+#define N_BODY_SIM_FORCES_EWALD_OPTIONS_HPP
+
+#pragma once
+
+namespace nbs {
+    namespace forces {
+        namespace ewald {
+            struct EwaldOptions {
+                ui32 particle_count = 1000;
+                // Side of the periodic box [0, box_size)^3.
+                NBS_PRECISION box_size = 1;
+                // Intervals on each axis of the correction table, which covers the
+                // nearest-image displacements of the octant [0, box_size / 2]^3.
+                ui32 table_size = 32;
+                // Number of particles or table points handed to a thread at a time.
+                ui32 grain = 64;
+            };
+        }  // namespace ewald
+    }      // namespace forces
+}  // namespace nbs
+
+#endif  // N_BODY_SIM_FORCES_EWALD_OPTIONS_HPP
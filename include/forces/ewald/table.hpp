@@ -0,0 +1,56 @@
+#ifndef N_BODY_SIM_FORCES_EWALD_TABLE_HPP
+#define N_BODY_SIM_FORCES_EWALD_TABLE_HPP
+
+#pragma once
+
+#include "forces/ewald/options.hpp"
+#include "parallel/thread_pool.hpp"
+
+namespace nbs {
+    namespace forces {
+        namespace ewald {
+            /**
+             * \brief Precomputed difference between the Ewald-summed force of a
+             * mass and its periodic images and the force of its nearest image alone.
+             * The difference is smooth, so is interpolated from a coarse table.
+             */
+            template <EwaldOptions Options>
+            struct EwaldTable {
+                // Correction at each point of the table, x varying fastest. Each
+                // component is odd in its own axis and even in the others, so only
+                // the octant of positive displacements is held.
+                vec<3, NBS_PRECISION>* corrections;
+            };
+
+            /**
+             * \brief Allocates the correction table and precomputes it, summing in
+             * double precision whatever the precision of the simulation.
+             */
+            template <EwaldOptions Options>
+            void allocate_ewald_table(
+                OUT CALLER_DELETE EwaldTable<Options>& table,
+                parallel::ThreadPool*                  pool = nullptr
+            );
+
+            template <EwaldOptions Options>
+            void deallocate_ewald_table(OUT CALLER_DELETE EwaldTable<Options>& table);
+
+            /**
+             * \brief Correction to the force on a unit mass from a unit mass at
+             * displacement from it, such that displacement / |displacement|^3 plus
+             * the correction is the force from that mass and all of its periodic
+             * images, against a uniform background of negative mass keeping the box
+             * neutral. The displacement must be a nearest image.
+             */
+            template <EwaldOptions Options>
+            vec<3, NBS_PRECISION> ewald_correction(
+                const EwaldTable<Options>&   table,
+                const vec<3, NBS_PRECISION>& displacement
+            );
+        }  // namespace ewald
+    }      // namespace forces
+}  // namespace nbs
+
+#include "table.inl"
+
+#endif  // N_BODY_SIM_FORCES_EWALD_TABLE_HPP
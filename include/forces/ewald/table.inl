@@ -0,0 +1,194 @@
+namespace nbs {
+    namespace forces {
+        namespace ewald {
+            namespace detail {
+                template <EwaldOptions Options>
+                constexpr size_t table_points_on_axis = Options.table_size + 1;
+
+                // Correction in a unit box at a displacement d from the source mass.
+                // The force of each image is split by erfc(alpha r) into a part
+                // summed over nearby images in real space and a smooth remainder
+                // summed over few wavevectors in reciprocal space, both then
+                // converged to double precision.
+                inline std::array<f64, 3>
+                unit_box_correction(const std::array<f64, 3>& d) {
+                    constexpr f64 ALPHA          = 2.0;
+                    constexpr i32 IMAGE_RANGE    = 4;
+                    constexpr f64 IMAGE_CUTOFF_2 = 3.6 * 3.6;
+                    constexpr i32 WAVE_RANGE     = 4;
+                    constexpr i32 WAVE_CUTOFF_2  = 10;
+                    constexpr f64 TWO_PI         = 2.0 * std::numbers::pi;
+                    constexpr f64 GAUSSIAN_SCALE
+                        = 2.0 * ALPHA * std::numbers::inv_sqrtpi;
+
+                    std::array<f64, 3> correction = {};
+
+                    for (i32 x = -IMAGE_RANGE; x <= IMAGE_RANGE; ++x) {
+                        for (i32 y = -IMAGE_RANGE; y <= IMAGE_RANGE; ++y) {
+                            for (i32 z = -IMAGE_RANGE; z <= IMAGE_RANGE; ++z) {
+                                const std::array<f64, 3> r = {
+                                    d[0] - static_cast<f64>(x),
+                                    d[1] - static_cast<f64>(y),
+                                    d[2] - static_cast<f64>(z)
+                                };
+                                const f64 r_2
+                                    = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+
+                                // The nearest image at zero displacement contributes
+                                // nothing, by symmetry.
+                                if (r_2 > IMAGE_CUTOFF_2 || r_2 == 0.0) continue;
+
+                                const f64 distance = std::sqrt(r_2);
+                                const f64 gaussian
+                                    = GAUSSIAN_SCALE * distance
+                                      * std::exp(-ALPHA * ALPHA * r_2);
+
+                                // The nearest image's own Newtonian force is taken
+                                // off, so its erfc becomes -erf.
+                                const bool nearest = x == 0 && y == 0 && z == 0;
+                                const f64  factor
+                                    = (nearest ? -std::erf(ALPHA * distance)
+                                               : std::erfc(ALPHA * distance))
+                                      + gaussian;
+
+                                for (size_t dim = 0; dim < 3; ++dim) {
+                                    correction[dim]
+                                        += r[dim] * factor / (r_2 * distance);
+                                }
+                            }
+                        }
+                    }
+
+                    for (i32 x = -WAVE_RANGE; x <= WAVE_RANGE; ++x) {
+                        for (i32 y = -WAVE_RANGE; y <= WAVE_RANGE; ++y) {
+                            for (i32 z = -WAVE_RANGE; z <= WAVE_RANGE; ++z) {
+                                const i32 h_2 = x * x + y * y + z * z;
+
+                                if (h_2 == 0 || h_2 > WAVE_CUTOFF_2) continue;
+
+                                const std::array<f64, 3> k = {
+                                    TWO_PI * static_cast<f64>(x),
+                                    TWO_PI * static_cast<f64>(y),
+                                    TWO_PI * static_cast<f64>(z)
+                                };
+                                const f64 k_2
+                                    = k[0] * k[0] + k[1] * k[1] + k[2] * k[2];
+                                const f64 phase
+                                    = k[0] * d[0] + k[1] * d[1] + k[2] * d[2];
+
+                                const f64 weight
+                                    = 4.0 * std::numbers::pi
+                                      * std::exp(-k_2 / (4.0 * ALPHA * ALPHA)) / k_2
+                                      * std::sin(phase);
+
+                                for (size_t dim = 0; dim < 3; ++dim) {
+                                    correction[dim] += k[dim] * weight;
+                                }
+                            }
+                        }
+                    }
+
+                    return correction;
+                }
+            }  // namespace detail
+        }      // namespace ewald
+    }          // namespace forces
+}  // namespace nbs
+
+template <nbs::forces::ewald::EwaldOptions Options>
+void nbs::forces::ewald::allocate_ewald_table(
+    OUT CALLER_DELETE EwaldTable<Options>& table,
+    parallel::ThreadPool*                  pool /*= nullptr*/
+) {
+    constexpr size_t POINTS_ON_AXIS = detail::table_points_on_axis<Options>;
+
+    table.corrections
+        = new vec<3, NBS_PRECISION>[POINTS_ON_AXIS * POINTS_ON_AXIS * POINTS_ON_AXIS];
+
+    // Table points span half the box, and in a box of side L the correction is that
+    // of the unit box at d / L, scaled by 1 / L^2.
+    constexpr f64 SPACING     = 0.5 / static_cast<f64>(Options.table_size);
+    constexpr f64 box_size    = Options.box_size;
+    constexpr f64 FORCE_SCALE = 1.0 / (box_size * box_size);
+
+    auto fill_point = [&table](size_t point_idx) {
+        std::array<f64, 3> d         = {};
+        size_t             remainder = point_idx;
+        for (size_t dim = 0; dim < 3; ++dim) {
+            d[dim]     = static_cast<f64>(remainder % POINTS_ON_AXIS) * SPACING;
+            remainder /= POINTS_ON_AXIS;
+        }
+
+        const std::array<f64, 3> correction = detail::unit_box_correction(d);
+
+        for (size_t dim = 0; dim < 3; ++dim) {
+            const NBS_PRECISION component = correction[dim] * FORCE_SCALE;
+
+            table.corrections[point_idx][dim] = component;
+        }
+    };
+
+    parallel::parallel_for(
+        pool,
+        0,
+        POINTS_ON_AXIS * POINTS_ON_AXIS * POINTS_ON_AXIS,
+        Options.grain,
+        fill_point
+    );
+}
+
+template <nbs::forces::ewald::EwaldOptions Options>
+void nbs::forces::ewald::deallocate_ewald_table(
+    OUT CALLER_DELETE EwaldTable<Options>& table
+) {
+    delete[] table.corrections;
+    table.corrections = nullptr;
+}
+
+template <nbs::forces::ewald::EwaldOptions Options>
+nbs::vec<3, NBS_PRECISION> nbs::forces::ewald::ewald_correction(
+    const EwaldTable<Options>& table, const vec<3, NBS_PRECISION>& displacement
+) {
+    constexpr size_t POINTS_ON_AXIS = detail::table_points_on_axis<Options>;
+
+    const NBS_PRECISION inverse_spacing
+        = static_cast<NBS_PRECISION>(2 * Options.table_size) / Options.box_size;
+
+    // Cell of the table holding the displacement, folded into the octant, and the
+    // fractional position within it.
+    size_t                base_idx = 0;
+    size_t                stride   = 1;
+    vec<3, NBS_PRECISION> fraction;
+    for (size_t dim = 0; dim < 3; ++dim) {
+        const NBS_PRECISION coord = std::abs(displacement[dim]) * inverse_spacing;
+        const size_t        cell
+            = std::min(static_cast<size_t>(coord), size_t{ Options.table_size } - 1);
+
+        fraction[dim]  = coord - static_cast<NBS_PRECISION>(cell);
+        base_idx      += cell * stride;
+        stride        *= POINTS_ON_AXIS;
+    }
+
+    // Trilinear interpolation between the eight corners of the cell.
+    vec<3, NBS_PRECISION> correction = {};
+    for (size_t corner = 0; corner < 8; ++corner) {
+        NBS_PRECISION weight        = 1;
+        size_t        corner_idx    = base_idx;
+        size_t        corner_stride = 1;
+        for (size_t dim = 0; dim < 3; ++dim) {
+            const bool upper  = (corner >> dim) & 1;
+            weight           *= upper ? fraction[dim] : 1 - fraction[dim];
+            corner_idx       += upper ? corner_stride : 0;
+            corner_stride    *= POINTS_ON_AXIS;
+        }
+
+        correction += table.corrections[corner_idx] * weight;
+    }
+
+    // Unfold from the octant: each component is odd in its own axis.
+    for (size_t dim = 0; dim < 3; ++dim) {
+        if (displacement[dim] < 0) correction[dim] = -correction[dim];
+    }
+
+    return correction;
+}
@@ -0,0 +1,71 @@
+#ifndef N_BODY_SIM_FORCES_FMM_BUFFERS_HPP
+#define N_BODY_SIM_FORCES_FMM_BUFFERS_HPP
+
+#pragma once
+
+#include "forces/fmm/multi_index.hpp"
+#include "forces/fmm/options.hpp"
+
+namespace nbs {
+    namespace forces {
+        namespace fmm {
+            namespace detail {
+                template <size_t Dimensions, FMMOptions Options>
+                struct TreeShape {
+                    static constexpr size_t coefficient_count
+                        = MultiIndexTable<Dimensions, Options.expansion_order>::size;
+
+                    static constexpr size_t children_per_cell = size_t{ 1 }
+                                                                << Dimensions;
+
+                    static constexpr size_t cells_on_axis(size_t level) {
+                        return size_t{ 1 } << level;
+                    }
+
+                    static constexpr size_t cell_count(size_t level) {
+                        return size_t{ 1 } << (Dimensions * level);
+                    }
+
+                    static constexpr size_t level_offset(size_t level) {
+                        size_t offset = 0;
+                        for (size_t l = 0; l < level; ++l) offset += cell_count(l);
+                        return offset;
+                    }
+
+                    static constexpr size_t leaf_count
+                        = cell_count(Options.tree_depth);
+                    static constexpr size_t total_cell_count
+                        = level_offset(Options.tree_depth + 1);
+                };
+            }  // namespace detail
+
+            template <size_t Dimensions, FMMOptions Options>
+            struct FMMBuffers {
+                // Expansion coefficients for every cell of every level, level by
+                // level from the root.
+                NBS_PRECISION* multipoles;
+                NBS_PRECISION* locals;
+                // Particles sorted by leaf: particle_order[leaf_offsets[leaf] ...
+                // leaf_offsets[leaf + 1]) index the particles in that leaf.
+                ui32* leaf_offsets;
+                ui32* leaf_cursors;
+                ui32* particle_order;
+                ui32* particle_leaf;
+            };
+
+            template <size_t Dimensions, FMMOptions Options>
+            void allocate_fmm_buffers(
+                OUT CALLER_DELETE FMMBuffers<Dimensions, Options>& buffers
+            );
+
+            template <size_t Dimensions, FMMOptions Options>
+            void deallocate_fmm_buffers(
+                OUT CALLER_DELETE FMMBuffers<Dimensions, Options> buffers
+            );
+        }  // namespace fmm
+    }      // namespace forces
+}  // namespace nbs
+
+#include "buffers.inl"
+
+#endif  // N_BODY_SIM_FORCES_FMM_BUFFERS_HPP
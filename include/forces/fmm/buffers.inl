@@ -0,0 +1,28 @@
+template <size_t Dimensions, nbs::forces::fmm::FMMOptions Options>
+void nbs::forces::fmm::allocate_fmm_buffers(
+    OUT CALLER_DELETE FMMBuffers<Dimensions, Options>& buffers
+) {
+    using Shape = detail::TreeShape<Dimensions, Options>;
+
+    buffers.multipoles
+        = new NBS_PRECISION[Shape::total_cell_count * Shape::coefficient_count];
+    buffers.locals
+        = new NBS_PRECISION[Shape::total_cell_count * Shape::coefficient_count];
+
+    buffers.leaf_offsets   = new ui32[Shape::leaf_count + 1];
+    buffers.leaf_cursors   = new ui32[Shape::leaf_count];
+    buffers.particle_order = new ui32[Options.particle_count];
+    buffers.particle_leaf  = new ui32[Options.particle_count];
+}
+
+template <size_t Dimensions, nbs::forces::fmm::FMMOptions Options>
+void nbs::forces::fmm::deallocate_fmm_buffers(
+    OUT CALLER_DELETE FMMBuffers<Dimensions, Options> buffers
+) {
+    delete[] buffers.particle_leaf;
+    delete[] buffers.particle_order;
+    delete[] buffers.leaf_cursors;
+    delete[] buffers.leaf_offsets;
+    delete[] buffers.locals;
+    delete[] buffers.multipoles;
+}
@@ -0,0 +1,43 @@
+#ifndef N_BODY_SIM_FORCES_FMM_FMM_HPP
+#define N_BODY_SIM_FORCES_FMM_FMM_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "forces/fmm/buffers.hpp"
+#include "forces/fmm/multi_index.hpp"
+#include "forces/fmm/options.hpp"
+#include "parallel/thread_pool.hpp"
+
+namespace nbs {
+    namespace forces {
+        namespace fmm {
+            /**
+             * \brief Calculates the Newtonian gravitational force on each particle with
+             * the fast multipole method, using Cartesian Taylor expansions of the 1/r
+             * potential over a uniform tree. Forces are attractive with G = 1 and
+             * particle masses from mass_of. The result overwrites particle.force.
+             *
+             * \param particles The particles to calculate forces for, their order is
+             * left untouched.
+             * \param buffers Buffers allocated with allocate_fmm_buffers.
+             * \param pool Pool over which each tree level and interaction list pass is
+             * parallelised, if null the calculation is serial.
+             */
+            template <
+                size_t                    Dimensions,
+                ForceParticle<Dimensions> ParticleType,
+                FMMOptions                Options>
+            void calculate_forces(
+                IN OUT ParticleType* particles,
+                IN OUT FMMBuffers<Dimensions, Options> buffers,
+                parallel::ThreadPool*                  pool = nullptr
+            );
+        }  // namespace fmm
+    }      // namespace forces
+}  // namespace nbs
+
+#include "fmm.inl"
+
+#endif  // N_BODY_SIM_FORCES_FMM_FMM_HPP
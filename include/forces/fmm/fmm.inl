@@ -0,0 +1,411 @@
+namespace nbs {
+    namespace forces {
+        namespace fmm {
+            namespace detail {
+                template <size_t Dimensions>
+                vec<Dimensions, i32> cell_coords(size_t cell_idx, size_t level) {
+                    vec<Dimensions, i32> coords;
+                    for (size_t dim = 0; dim < Dimensions; ++dim) {
+                        coords[dim] = static_cast<i32>(
+                            (cell_idx >> (dim * level)) & ((size_t{ 1 } << level) - 1)
+                        );
+                    }
+                    return coords;
+                }
+
+                template <size_t Dimensions>
+                size_t cell_index(const vec<Dimensions, i32>& coords, size_t level) {
+                    size_t cell_idx = 0;
+                    for (size_t dim = 0; dim < Dimensions; ++dim) {
+                        cell_idx |= static_cast<size_t>(coords[dim]) << (dim * level);
+                    }
+                    return cell_idx;
+                }
+
+                template <size_t Dimensions>
+                bool cell_in_bounds(const vec<Dimensions, i32>& coords, size_t level) {
+                    for (size_t dim = 0; dim < Dimensions; ++dim) {
+                        if (coords[dim] < 0
+                            || coords[dim] >= static_cast<i32>(size_t{ 1 } << level))
+                            return false;
+                    }
+                    return true;
+                }
+
+                /**
+                 * \brief Calls func(offset) for each offset in {-1, 0, 1}^Dimensions.
+                 */
+                template <size_t Dimensions, typename Func>
+                void for_each_adjacent_offset(Func&& func) {
+                    constexpr size_t offset_count = integer_pow(3, Dimensions);
+                    for (size_t code = 0; code < offset_count; ++code) {
+                        vec<Dimensions, i32> offset;
+
+                        size_t remainder = code;
+                        for (size_t dim = 0; dim < Dimensions; ++dim) {
+                            offset[dim]  = static_cast<i32>(remainder % 3) - 1;
+                            remainder   /= 3;
+                        }
+
+                        func(offset);
+                    }
+                }
+            }  // namespace detail
+        }      // namespace fmm
+    }          // namespace forces
+}  // namespace nbs
+
+template <
+    size_t                         Dimensions,
+    nbs::ForceParticle<Dimensions> ParticleType,
+    nbs::forces::fmm::FMMOptions   Options>
+void nbs::forces::fmm::calculate_forces(
+    IN OUT ParticleType* particles,
+    IN OUT FMMBuffers<Dimensions, Options> buffers,
+    parallel::ThreadPool*                  pool /*= nullptr*/
+) {
+    static_assert(Options.tree_depth >= 2, "FMM needs a tree of at least depth two.");
+    static_assert(Options.expansion_order >= 1, "FMM needs at least dipole terms.");
+
+    using Shape  = detail::TreeShape<Dimensions, Options>;
+    using Coeffs = std::array<NBS_PRECISION, Shape::coefficient_count>;
+    using Coords = vec<Dimensions, i32>;
+
+    constexpr size_t Order       = Options.expansion_order;
+    constexpr size_t Depth       = Options.tree_depth;
+    constexpr auto&  table       = detail::multi_index_table<Dimensions, Order>;
+    constexpr size_t coeff_count = Shape::coefficient_count;
+
+    /************
+       Determine a cubic domain enclosing every particle.
+                                                ************/
+
+    vec<Dimensions, NBS_PRECISION> domain_min = particles[0].position;
+    vec<Dimensions, NBS_PRECISION> domain_max = particles[0].position;
+    for (size_t particle_idx = 1; particle_idx < Options.particle_count; ++particle_idx)
+    {
+        domain_min = math::min(domain_min, particles[particle_idx].position);
+        domain_max = math::max(domain_max, particles[particle_idx].position);
+    }
+
+    NBS_PRECISION domain_size = 0;
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        domain_size = std::max(domain_size, domain_max[dim] - domain_min[dim]);
+    }
+    // Pad so particles on the upper boundary still fall inside the last leaf.
+    constexpr NBS_PRECISION DOMAIN_PADDING = 1.0001;
+    domain_size                            = std::max(
+        domain_size * DOMAIN_PADDING, std::numeric_limits<NBS_PRECISION>::min()
+    );
+
+    auto cell_size = [domain_size](size_t level) {
+        return domain_size / static_cast<NBS_PRECISION>(Shape::cells_on_axis(level));
+    };
+
+    auto cell_centre = [&](size_t cell_idx, size_t level) {
+        auto coords = detail::cell_coords<Dimensions>(cell_idx, level);
+
+        vec<Dimensions, NBS_PRECISION> centre;
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            centre[dim] = domain_min[dim]
+                          + (static_cast<NBS_PRECISION>(2 * coords[dim] + 1) / 2)
+                                * cell_size(level);
+        }
+        return centre;
+    };
+
+    auto multipole = [&](size_t cell_idx, size_t level) {
+        size_t cell_offset = Shape::level_offset(level) + cell_idx;
+        return buffers.multipoles + cell_offset * coeff_count;
+    };
+
+    auto local = [&](size_t cell_idx, size_t level) {
+        size_t cell_offset = Shape::level_offset(level) + cell_idx;
+        return buffers.locals + cell_offset * coeff_count;
+    };
+
+    auto child_coords = [](const Coords& parent_coords, size_t child) {
+        Coords coords;
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            coords[dim] = 2 * parent_coords[dim] + static_cast<i32>((child >> dim) & 1);
+        }
+        return coords;
+    };
+
+    /************
+       Bin particles into leaves.
+                        ************/
+
+    std::fill_n(buffers.leaf_offsets, Shape::leaf_count + 1, 0);
+
+    for (size_t particle_idx = 0; particle_idx < Options.particle_count; ++particle_idx)
+    {
+        Coords coords;
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            coords[dim] = std::clamp(
+                static_cast<i32>(
+                    (particles[particle_idx].position[dim] - domain_min[dim])
+                    / cell_size(Depth)
+                ),
+                0,
+                static_cast<i32>(Shape::cells_on_axis(Depth)) - 1
+            );
+        }
+
+        auto leaf_idx = detail::cell_index<Dimensions>(coords, Depth);
+
+        buffers.particle_leaf[particle_idx] = static_cast<ui32>(leaf_idx);
+        ++buffers.leaf_offsets[leaf_idx + 1];
+    }
+
+    for (size_t leaf_idx = 0; leaf_idx < Shape::leaf_count; ++leaf_idx) {
+        buffers.leaf_offsets[leaf_idx + 1] += buffers.leaf_offsets[leaf_idx];
+    }
+
+    std::copy_n(buffers.leaf_offsets, Shape::leaf_count, buffers.leaf_cursors);
+    for (ui32 particle_idx = 0; particle_idx < Options.particle_count; ++particle_idx) {
+        ui32& cursor = buffers.leaf_cursors[buffers.particle_leaf[particle_idx]];
+        buffers.particle_order[cursor++] = particle_idx;
+    }
+
+    /************
+       P2M: form multipoles of leaves from their particles.
+                                                  ************/
+
+    auto particles_to_multipole = [&](size_t leaf_idx) {
+        NBS_PRECISION* M = multipole(leaf_idx, Depth);
+        std::fill_n(M, coeff_count, 0);
+
+        const auto centre = cell_centre(leaf_idx, Depth);
+
+        Coeffs monomials;
+        for (ui32 order_idx = buffers.leaf_offsets[leaf_idx];
+             order_idx < buffers.leaf_offsets[leaf_idx + 1];
+             ++order_idx)
+        {
+            const ParticleType& particle = particles[buffers.particle_order[order_idx]];
+
+            detail::scaled_monomials<Dimensions, Order>(
+                centre - particle.position, monomials.data()
+            );
+
+            const NBS_PRECISION mass = mass_of(particle);
+            for (size_t n = 0; n < coeff_count; ++n) M[n] += mass * monomials[n];
+        }
+    };
+
+    parallel::parallel_for(
+        pool, 0, Shape::leaf_count, Options.grain, particles_to_multipole
+    );
+
+    /************
+       M2M: shift child multipoles into their parents, level by level upward.
+                                                                    ************/
+
+    for (size_t level = Depth; level-- > 2;) {
+        auto multipole_to_multipole = [&](size_t cell_idx) {
+            NBS_PRECISION* M = multipole(cell_idx, level);
+            std::fill_n(M, coeff_count, 0);
+
+            const auto centre = cell_centre(cell_idx, level);
+            const auto coords = detail::cell_coords<Dimensions>(cell_idx, level);
+
+            Coeffs monomials;
+            for (size_t child = 0; child < Shape::children_per_cell; ++child) {
+                size_t child_idx = detail::cell_index<Dimensions>(
+                    child_coords(coords, child), level + 1
+                );
+                const NBS_PRECISION* child_M = multipole(child_idx, level + 1);
+
+                if (child_M[0] == 0) continue;
+
+                detail::scaled_monomials<Dimensions, Order>(
+                    centre - cell_centre(child_idx, level + 1), monomials.data()
+                );
+
+                // M_(k + j) += M_child_k (centre - child_centre)^j / j!
+                for (size_t k = 0; k < coeff_count; ++k) {
+                    for (size_t j = 0; j < coeff_count; ++j) {
+                        i32 n = table.sum[k][j];
+                        if (n < 0) continue;
+
+                        M[n] += child_M[k] * monomials[j];
+                    }
+                }
+            }
+        };
+
+        parallel::parallel_for(
+            pool, 0, Shape::cell_count(level), Options.grain, multipole_to_multipole
+        );
+    }
+
+    /************
+       L2L + M2L: pass locals down from parents and add interaction list
+       contributions, level by level downward.
+                                        ************/
+
+    for (size_t level = 2; level <= Depth; ++level) {
+        auto local_from_parent_and_interaction_list = [&](size_t cell_idx) {
+            NBS_PRECISION* L = local(cell_idx, level);
+            std::fill_n(L, coeff_count, 0);
+
+            const auto centre = cell_centre(cell_idx, level);
+            const auto coords = detail::cell_coords<Dimensions>(cell_idx, level);
+
+            Coords parent_coords;
+            for (size_t dim = 0; dim < Dimensions; ++dim)
+                parent_coords[dim] = coords[dim] >> 1;
+
+            // L2L: L_k += L_parent_(k + j) (centre - parent_centre)^j / j!
+            if (level > 2) {
+                size_t parent_idx
+                    = detail::cell_index<Dimensions>(parent_coords, level - 1);
+                const NBS_PRECISION* parent_L = local(parent_idx, level - 1);
+
+                Coeffs monomials;
+                detail::scaled_monomials<Dimensions, Order>(
+                    centre - cell_centre(parent_idx, level - 1), monomials.data()
+                );
+
+                for (size_t k = 0; k < coeff_count; ++k) {
+                    for (size_t j = 0; j < coeff_count; ++j) {
+                        i32 n = table.sum[k][j];
+                        if (n < 0) continue;
+
+                        L[k] += parent_L[n] * monomials[j];
+                    }
+                }
+            }
+
+            // M2L over the interaction list, i.e. children of the parent's neighbours
+            // that are not themselves neighbours of this cell:
+            //     L_m += M_n D^(n + m) (1 / |centre - source_centre|)
+            Coeffs derivatives;
+            auto   add_source_cell = [&](const Coords& source_coords) {
+                size_t source_idx
+                    = detail::cell_index<Dimensions>(source_coords, level);
+                const NBS_PRECISION* M = multipole(source_idx, level);
+
+                if (M[0] == 0) return;
+
+                detail::inverse_distance_derivatives<Dimensions, Order>(
+                    centre - cell_centre(source_idx, level), derivatives.data()
+                );
+
+                for (size_t n = 0; n < coeff_count; ++n) {
+                    if (M[n] == 0) continue;
+
+                    for (size_t m = 0; m < coeff_count; ++m) {
+                        i32 s = table.sum[n][m];
+                        if (s < 0) continue;
+
+                        L[m] += M[n] * derivatives[s];
+                    }
+                }
+            };
+
+            detail::for_each_adjacent_offset<Dimensions>([&](const Coords& offset) {
+                Coords neighbour_parent = parent_coords + offset;
+                if (!detail::cell_in_bounds<Dimensions>(neighbour_parent, level - 1))
+                    return;
+
+                for (size_t child = 0; child < Shape::children_per_cell; ++child) {
+                    Coords source_coords = child_coords(neighbour_parent, child);
+
+                    bool well_separated = false;
+                    for (size_t dim = 0; dim < Dimensions; ++dim) {
+                        if (std::abs(source_coords[dim] - coords[dim]) > 1)
+                            well_separated = true;
+                    }
+
+                    if (well_separated) add_source_cell(source_coords);
+                }
+            });
+        };
+
+        parallel::parallel_for(
+            pool,
+            0,
+            Shape::cell_count(level),
+            Options.grain,
+            local_from_parent_and_interaction_list
+        );
+    }
+
+    /************
+       L2P + P2P: evaluate local expansions at particles and sum neighbouring leaves
+       directly.
+            ************/
+
+    const NBS_PRECISION softening_2 = Options.softening * Options.softening;
+
+    auto local_and_near_field_to_particles = [&](size_t leaf_idx) {
+        const NBS_PRECISION* L      = local(leaf_idx, Depth);
+        const auto           centre = cell_centre(leaf_idx, Depth);
+        const auto           coords = detail::cell_coords<Dimensions>(leaf_idx, Depth);
+
+        Coeffs monomials;
+        for (ui32 order_idx = buffers.leaf_offsets[leaf_idx];
+             order_idx < buffers.leaf_offsets[leaf_idx + 1];
+             ++order_idx)
+        {
+            ParticleType& particle = particles[buffers.particle_order[order_idx]];
+
+            // L2P: d/dz_i sum_m L_m z^m / m! = sum_k L_(k + e_i) z^k / k!
+            detail::scaled_monomials<Dimensions, Order>(
+                particle.position - centre, monomials.data()
+            );
+
+            vec<Dimensions, NBS_PRECISION> field{};
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                for (size_t k = 0; k < coeff_count; ++k) {
+                    i32 m = table.sum[k][table.unit[dim]];
+                    if (m < 0) continue;
+
+                    field[dim] += L[m] * monomials[k];
+                }
+            }
+
+            // P2P over this and adjacent leaves.
+            auto add_source_leaf = [&](size_t source_idx) {
+                for (ui32 source_order_idx = buffers.leaf_offsets[source_idx];
+                     source_order_idx < buffers.leaf_offsets[source_idx + 1];
+                     ++source_order_idx)
+                {
+                    if (source_order_idx == order_idx) continue;
+
+                    const ParticleType& source
+                        = particles[buffers.particle_order[source_order_idx]];
+
+                    vec<Dimensions, NBS_PRECISION> displacement
+                        = source.position - particle.position;
+                    NBS_PRECISION distance_2
+                        = math::dot(displacement, displacement) + softening_2;
+
+                    if (distance_2 == 0) continue;
+
+                    NBS_PRECISION inverse_distance
+                        = static_cast<NBS_PRECISION>(1) / math::sqrt(distance_2);
+
+                    field += displacement
+                             * (mass_of(source) * inverse_distance * inverse_distance
+                                * inverse_distance);
+                }
+            };
+
+            detail::for_each_adjacent_offset<Dimensions>([&](const Coords& offset) {
+                Coords source_coords = coords + offset;
+                if (!detail::cell_in_bounds<Dimensions>(source_coords, Depth)) return;
+
+                add_source_leaf(detail::cell_index<Dimensions>(source_coords, Depth));
+            });
+
+            particle.force = field * mass_of(particle);
+        }
+    };
+
+    parallel::parallel_for(
+        pool, 0, Shape::leaf_count, Options.grain, local_and_near_field_to_particles
+    );
+}
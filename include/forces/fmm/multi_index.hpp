@@ -0,0 +1,75 @@
+#ifndef N_BODY_SIM_FORCES_FMM_MULTI_INDEX_HPP
+#define N_BODY_SIM_FORCES_FMM_MULTI_INDEX_HPP
+
+#pragma once
+
+namespace nbs {
+    namespace forces {
+        namespace fmm {
+            namespace detail {
+                constexpr size_t binomial(size_t n, size_t k) {
+                    size_t result = 1;
+                    for (size_t i = 1; i <= k; ++i) result = result * (n - k + i) / i;
+                    return result;
+                }
+
+                constexpr size_t integer_pow(size_t base, size_t exponent) {
+                    size_t result = 1;
+                    for (size_t i = 0; i < exponent; ++i) result *= base;
+                    return result;
+                }
+
+                /**
+                 * \brief Tables describing every multi-index n with |n| <= Order in
+                 * Dimensions dimensions, in graded order, along with the index
+                 * arithmetic the expansion operators need.
+                 */
+                template <size_t Dimensions, size_t Order>
+                struct MultiIndexTable {
+                    static constexpr size_t size
+                        = binomial(Order + Dimensions, Dimensions);
+
+                    std::array<std::array<ui32, Dimensions>, size> exponents;
+                    std::array<ui32, size>                         order;
+                    // Index of n - e_i, or -1 if n_i < 1.
+                    std::array<std::array<i32, Dimensions>, size> minus_one;
+                    // Index of n - 2e_i, or -1 if n_i < 2.
+                    std::array<std::array<i32, Dimensions>, size> minus_two;
+                    // Index of e_i.
+                    std::array<i32, Dimensions> unit;
+                    // Index of n + m, or -1 if |n + m| > Order.
+                    std::array<std::array<i32, size>, size> sum;
+                };
+
+                template <size_t Dimensions, size_t Order>
+                constexpr MultiIndexTable<Dimensions, Order> make_multi_index_table();
+
+                template <size_t Dimensions, size_t Order>
+                inline constexpr MultiIndexTable<Dimensions, Order> multi_index_table
+                    = make_multi_index_table<Dimensions, Order>();
+
+                /**
+                 * \brief Evaluates d^n / n! for each multi-index n.
+                 */
+                template <size_t Dimensions, size_t Order>
+                void scaled_monomials(
+                    const vec<Dimensions, NBS_PRECISION>& d,
+                    OUT NBS_PRECISION*                    monomials
+                );
+
+                /**
+                 * \brief Evaluates D^n (1 / |r|) for each multi-index n.
+                 */
+                template <size_t Dimensions, size_t Order>
+                void inverse_distance_derivatives(
+                    const vec<Dimensions, NBS_PRECISION>& r,
+                    OUT NBS_PRECISION*                    derivatives
+                );
+            }  // namespace detail
+        }      // namespace fmm
+    }          // namespace forces
+}  // namespace nbs
+
+#include "multi_index.inl"
+
+#endif  // N_BODY_SIM_FORCES_FMM_MULTI_INDEX_HPP
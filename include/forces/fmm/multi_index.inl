@@ -0,0 +1,141 @@
+template <size_t Dimensions, size_t Order>
+constexpr nbs::forces::fmm::detail::MultiIndexTable<Dimensions, Order>
+nbs::forces::fmm::detail::make_multi_index_table() {
+    using Table = MultiIndexTable<Dimensions, Order>;
+
+    Table table{};
+
+    // Dense lookup from the base-(Order + 1) encoding of a multi-index to its index
+    // in the graded ordering.
+    constexpr size_t dense_size = integer_pow(Order + 1, Dimensions);
+    std::array<i32, dense_size> dense{};
+
+    auto encode = [](const std::array<ui32, Dimensions>& exponents) {
+        size_t code = 0;
+        for (size_t dim = Dimensions; dim-- > 0;) {
+            code = code * (Order + 1) + exponents[dim];
+        }
+        return code;
+    };
+
+    /************
+       Enumerate multi-indices grade by grade.
+                                     ************/
+
+    size_t next_idx = 0;
+    for (ui32 grade = 0; grade <= Order; ++grade) {
+        for (size_t code = 0; code < dense_size; ++code) {
+            std::array<ui32, Dimensions> exponents{};
+
+            size_t remainder = code;
+            ui32   total     = 0;
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                exponents[dim]  = static_cast<ui32>(remainder % (Order + 1));
+                remainder      /= Order + 1;
+                total          += exponents[dim];
+            }
+
+            if (total != grade) continue;
+
+            table.exponents[next_idx] = exponents;
+            table.order[next_idx]     = grade;
+            dense[code]               = static_cast<i32>(next_idx);
+            ++next_idx;
+        }
+    }
+
+    /************
+       Build index arithmetic tables.
+                            ************/
+
+    for (size_t idx = 0; idx < Table::size; ++idx) {
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            auto exponents = table.exponents[idx];
+
+            table.minus_one[idx][dim] = -1;
+            table.minus_two[idx][dim] = -1;
+
+            if (exponents[dim] >= 1) {
+                exponents[dim]           -= 1;
+                table.minus_one[idx][dim] = dense[encode(exponents)];
+            }
+            if (exponents[dim] >= 1) {
+                exponents[dim]           -= 1;
+                table.minus_two[idx][dim] = dense[encode(exponents)];
+            }
+        }
+
+        for (size_t other_idx = 0; other_idx < Table::size; ++other_idx) {
+            table.sum[idx][other_idx] = -1;
+
+            if (table.order[idx] + table.order[other_idx] > Order) continue;
+
+            std::array<ui32, Dimensions> exponents{};
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                exponents[dim]
+                    = table.exponents[idx][dim] + table.exponents[other_idx][dim];
+            }
+
+            table.sum[idx][other_idx] = dense[encode(exponents)];
+        }
+    }
+
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        std::array<ui32, Dimensions> exponents{};
+        exponents[dim]  = 1;
+        table.unit[dim] = Order >= 1 ? dense[encode(exponents)] : -1;
+    }
+
+    return table;
+}
+
+template <size_t Dimensions, size_t Order>
+void nbs::forces::fmm::detail::scaled_monomials(
+    const vec<Dimensions, NBS_PRECISION>& d, OUT NBS_PRECISION* monomials
+) {
+    constexpr auto& table = multi_index_table<Dimensions, Order>;
+
+    // d^n / n! = d^(n - e_i) / (n - e_i)! * d_i / n_i for any i with n_i >= 1.
+    monomials[0] = static_cast<NBS_PRECISION>(1);
+    for (size_t idx = 1; idx < table.size; ++idx) {
+        size_t dim = 0;
+        while (table.exponents[idx][dim] == 0) ++dim;
+
+        monomials[idx] = monomials[table.minus_one[idx][dim]] * d[dim]
+                         / static_cast<NBS_PRECISION>(table.exponents[idx][dim]);
+    }
+}
+
+template <size_t Dimensions, size_t Order>
+void nbs::forces::fmm::detail::inverse_distance_derivatives(
+    const vec<Dimensions, NBS_PRECISION>& r, OUT NBS_PRECISION* derivatives
+) {
+    constexpr auto& table = multi_index_table<Dimensions, Order>;
+
+    const NBS_PRECISION distance_2 = math::dot(r, r);
+
+    derivatives[0] = static_cast<NBS_PRECISION>(1) / math::sqrt(distance_2);
+
+    // Recurrence for derivatives of 1/r:
+    //     |n| r^2 D^n = -(2|n| - 1) sum_i n_i r_i D^(n - e_i)
+    //                   - (|n| - 1) sum_i n_i (n_i - 1) D^(n - 2e_i)
+    for (size_t idx = 1; idx < table.size; ++idx) {
+        const auto grade = static_cast<NBS_PRECISION>(table.order[idx]);
+
+        NBS_PRECISION value = 0;
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            const auto n = static_cast<NBS_PRECISION>(table.exponents[idx][dim]);
+
+            if (table.minus_one[idx][dim] >= 0) {
+                value -= (2 * grade - 1) * n * r[dim]
+                         * derivatives[table.minus_one[idx][dim]];
+            }
+            if (table.minus_two[idx][dim] >= 0) {
+                value -= (grade - 1) * n * (n - 1)
+                         * derivatives[table.minus_two[idx][dim]];
+            }
+        }
+
+        derivatives[idx] = value / (grade * distance_2);
+    }
+}
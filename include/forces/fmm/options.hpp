@@ -0,0 +1,26 @@
+#ifndef N_BODY_SIM_FORCES_FMM_OPTIONS_HPP
+#define N_BODY_SIM_FORCES_FMM_OPTIONS_HPP
+
+#pragma once
+
+namespace nbs {
+    namespace forces {
+        namespace fmm {
+            struct FMMOptions {
+                ui32 particle_count = 1000;
+                // Highest total order of the Cartesian Taylor expansions, accuracy
+                // improves roughly geometrically with order.
+                ui32 expansion_order = 4;
+                // Depth of the uniform tree, leaves are at this level and hold
+                // roughly particle_count / 2^(Dimensions * tree_depth) particles.
+                ui32 tree_depth = 4;
+                // Plummer softening length applied in leaf-to-leaf direct sums.
+                NBS_PRECISION softening = 0.0;
+                // Number of cells handed to a thread at a time.
+                ui32 grain = 8;
+            };
+        }  // namespace fmm
+    }      // namespace forces
+}  // namespace nbs
+
+#endif  // N_BODY_SIM_FORCES_FMM_OPTIONS_HPP
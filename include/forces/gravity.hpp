@@ -5,16 +5,48 @@
 
 namespace nbs {
     namespace forces {
+        namespace detail {
+            // Newton's method, for constants that std::sqrt can't yet produce at
+            // compile time.
+            constexpr f64 constexpr_sqrt(f64 x) {
+                if (!(x > 0)) return 0;
+
+                f64 estimate = x > 1 ? x : 1;
+                for (ui32 iteration = 0; iteration < 128; ++iteration) {
+                    const f64 next = 0.5 * (estimate + x / estimate);
+                    if (next >= estimate) break;
+                    estimate = next;
+                }
+                return estimate;
+            }
+
+            // -tightness / r^2 + 1 / r^6 peaks at -2 / 3^1.5 tightness^1.5, which
+            // this normalises to an attraction of one.
+            template <size_t Tightness>
+            constexpr f64 repulsion_6_normalisation
+                = 1.0
+                  / (static_cast<f64>(Tightness) * constexpr_sqrt(Tightness)
+                     * -0.384900179459);
+        }  // namespace detail
+
+        // Force laws give the magnitude of the force on a particle along the unit
+        // vector towards the other particle of the pair, positive is attractive.
+
         inline NBS_PRECISION grav(NBS_PRECISION distance_2) {
-            return -1.0 / distance_2;
+            return 1.0 / distance_2;
         }
 
         template <size_t Tightness>
         inline NBS_PRECISION grav_with_repulsion_6(NBS_PRECISION distance_2) {
-            const NBS_PRECISION tightness = static_cast<NBS_PRECISION>(Tightness);
+            constexpr NBS_PRECISION tightness = static_cast<NBS_PRECISION>(Tightness);
+            constexpr NBS_PRECISION normalisation = static_cast<NBS_PRECISION>(
+                detail::repulsion_6_normalisation<Tightness>
+            );
+
+            const NBS_PRECISION inverse_distance_2 = 1 / distance_2;
 
-            return (-tightness / distance_2 + 1 / math::pow(distance_2, 3))
-                   / (math::pow(tightness, 1.5) * -0.384900179459);
+            return (-tightness + inverse_distance_2 * inverse_distance_2)
+                   * inverse_distance_2 * normalisation;
         }
     }  // namespace forces
 }  // namespace nbs
@@ -0,0 +1,585 @@
+#ifndef N_BODY_SIM_FORCES_LAWS_HPP
+#define N_BODY_SIM_FORCES_LAWS_HPP
+
+#pragma once
+
+#include "forces/gravity.hpp"
+
+namespace nbs {
+    namespace forces {
+        namespace detail {
+#if defined(NBS_SIMD_AVX2)
+            // Vector types can't be template arguments without losing their
+            // attributes, so check by assignment rather than with std::same_as.
+            template <typename Candidate>
+            concept BatchForceLaw
+                = requires (__m256 distance_2, __m256& scale) {
+                      scale = Candidate::scale(distance_2);
+                  };
+
+            template <typename Candidate>
+            concept BatchPotentialLaw
+                = requires (__m256 distance_2, __m256& potential) {
+                      potential = Candidate::potential(distance_2);
+                  };
+#else
+            template <typename Candidate>
+            concept BatchForceLaw = true;
+
+            template <typename Candidate>
+            concept BatchPotentialLaw = true;
+#endif
+
+            // Where the repulsion of GravityWithRepulsion6 falls to 1e-3 of its
+            // attraction.
+            template <size_t Tightness>
+            constexpr NBS_PRECISION repulsion_6_cutoff
+                = constexpr_sqrt(constexpr_sqrt(1000.0 / Tightness));
+        }  // namespace detail
+
+        /**
+         * \brief A force law as a policy type, for solvers and kernels to inline.
+         *
+         * magnitude(distance_2) follows the convention of the force functions in
+         * forces/gravity.hpp, while scale(distance_2) gives magnitude / distance, the
+         * factor taking the displacement between a pair to the force between them,
+         * and is zero beyond cutoff_radius. With SIMD enabled, scale must also take a
+         * batch of squared distances. Constants of a law should be folded at compile
+         * time, see ScalarLaw for adapting a plain function instead.
+         */
+        template <typename Candidate>
+        concept ForceLaw
+            = detail::BatchForceLaw<Candidate>
+              && requires (NBS_PRECISION distance_2) {
+                     {
+                         Candidate::magnitude(distance_2)
+                         } -> std::same_as<NBS_PRECISION>;
+                     {
+                         Candidate::scale(distance_2)
+                         } -> std::same_as<NBS_PRECISION>;
+                     {
+                         Candidate::cutoff_radius
+                         } -> std::convertible_to<NBS_PRECISION>;
+                 };
+
+        /**
+         * \brief A force law that also gives potential(distance_2), the potential
+         * energy of a pair of unit masses. It is zero at infinity, or for laws with a
+         * cutoff zero at cutoff_radius, so that it is the potential of the cut-off
+         * force. With SIMD enabled, potential must also take a batch.
+         */
+        template <typename Candidate>
+        concept PotentialLaw
+            = ForceLaw<Candidate> && detail::BatchPotentialLaw<Candidate>
+              && requires (NBS_PRECISION distance_2) {
+                     {
+                         Candidate::potential(distance_2)
+                         } -> std::same_as<NBS_PRECISION>;
+                 };
+
+        namespace laws {
+            constexpr NBS_PRECISION NO_CUTOFF
+                = std::numeric_limits<NBS_PRECISION>::infinity();
+
+            /************
+               Gravity.
+               ************/
+
+            // Newtonian gravity, 1 / r^2.
+            struct Gravity {
+                static constexpr NBS_PRECISION cutoff_radius = NO_CUTOFF;
+
+                static NBS_PRECISION magnitude(NBS_PRECISION distance_2) {
+                    return grav(distance_2);
+                }
+
+                static NBS_PRECISION scale(NBS_PRECISION distance_2) {
+                    const NBS_PRECISION inverse_distance
+                        = static_cast<NBS_PRECISION>(1) / math::sqrt(distance_2);
+
+                    return inverse_distance * inverse_distance * inverse_distance;
+                }
+
+                static NBS_PRECISION potential(NBS_PRECISION distance_2) {
+                    return static_cast<NBS_PRECISION>(-1) / math::sqrt(distance_2);
+                }
+
+#if defined(NBS_SIMD_AVX2)
+                static __m256 scale(__m256 distance_2) {
+                    const __m256 inverse_distance = simd::rsqrt(distance_2);
+
+                    return _mm256_mul_ps(
+                        inverse_distance,
+                        _mm256_mul_ps(inverse_distance, inverse_distance)
+                    );
+                }
+
+                static __m256 potential(__m256 distance_2) {
+                    return _mm256_sub_ps(_mm256_setzero_ps(), simd::rsqrt(distance_2));
+                }
+#endif
+            };
+
+            // Plummer-softened gravity, r / (r^2 + softening^2)^1.5.
+            template <NBS_PRECISION Softening>
+            struct PlummerGravity {
+                static constexpr NBS_PRECISION cutoff_radius = NO_CUTOFF;
+                static constexpr NBS_PRECISION softening_2   = Softening * Softening;
+
+                static NBS_PRECISION magnitude(NBS_PRECISION distance_2) {
+                    return scale(distance_2) * math::sqrt(distance_2);
+                }
+
+                static NBS_PRECISION scale(NBS_PRECISION distance_2) {
+                    const NBS_PRECISION inverse_distance
+                        = static_cast<NBS_PRECISION>(1)
+                          / math::sqrt(distance_2 + softening_2);
+
+                    return inverse_distance * inverse_distance * inverse_distance;
+                }
+
+                static NBS_PRECISION potential(NBS_PRECISION distance_2) {
+                    return static_cast<NBS_PRECISION>(-1)
+                           / math::sqrt(distance_2 + softening_2);
+                }
+
+#if defined(NBS_SIMD_AVX2)
+                static __m256 scale(__m256 distance_2) {
+                    const __m256 inverse_distance = simd::rsqrt(
+                        _mm256_add_ps(distance_2, _mm256_set1_ps(softening_2))
+                    );
+
+                    return _mm256_mul_ps(
+                        inverse_distance,
+                        _mm256_mul_ps(inverse_distance, inverse_distance)
+                    );
+                }
+
+                static __m256 potential(__m256 distance_2) {
+                    const __m256 inverse_distance = simd::rsqrt(
+                        _mm256_add_ps(distance_2, _mm256_set1_ps(softening_2))
+                    );
+
+                    return _mm256_sub_ps(_mm256_setzero_ps(), inverse_distance);
+                }
+#endif
+            };
+
+            // Gravity softened by the cubic spline kernel of Monaghan & Lattanzio,
+            // exactly Newtonian beyond 2.8 softening as used by GADGET.
+            template <NBS_PRECISION Softening>
+            struct SplineGravity {
+                static constexpr NBS_PRECISION cutoff_radius = NO_CUTOFF;
+                static constexpr NBS_PRECISION kernel_radius = 2.8 * Softening;
+                static constexpr NBS_PRECISION inverse_kernel_radius
+                    = 1 / kernel_radius;
+                static constexpr NBS_PRECISION inverse_kernel_radius_3
+                    = inverse_kernel_radius * inverse_kernel_radius
+                      * inverse_kernel_radius;
+
+                // Coefficients of the force in u = r / kernel_radius, within and
+                // beyond half the kernel radius.
+                static constexpr NBS_PRECISION inner_0       = 32.0 / 3.0;
+                static constexpr NBS_PRECISION inner_2       = -38.4;
+                static constexpr NBS_PRECISION inner_3       = 32.0;
+                static constexpr NBS_PRECISION outer_0       = 64.0 / 3.0;
+                static constexpr NBS_PRECISION outer_1       = -48.0;
+                static constexpr NBS_PRECISION outer_2       = 38.4;
+                static constexpr NBS_PRECISION outer_3       = -32.0 / 3.0;
+                static constexpr NBS_PRECISION outer_minus_3 = -1.0 / 15.0;
+
+                static NBS_PRECISION magnitude(NBS_PRECISION distance_2) {
+                    return scale(distance_2) * math::sqrt(distance_2);
+                }
+
+                static NBS_PRECISION scale(NBS_PRECISION distance_2) {
+                    const NBS_PRECISION distance = math::sqrt(distance_2);
+
+                    if (distance >= kernel_radius) {
+                        return 1 / (distance_2 * distance);
+                    }
+
+                    const NBS_PRECISION u   = distance * inverse_kernel_radius;
+                    const NBS_PRECISION u_2 = u * u;
+                    const NBS_PRECISION u_3 = u_2 * u;
+
+                    if (2 * u < 1) {
+                        return inverse_kernel_radius_3
+                               * (inner_0 + inner_2 * u_2 + inner_3 * u_3);
+                    }
+
+                    return inverse_kernel_radius_3
+                           * (outer_0 + outer_1 * u + outer_2 * u_2 + outer_3 * u_3
+                              + outer_minus_3 / u_3);
+                }
+
+#if defined(NBS_SIMD_AVX2)
+                static __m256 scale(__m256 distance_2) {
+                    const __m256 distance = _mm256_sqrt_ps(distance_2);
+                    const __m256 u        = _mm256_mul_ps(
+                        distance, _mm256_set1_ps(inverse_kernel_radius)
+                    );
+                    const __m256 u_2      = _mm256_mul_ps(u, u);
+                    const __m256 u_3      = _mm256_mul_ps(u_2, u);
+
+                    __m256 inner = _mm256_set1_ps(inner_0);
+                    inner        = _mm256_add_ps(
+                        inner, _mm256_mul_ps(_mm256_set1_ps(inner_2), u_2)
+                    );
+                    inner = _mm256_add_ps(
+                        inner, _mm256_mul_ps(_mm256_set1_ps(inner_3), u_3)
+                    );
+
+                    __m256 outer_shell = _mm256_set1_ps(outer_0);
+                    outer_shell        = _mm256_add_ps(
+                        outer_shell, _mm256_mul_ps(_mm256_set1_ps(outer_1), u)
+                    );
+                    outer_shell = _mm256_add_ps(
+                        outer_shell, _mm256_mul_ps(_mm256_set1_ps(outer_2), u_2)
+                    );
+                    outer_shell = _mm256_add_ps(
+                        outer_shell, _mm256_mul_ps(_mm256_set1_ps(outer_3), u_3)
+                    );
+                    outer_shell = _mm256_add_ps(
+                        outer_shell, _mm256_div_ps(_mm256_set1_ps(outer_minus_3), u_3)
+                    );
+
+                    const __m256 within_kernel = _mm256_mul_ps(
+                        _mm256_set1_ps(inverse_kernel_radius_3),
+                        _mm256_blendv_ps(
+                            outer_shell,
+                            inner,
+                            _mm256_cmp_ps(u, _mm256_set1_ps(0.5f), _CMP_LT_OQ)
+                        )
+                    );
+
+                    const __m256 newtonian = _mm256_div_ps(
+                        _mm256_set1_ps(1.0f), _mm256_mul_ps(distance_2, distance)
+                    );
+
+                    return _mm256_blendv_ps(
+                        newtonian,
+                        within_kernel,
+                        _mm256_cmp_ps(u, _mm256_set1_ps(1.0f), _CMP_LT_OQ)
+                    );
+                }
+#endif
+            };
+
+            // Short-range part of gravity split at scale SplitScale, with the
+            // long-range part erf(r / 2 r_s) / r^2 left to a mesh. Cut off at
+            // CutoffRadius, by default 4.5 r_s as in GADGET, where the short-range
+            // part has fallen below 2% of Newtonian.
+            template <
+                NBS_PRECISION SplitScale,
+                NBS_PRECISION CutoffRadius = SplitScale * 9 / 2>
+            struct EwaldShortRange {
+                static constexpr NBS_PRECISION cutoff_radius   = CutoffRadius;
+                static constexpr NBS_PRECISION cutoff_radius_2 = CutoffRadius
+                                                                 * CutoffRadius;
+                static constexpr NBS_PRECISION inverse_twice_split_scale
+                    = 1 / (2 * SplitScale);
+                static constexpr NBS_PRECISION two_over_sqrt_pi
+                    = 2 * std::numbers::inv_sqrtpi;
+
+                // Coefficients of the erfc approximation of Abramowitz & Stegun
+                // 7.1.26, absolute error below 1.5e-7.
+                static constexpr NBS_PRECISION erfc_p = 0.3275911;
+                static constexpr NBS_PRECISION erfc_1 = 0.254829592;
+                static constexpr NBS_PRECISION erfc_2 = -0.284496736;
+                static constexpr NBS_PRECISION erfc_3 = 1.421413741;
+                static constexpr NBS_PRECISION erfc_4 = -1.453152027;
+                static constexpr NBS_PRECISION erfc_5 = 1.061405429;
+
+                static NBS_PRECISION magnitude(NBS_PRECISION distance_2) {
+                    return scale(distance_2) * math::sqrt(distance_2);
+                }
+
+                static NBS_PRECISION scale(NBS_PRECISION distance_2) {
+                    if (distance_2 >= cutoff_radius_2) return 0;
+
+                    const NBS_PRECISION distance = math::sqrt(distance_2);
+                    const NBS_PRECISION u        = distance * inverse_twice_split_scale;
+                    const NBS_PRECISION gaussian = std::exp(-u * u);
+
+                    const NBS_PRECISION t = 1 / (1 + erfc_p * u);
+                    const NBS_PRECISION polynomial
+                        = erfc_1
+                          + t * (erfc_2 + t * (erfc_3 + t * (erfc_4 + t * erfc_5)));
+                    const NBS_PRECISION erfc = t * polynomial * gaussian;
+
+                    // erfc(u) + 2u exp(-u^2) / sqrt(pi), over r^3.
+                    return (erfc + two_over_sqrt_pi * u * gaussian)
+                           / (distance_2 * distance);
+                }
+
+#if defined(NBS_SIMD_AVX2)
+                // No vector exp in AVX2, so batches are evaluated a lane at a time.
+                static __m256 scale(__m256 distance_2) {
+                    alignas(32) f32 lanes[simd::f32_width];
+                    _mm256_store_ps(lanes, distance_2);
+
+                    for (size_t lane = 0; lane < simd::f32_width; ++lane) {
+                        lanes[lane] = scale(lanes[lane]);
+                    }
+
+                    return _mm256_load_ps(lanes);
+                }
+#endif
+            };
+
+            /************
+               Repulsive laws.
+                   ************/
+
+            // Gravity with a 1 / r^6 repulsion at short range, normalised to a peak
+            // attraction of one.
+            template <size_t Tightness>
+            struct GravityWithRepulsion6 {
+                static constexpr NBS_PRECISION cutoff_radius = NO_CUTOFF;
+                static constexpr NBS_PRECISION tightness = Tightness;
+                static constexpr NBS_PRECISION normalisation
+                    = detail::repulsion_6_normalisation<Tightness>;
+
+                static NBS_PRECISION magnitude(NBS_PRECISION distance_2) {
+                    return grav_with_repulsion_6<Tightness>(distance_2);
+                }
+
+                static NBS_PRECISION scale(NBS_PRECISION distance_2) {
+                    const NBS_PRECISION inverse_distance_2 = 1 / distance_2;
+
+                    return (-tightness + inverse_distance_2 * inverse_distance_2)
+                           * inverse_distance_2 * normalisation
+                           * math::sqrt(inverse_distance_2);
+                }
+
+                // Integral of the magnitude, tightness / r - 1 / 5 r^5 normalised.
+                static NBS_PRECISION potential(NBS_PRECISION distance_2) {
+                    const NBS_PRECISION inverse_distance_2 = 1 / distance_2;
+
+                    return (tightness - inverse_distance_2 * inverse_distance_2 / 5)
+                           * normalisation * math::sqrt(inverse_distance_2);
+                }
+
+#if defined(NBS_SIMD_AVX2)
+                static __m256 scale(__m256 distance_2) {
+                    const __m256 inverse_distance   = simd::rsqrt(distance_2);
+                    const __m256 inverse_distance_2
+                        = _mm256_mul_ps(inverse_distance, inverse_distance);
+
+                    return _mm256_mul_ps(
+                        _mm256_sub_ps(
+                            _mm256_mul_ps(inverse_distance_2, inverse_distance_2),
+                            _mm256_set1_ps(tightness)
+                        ),
+                        _mm256_mul_ps(
+                            _mm256_mul_ps(inverse_distance_2, inverse_distance),
+                            _mm256_set1_ps(normalisation)
+                        )
+                    );
+                }
+
+                static __m256 potential(__m256 distance_2) {
+                    const __m256 inverse_distance   = simd::rsqrt(distance_2);
+                    const __m256 inverse_distance_2
+                        = _mm256_mul_ps(inverse_distance, inverse_distance);
+
+                    return _mm256_mul_ps(
+                        _mm256_sub_ps(
+                            _mm256_set1_ps(tightness),
+                            _mm256_mul_ps(
+                                _mm256_mul_ps(inverse_distance_2, inverse_distance_2),
+                                _mm256_set1_ps(0.2f)
+                            )
+                        ),
+                        _mm256_mul_ps(inverse_distance, _mm256_set1_ps(normalisation))
+                    );
+                }
+#endif
+            };
+
+            // Repulsive part of GravityWithRepulsion6 alone, cut off at CutoffRadius,
+            // for summing over near neighbours while the attraction, Tightness
+            // times -normalisation times gravity, is left to a long-range solver.
+            template <
+                size_t        Tightness,
+                NBS_PRECISION CutoffRadius = detail::repulsion_6_cutoff<Tightness>>
+            struct Repulsion6 {
+                static constexpr NBS_PRECISION cutoff_radius   = CutoffRadius;
+                static constexpr NBS_PRECISION cutoff_radius_2 = CutoffRadius
+                                                                 * CutoffRadius;
+                static constexpr NBS_PRECISION normalisation
+                    = detail::repulsion_6_normalisation<Tightness>;
+                static constexpr NBS_PRECISION inverse_cutoff_radius_5
+                    = 1 / (cutoff_radius_2 * cutoff_radius_2 * CutoffRadius);
+
+                static NBS_PRECISION magnitude(NBS_PRECISION distance_2) {
+                    return scale(distance_2) * math::sqrt(distance_2);
+                }
+
+                static NBS_PRECISION scale(NBS_PRECISION distance_2) {
+                    if (distance_2 >= cutoff_radius_2) return 0;
+
+                    const NBS_PRECISION inverse_distance_2 = 1 / distance_2;
+
+                    return inverse_distance_2 * inverse_distance_2 * inverse_distance_2
+                           * normalisation * math::sqrt(inverse_distance_2);
+                }
+
+                // -1 / 5 r^5 normalised, shifted to zero at the cutoff.
+                static NBS_PRECISION potential(NBS_PRECISION distance_2) {
+                    if (distance_2 >= cutoff_radius_2) return 0;
+
+                    const NBS_PRECISION inverse_distance_2 = 1 / distance_2;
+                    const NBS_PRECISION inverse_distance_5
+                        = inverse_distance_2 * inverse_distance_2
+                          * math::sqrt(inverse_distance_2);
+
+                    return (inverse_cutoff_radius_5 - inverse_distance_5)
+                           * (normalisation / 5);
+                }
+
+#if defined(NBS_SIMD_AVX2)
+                static __m256 scale(__m256 distance_2) {
+                    const __m256 inverse_distance   = simd::rsqrt(distance_2);
+                    const __m256 inverse_distance_2
+                        = _mm256_mul_ps(inverse_distance, inverse_distance);
+
+                    const __m256 result = _mm256_mul_ps(
+                        _mm256_mul_ps(
+                            _mm256_mul_ps(inverse_distance_2, inverse_distance_2),
+                            _mm256_mul_ps(inverse_distance_2, inverse_distance)
+                        ),
+                        _mm256_set1_ps(normalisation)
+                    );
+
+                    return _mm256_and_ps(
+                        result,
+                        _mm256_cmp_ps(
+                            distance_2, _mm256_set1_ps(cutoff_radius_2), _CMP_LT_OQ
+                        )
+                    );
+                }
+
+                static __m256 potential(__m256 distance_2) {
+                    const __m256 inverse_distance   = simd::rsqrt(distance_2);
+                    const __m256 inverse_distance_2
+                        = _mm256_mul_ps(inverse_distance, inverse_distance);
+
+                    const __m256 result = _mm256_mul_ps(
+                        _mm256_sub_ps(
+                            _mm256_set1_ps(inverse_cutoff_radius_5),
+                            _mm256_mul_ps(
+                                _mm256_mul_ps(inverse_distance_2, inverse_distance_2),
+                                inverse_distance
+                            )
+                        ),
+                        _mm256_set1_ps(normalisation / 5)
+                    );
+
+                    return _mm256_and_ps(
+                        result,
+                        _mm256_cmp_ps(
+                            distance_2, _mm256_set1_ps(cutoff_radius_2), _CMP_LT_OQ
+                        )
+                    );
+                }
+#endif
+            };
+
+            // Lennard-Jones 12-6 interaction with well depth Epsilon and zero
+            // crossing at Sigma, cut off at CutoffRadius.
+            template <
+                NBS_PRECISION Epsilon,
+                NBS_PRECISION Sigma,
+                NBS_PRECISION CutoffRadius = Sigma * 5 / 2>
+            struct LennardJones {
+                static constexpr NBS_PRECISION cutoff_radius   = CutoffRadius;
+                static constexpr NBS_PRECISION cutoff_radius_2 = CutoffRadius
+                                                                 * CutoffRadius;
+                static constexpr NBS_PRECISION sigma_2         = Sigma * Sigma;
+                static constexpr NBS_PRECISION epsilon_24      = 24 * Epsilon;
+
+                static NBS_PRECISION magnitude(NBS_PRECISION distance_2) {
+                    return scale(distance_2) * math::sqrt(distance_2);
+                }
+
+                static NBS_PRECISION scale(NBS_PRECISION distance_2) {
+                    if (distance_2 >= cutoff_radius_2) return 0;
+
+                    const NBS_PRECISION ratio_2 = sigma_2 / distance_2;
+                    const NBS_PRECISION ratio_6 = ratio_2 * ratio_2 * ratio_2;
+
+                    // Attraction (sigma / r)^6 less repulsion 2 (sigma / r)^12.
+                    return epsilon_24 * ratio_6 * (1 - 2 * ratio_6) / distance_2;
+                }
+
+#if defined(NBS_SIMD_AVX2)
+                static __m256 scale(__m256 distance_2) {
+                    const __m256 inverse_distance_2
+                        = _mm256_div_ps(_mm256_set1_ps(1.0f), distance_2);
+                    const __m256 ratio_2
+                        = _mm256_mul_ps(_mm256_set1_ps(sigma_2), inverse_distance_2);
+                    const __m256 ratio_6
+                        = _mm256_mul_ps(ratio_2, _mm256_mul_ps(ratio_2, ratio_2));
+
+                    const __m256 result = _mm256_mul_ps(
+                        _mm256_mul_ps(_mm256_set1_ps(epsilon_24), ratio_6),
+                        _mm256_mul_ps(
+                            _mm256_sub_ps(
+                                _mm256_set1_ps(1.0f),
+                                _mm256_mul_ps(_mm256_set1_ps(2.0f), ratio_6)
+                            ),
+                            inverse_distance_2
+                        )
+                    );
+
+                    return _mm256_and_ps(
+                        result,
+                        _mm256_cmp_ps(
+                            distance_2, _mm256_set1_ps(cutoff_radius_2), _CMP_LT_OQ
+                        )
+                    );
+                }
+#endif
+            };
+
+            /************
+               User laws.
+               ************/
+
+            // Adapts a scalar force function, such as those in forces/gravity.hpp, to
+            // a law. Batches are evaluated a lane at a time, so prefer writing a law
+            // type for anything hot.
+            template <auto Magnitude, NBS_PRECISION CutoffRadius = NO_CUTOFF>
+            struct ScalarLaw {
+                static constexpr NBS_PRECISION cutoff_radius = CutoffRadius;
+
+                static NBS_PRECISION magnitude(NBS_PRECISION distance_2) {
+                    return Magnitude(distance_2);
+                }
+
+                static NBS_PRECISION scale(NBS_PRECISION distance_2) {
+                    if (!(distance_2 < CutoffRadius * CutoffRadius)) return 0;
+
+                    return Magnitude(distance_2) / math::sqrt(distance_2);
+                }
+
+#if defined(NBS_SIMD_AVX2)
+                static __m256 scale(__m256 distance_2) {
+                    alignas(32) f32 lanes[simd::f32_width];
+                    _mm256_store_ps(lanes, distance_2);
+
+                    for (size_t lane = 0; lane < simd::f32_width; ++lane) {
+                        lanes[lane] = scale(lanes[lane]);
+                    }
+
+                    return _mm256_load_ps(lanes);
+                }
+#endif
+            };
+        }  // namespace laws
+    }      // namespace forces
+}  // namespace nbs
+
+#endif  // N_BODY_SIM_FORCES_LAWS_HPP
@@ -0,0 +1,41 @@
+#ifndef N_BODY_SIM_FORCES_P3M_BUFFERS_HPP
+#define N_BODY_SIM_FORCES_P3M_BUFFERS_HPP
+
+#pragma once
+
+#include "forces/p3m/options.hpp"
+#include "forces/pm/buffers.hpp"
+#include "parallel/thread_pool.hpp"
+#include "spatial/cell_list.hpp"
+
+namespace nbs {
+    namespace forces {
+        namespace p3m {
+            template <size_t Dimensions, P3MOptions Options>
+            struct P3MBuffers {
+                pm::PMBuffers<Dimensions, Options.mesh> mesh;
+                spatial::CellList<Dimensions, short_range_cell_list_options<Options>>
+                    cell_list;
+            };
+
+            /**
+             * \brief Allocates buffers for the P3M solver. Forces must be calculated
+             * with the same pool given here.
+             */
+            template <size_t Dimensions, P3MOptions Options>
+            void allocate_p3m_buffers(
+                OUT CALLER_DELETE P3MBuffers<Dimensions, Options>& buffers,
+                parallel::ThreadPool*                              pool = nullptr
+            );
+
+            template <size_t Dimensions, P3MOptions Options>
+            void deallocate_p3m_buffers(
+                OUT CALLER_DELETE P3MBuffers<Dimensions, Options>& buffers
+            );
+        }  // namespace p3m
+    }      // namespace forces
+}  // namespace nbs
+
+#include "buffers.inl"
+
+#endif  // N_BODY_SIM_FORCES_P3M_BUFFERS_HPP
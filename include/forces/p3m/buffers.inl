@@ -0,0 +1,16 @@
+template <size_t Dimensions, nbs::forces::p3m::P3MOptions Options>
+void nbs::forces::p3m::allocate_p3m_buffers(
+    OUT CALLER_DELETE P3MBuffers<Dimensions, Options>& buffers,
+    parallel::ThreadPool*                              pool /*= nullptr*/
+) {
+    pm::allocate_pm_buffers<Dimensions, Options.mesh>(buffers.mesh, pool);
+    spatial::allocate_cell_list(buffers.cell_list);
+}
+
+template <size_t Dimensions, nbs::forces::p3m::P3MOptions Options>
+void nbs::forces::p3m::deallocate_p3m_buffers(
+    OUT CALLER_DELETE P3MBuffers<Dimensions, Options>& buffers
+) {
+    spatial::deallocate_cell_list(buffers.cell_list);
+    pm::deallocate_pm_buffers<Dimensions, Options.mesh>(buffers.mesh);
+}
@@ -0,0 +1,43 @@
+#ifndef N_BODY_SIM_FORCES_P3M_OPTIONS_HPP
+#define N_BODY_SIM_FORCES_P3M_OPTIONS_HPP
+
+#pragma once
+
+#include "forces/laws.hpp"
+#include "forces/pm/options.hpp"
+#include "spatial/options.hpp"
+
+namespace nbs {
+    namespace forces {
+        namespace p3m {
+            struct P3MOptions {
+                // Mesh calculating the long-range force, its split_scale sets where
+                // the force is split and must be non-zero.
+                pm::PMOptions mesh;
+                // Short-range forces are cut off at this many split scales.
+                NBS_PRECISION cutoff = 4.5;
+                // Most cells on each axis of the cell list finding short-range pairs.
+                ui32 max_cells_on_axis = 32;
+            };
+
+            template <P3MOptions Options>
+            using ShortRangeLaw = laws::EwaldShortRange<
+                Options.mesh.split_scale,
+                Options.mesh.split_scale * Options.cutoff>;
+
+            template <P3MOptions Options>
+            constexpr spatial::CellListOptions short_range_cell_list_options{
+                .particle_count          = Options.mesh.particle_count,
+                .cutoff_radius           = ShortRangeLaw<Options>::cutoff_radius,
+                .max_cells_on_axis       = Options.max_cells_on_axis,
+                .periodic                = Options.mesh.boundary
+                            == pm::Boundary::PERIODIC,
+                .box_size                = Options.mesh.box_size,
+                .neighbours_per_particle = 0,
+                .grain                   = Options.mesh.grain
+            };
+        }  // namespace p3m
+    }      // namespace forces
+}  // namespace nbs
+
+#endif  // N_BODY_SIM_FORCES_P3M_OPTIONS_HPP
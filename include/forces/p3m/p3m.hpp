@@ -0,0 +1,51 @@
+#ifndef N_BODY_SIM_FORCES_P3M_P3M_HPP
+#define N_BODY_SIM_FORCES_P3M_P3M_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "forces/p3m/buffers.hpp"
+#include "forces/p3m/options.hpp"
+#include "forces/pm/pm.hpp"
+#include "forces/short_range.hpp"
+#include "parallel/thread_pool.hpp"
+
+namespace nbs {
+    namespace forces {
+        namespace p3m {
+            /**
+             * \brief Calculates the Newtonian gravitational force on each particle
+             * with the particle-particle particle-mesh method. The force is split by
+             * a Gaussian of scale split_scale: the long-range part is calculated on
+             * the particle mesh, and the short-range part, ShortRangeLaw<Options>,
+             * summed directly over neighbours found with a cell list.
+             * Forces are attractive with G = 1 and particle masses from mass_of, and
+             * overwrite particle.force.
+             *
+             * Boundaries are as for the particle mesh alone, see forces/pm/pm.hpp.
+             * With isolated boundaries the mesh cells grow with the spread of the
+             * particles, and the split scale should be kept above a cell or so.
+             *
+             * \param particles The particles to calculate forces for, their order is
+             * left untouched.
+             * \param buffers Buffers allocated with allocate_p3m_buffers.
+             * \param pool Pool over which the mesh and pair sums are parallelised, if
+             * null the calculation is serial.
+             */
+            template <
+                size_t                    Dimensions,
+                ForceParticle<Dimensions> ParticleType,
+                P3MOptions                Options>
+            void calculate_forces(
+                IN OUT ParticleType* particles,
+                IN OUT P3MBuffers<Dimensions, Options>& buffers,
+                parallel::ThreadPool*                   pool = nullptr
+            );
+        }  // namespace p3m
+    }      // namespace forces
+}  // namespace nbs
+
+#include "p3m.inl"
+
+#endif  // N_BODY_SIM_FORCES_P3M_P3M_HPP
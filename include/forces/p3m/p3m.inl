@@ -0,0 +1,25 @@
+template <
+    size_t                         Dimensions,
+    nbs::ForceParticle<Dimensions> ParticleType,
+    nbs::forces::p3m::P3MOptions   Options>
+void nbs::forces::p3m::calculate_forces(
+    IN OUT ParticleType* particles,
+    IN OUT P3MBuffers<Dimensions, Options>& buffers,
+    parallel::ThreadPool*                   pool /*= nullptr*/
+) {
+    static_assert(
+        Options.mesh.split_scale > 0, "P3M needs a scale to split the force at."
+    );
+
+    pm::calculate_forces<Dimensions, ParticleType, Options.mesh>(
+        particles, buffers.mesh, pool
+    );
+
+    spatial::update_cell_list(particles, buffers.cell_list, pool);
+
+    add_short_range_forces<
+        Dimensions,
+        ParticleType,
+        ShortRangeLaw<Options>,
+        short_range_cell_list_options<Options>>(particles, buffers.cell_list, pool);
+}
@@ -0,0 +1,104 @@
+#ifndef N_BODY_SIM_FORCES_PM_BUFFERS_HPP
+#define N_BODY_SIM_FORCES_PM_BUFFERS_HPP
+
+#pragma once
+
+#include "forces/pm/fft.hpp"
+#include "forces/pm/options.hpp"
+#include "parallel/thread_pool.hpp"
+
+namespace nbs {
+    namespace forces {
+        namespace pm {
+            namespace detail {
+                template <size_t Dimensions, PMOptions Options>
+                struct MeshShape {
+                    static constexpr size_t cells_on_axis = Options.grid_size;
+                    // Isolated boundaries zero-pad the mesh to twice its size on
+                    // each axis so the cyclic convolution of the FFT never wraps
+                    // mass onto the far side of the mesh.
+                    static constexpr size_t fft_cells_on_axis
+                        = Options.boundary == Boundary::ISOLATED ? 2 * cells_on_axis
+                                                                 : cells_on_axis;
+
+                    static constexpr size_t cell_count(size_t cells_on_an_axis) {
+                        size_t count = 1;
+                        for (size_t dim = 0; dim < Dimensions; ++dim) {
+                            count *= cells_on_an_axis;
+                        }
+                        return count;
+                    }
+
+                    static constexpr size_t mesh_cell_count = cell_count(cells_on_axis);
+                    static constexpr size_t fft_cell_count
+                        = cell_count(fft_cells_on_axis);
+
+                    static constexpr size_t stencil_size
+                        = Options.assignment == MassAssignment::CLOUD_IN_CELL ? 2 : 3;
+                };
+            }  // namespace detail
+
+            template <size_t Dimensions, PMOptions Options>
+            struct PMBuffers;
+
+            namespace detail {
+                /**
+                 * \brief Transforms the isolated Green's function for cells of
+                 * cell_size into buffers.greens, using buffers.mesh as scratch.
+                 */
+                template <size_t Dimensions, PMOptions Options>
+                void calculate_isolated_greens(
+                    IN OUT PMBuffers<Dimensions, Options>& buffers,
+                    NBS_PRECISION                          cell_size,
+                    parallel::ThreadPool*                  pool
+                );
+            }  // namespace detail
+
+            template <size_t Dimensions, PMOptions Options>
+            struct PMBuffers {
+                FFTPlan plan;
+                // Cell each particle's stencil starts at, and its stencil weights on
+                // each axis, scaled by its mass on the first.
+                ui32*          particle_cells;
+                NBS_PRECISION* particle_weights;
+                // Particles binned by the cell their stencil starts at, those of cell
+                // i at [cell_starts[i], cell_starts[i + 1]) in particle order.
+                ui32* cell_starts;
+                ui32* binned_particles;
+                // Mass in each cell of the mesh.
+                NBS_PRECISION* density;
+                // Density, then its transform, then the potential, over the FFT
+                // mesh.
+                complex* mesh;
+                // Transform of the Green's function, including the normalisation
+                // of the inverse FFT. Isolated without a split, it is for unit cells.
+                NBS_PRECISION* greens;
+                // Gravitational field on the mesh, one array per axis.
+                NBS_PRECISION* field[Dimensions];
+                // A line of the FFT mesh for each thread of the pool.
+                complex* line_buffers;
+                ui32     worker_count;
+            };
+
+            /**
+             * \brief Allocates buffers for the particle-mesh solver and precomputes
+             * its Green's function. Forces must be calculated with the same pool
+             * given here.
+             */
+            template <size_t Dimensions, PMOptions Options>
+            void allocate_pm_buffers(
+                OUT CALLER_DELETE PMBuffers<Dimensions, Options>& buffers,
+                parallel::ThreadPool*                             pool = nullptr
+            );
+
+            template <size_t Dimensions, PMOptions Options>
+            void deallocate_pm_buffers(
+                OUT CALLER_DELETE PMBuffers<Dimensions, Options> buffers
+            );
+        }  // namespace pm
+    }      // namespace forces
+}  // namespace nbs
+
+#include "buffers.inl"
+
+#endif  // N_BODY_SIM_FORCES_PM_BUFFERS_HPP
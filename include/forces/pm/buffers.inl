@@ -0,0 +1,196 @@
+namespace nbs {
+    namespace forces {
+        namespace pm {
+            namespace detail {
+                // Power of sinc(k h / 2) on each axis deconvolved from the Green's
+                // function. Deconvolving the windows of both mass assignment and
+                // interpolation amplifies aliased modes near the Nyquist frequency
+                // enough to ring at short range, unless the split filters them out,
+                // so only assignment is deconvolved unsplit.
+                template <size_t Dimensions, PMOptions Options>
+                constexpr f64 window_power
+                    = static_cast<f64>(
+                          (Options.split_scale > 0 ? 2 : 1)
+                          * MeshShape<Dimensions, Options>::stencil_size
+                      );
+
+                // Signed offset of a coordinate on an FFT mesh from its origin,
+                // accounting for wrap.
+                inline f64 wrapped_offset(size_t coord, size_t cells_on_axis) {
+                    return coord <= cells_on_axis / 2
+                               ? static_cast<f64>(coord)
+                               : static_cast<f64>(coord)
+                                     - static_cast<f64>(cells_on_axis);
+                }
+            }  // namespace detail
+        }      // namespace pm
+    }          // namespace forces
+}  // namespace nbs
+
+template <size_t Dimensions, nbs::forces::pm::PMOptions Options>
+void nbs::forces::pm::detail::calculate_isolated_greens(
+    IN OUT PMBuffers<Dimensions, Options>& buffers,
+    NBS_PRECISION                          cell_size,
+    parallel::ThreadPool*                  pool
+) {
+    using Shape = MeshShape<Dimensions, Options>;
+
+    constexpr size_t N = Shape::fft_cells_on_axis;
+
+    constexpr f64 split_scale = Options.split_scale;
+
+    // Potential of a unit mass, -erf(r / 2 r_s) / r if split and -1 / r otherwise.
+    // Unsplit, the cell holding the mass sees it as if half a cell away, softening
+    // the self-cell interaction.
+    auto green = [cell_size](size_t cell_idx) {
+        f64    distance_2 = 0.0;
+        size_t remainder  = cell_idx;
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            const f64 offset  = wrapped_offset(remainder % N, N) * cell_size;
+            distance_2       += offset * offset;
+            remainder        /= N;
+        }
+        const f64 distance = std::sqrt(distance_2);
+
+        if constexpr (split_scale > 0.0) {
+            if (distance == 0.0) return -std::numbers::inv_sqrtpi / split_scale;
+
+            return -std::erf(distance / (2.0 * split_scale)) / distance;
+        } else {
+            if (distance == 0.0) return -2.0 / cell_size;
+
+            return -1.0 / distance;
+        }
+    };
+
+    auto fill_green = [&](size_t cell_idx) {
+        const NBS_PRECISION potential = green(cell_idx);
+        buffers.mesh[cell_idx]        = complex(potential);
+    };
+
+    parallel::parallel_for(pool, 0, Shape::fft_cell_count, Options.grain, fill_green);
+
+    fft_grid<Dimensions>(buffers.plan, buffers.mesh, false, buffers.line_buffers, pool);
+
+    // The Green's function is real and even, so is its transform.
+    const f64 normalisation = 1.0 / static_cast<f64>(Shape::fft_cell_count);
+
+    // Sampling -1 / r is too rough to deconvolve unsplit, but once split the
+    // window can be deconvolved as for periodic boundaries.
+    auto copy_greens = [&](size_t cell_idx) {
+        f64 window = 1.0;
+        if constexpr (split_scale > 0.0) {
+            size_t remainder = cell_idx;
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                const f64 half_phase
+                    = std::numbers::pi * wrapped_offset(remainder % N, N) / N;
+
+                remainder /= N;
+
+                const f64 sinc  = half_phase == 0.0 ? 1.0
+                                                    : std::sin(half_phase) / half_phase;
+                window         *= std::pow(sinc, window_power<Dimensions, Options>);
+            }
+        }
+
+        const f64 greens
+            = buffers.mesh[cell_idx].real() * normalisation / window;
+        buffers.greens[cell_idx] = greens;
+    };
+
+    parallel::parallel_for(pool, 0, Shape::fft_cell_count, Options.grain, copy_greens);
+}
+
+template <size_t Dimensions, nbs::forces::pm::PMOptions Options>
+void nbs::forces::pm::allocate_pm_buffers(
+    OUT CALLER_DELETE PMBuffers<Dimensions, Options>& buffers,
+    parallel::ThreadPool*                             pool /*= nullptr*/
+) {
+    using Shape = detail::MeshShape<Dimensions, Options>;
+
+    constexpr size_t N = Shape::fft_cells_on_axis;
+
+    allocate_fft_plan(buffers.plan, N);
+
+    buffers.worker_count = pool ? pool->thread_count() : 1;
+
+    buffers.particle_cells = new ui32[Options.particle_count];
+    buffers.particle_weights
+        = new NBS_PRECISION[Options.particle_count * Dimensions * Shape::stencil_size];
+    buffers.cell_starts      = new ui32[Shape::mesh_cell_count + 1];
+    buffers.binned_particles = new ui32[Options.particle_count];
+
+    buffers.density = new NBS_PRECISION[Shape::mesh_cell_count];
+    buffers.mesh    = new complex[Shape::fft_cell_count];
+    buffers.greens  = new NBS_PRECISION[Shape::fft_cell_count];
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        buffers.field[dim] = new NBS_PRECISION[Shape::mesh_cell_count];
+    }
+    buffers.line_buffers = new complex[N * buffers.worker_count];
+
+    if constexpr (Options.boundary == Boundary::ISOLATED) {
+        // Unsplit, the Green's function is transformed once here for unit cells and
+        // scaled to the cell size each calculation. Split, it doesn't scale so
+        // simply and is transformed each calculation instead.
+        if constexpr (Options.split_scale == 0) {
+            detail::calculate_isolated_greens<Dimensions, Options>(buffers, 1, pool);
+        }
+    } else {
+        static_assert(
+            Dimensions == 3, "Periodic particle-mesh gravity solves Poisson in 3D."
+        );
+
+        // Poisson's equation in k-space, -4 pi rho / k^2, with rho the cell mass
+        // over the cell volume and the mass assignment window deconvolved. The
+        // k = 0 mode is dropped, so the potential is that of the density above its
+        // mean. If split, the long-range part is filtered out with exp(-k^2 r_s^2).
+        const f64 normalisation = 1.0 / static_cast<f64>(Shape::fft_cell_count);
+        const f64 cell_size     = static_cast<f64>(Options.box_size) / N;
+        const f64 wavenumber    = 2.0 * std::numbers::pi / Options.box_size;
+        const f64 cell_volume   = cell_size * cell_size * cell_size;
+        const f64 split_scale_2 = static_cast<f64>(Options.split_scale)
+                                  * static_cast<f64>(Options.split_scale);
+
+        for (size_t cell_idx = 0; cell_idx < Shape::fft_cell_count; ++cell_idx) {
+            f64    k_2       = 0.0;
+            f64    window    = 1.0;
+            size_t remainder = cell_idx;
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                const f64 k  = wavenumber * detail::wrapped_offset(remainder % N, N);
+                k_2         += k * k;
+                remainder   /= N;
+
+                const f64 half_phase  = k * cell_size / 2.0;
+                const f64 sinc        = half_phase == 0.0
+                                            ? 1.0
+                                            : std::sin(half_phase) / half_phase;
+                window               *= std::pow(
+                    sinc, detail::window_power<Dimensions, Options>
+                );
+            }
+
+            const f64 greens
+                = k_2 == 0.0 ? 0.0
+                             : -4.0 * std::numbers::pi * std::exp(-k_2 * split_scale_2)
+                                   / (k_2 * cell_volume * window) * normalisation;
+            buffers.greens[cell_idx] = greens;
+        }
+    }
+}
+
+template <size_t Dimensions, nbs::forces::pm::PMOptions Options>
+void nbs::forces::pm::deallocate_pm_buffers(
+    OUT CALLER_DELETE PMBuffers<Dimensions, Options> buffers
+) {
+    delete[] buffers.line_buffers;
+    for (size_t dim = 0; dim < Dimensions; ++dim) delete[] buffers.field[dim];
+    delete[] buffers.greens;
+    delete[] buffers.mesh;
+    delete[] buffers.density;
+    delete[] buffers.binned_particles;
+    delete[] buffers.cell_starts;
+    delete[] buffers.particle_weights;
+    delete[] buffers.particle_cells;
+
+    deallocate_fft_plan(buffers.plan);
+}
@@ -0,0 +1,55 @@
+#ifndef N_BODY_SIM_FORCES_PM_FFT_HPP
+#define N_BODY_SIM_FORCES_PM_FFT_HPP
+
+#pragma once
+
+#include "parallel/thread_pool.hpp"
+
+namespace nbs {
+    namespace forces {
+        namespace pm {
+            using complex = std::complex<NBS_PRECISION>;
+
+            /**
+             * \brief Twiddle factors and bit-reversal permutation for radix-2 FFTs of
+             * a fixed power-of-two size.
+             */
+            struct FFTPlan {
+                size_t   size;
+                complex* twiddles;
+                ui32*    bit_reversal;
+            };
+
+            void allocate_fft_plan(OUT CALLER_DELETE FFTPlan& plan, size_t size);
+
+            void deallocate_fft_plan(OUT CALLER_DELETE FFTPlan& plan);
+
+            /**
+             * \brief In-place iterative Cooley-Tukey FFT of plan.size contiguous
+             * values. The inverse transform is unnormalised, so a forward and inverse
+             * pair scales data by plan.size.
+             */
+            void fft(const FFTPlan& plan, IN OUT complex* data, bool inverse);
+
+            /**
+             * \brief In-place FFT of a grid of plan.size^Dimensions values, with the
+             * first axis contiguous. Transforms each axis in turn, handing lines of
+             * the grid to the threads of pool; line_buffers must hold plan.size
+             * values for each thread of pool.
+             */
+            template <size_t Dimensions>
+            void fft_grid(
+                const FFTPlan&        plan,
+                IN OUT complex*       grid,
+                bool                  inverse,
+                complex*              line_buffers,
+                parallel::ThreadPool* pool = nullptr,
+                size_t                grain = 16
+            );
+        }  // namespace pm
+    }      // namespace forces
+}  // namespace nbs
+
+#include "fft.inl"
+
+#endif  // N_BODY_SIM_FORCES_PM_FFT_HPP
@@ -0,0 +1,104 @@
+inline void nbs::forces::pm::allocate_fft_plan(
+    OUT CALLER_DELETE FFTPlan& plan, size_t size
+) {
+    assert(size > 0 && (size & (size - 1)) == 0);
+
+    plan.size         = size;
+    plan.twiddles     = new complex[size / 2 + 1];
+    plan.bit_reversal = new ui32[size];
+
+    for (size_t k = 0; k < size / 2 + 1; ++k) {
+        const f64 angle = -2.0 * std::numbers::pi * static_cast<f64>(k)
+                          / static_cast<f64>(size);
+        const NBS_PRECISION real      = std::cos(angle);
+        const NBS_PRECISION imaginary = std::sin(angle);
+        plan.twiddles[k]              = complex(real, imaginary);
+    }
+
+    size_t bits = 0;
+    while ((size_t{ 1 } << bits) < size) ++bits;
+
+    for (size_t idx = 0; idx < size; ++idx) {
+        size_t reversed = 0;
+        for (size_t bit = 0; bit < bits; ++bit) {
+            reversed |= ((idx >> bit) & 1) << (bits - 1 - bit);
+        }
+        plan.bit_reversal[idx] = static_cast<ui32>(reversed);
+    }
+}
+
+inline void nbs::forces::pm::deallocate_fft_plan(OUT CALLER_DELETE FFTPlan& plan) {
+    delete[] plan.twiddles;
+    delete[] plan.bit_reversal;
+}
+
+inline void
+nbs::forces::pm::fft(const FFTPlan& plan, IN OUT complex* data, bool inverse) {
+    const size_t size = plan.size;
+
+    for (size_t idx = 0; idx < size; ++idx) {
+        const size_t reversed = plan.bit_reversal[idx];
+        if (idx < reversed) std::swap(data[idx], data[reversed]);
+    }
+
+    // Butterflies of doubling span, twiddles of span s are every size / s of the
+    // size-point twiddles.
+    for (size_t span = 2; span <= size; span <<= 1) {
+        const size_t half   = span / 2;
+        const size_t stride = size / span;
+
+        for (size_t start = 0; start < size; start += span) {
+            for (size_t k = 0; k < half; ++k) {
+                complex twiddle = plan.twiddles[k * stride];
+                if (inverse) twiddle = std::conj(twiddle);
+
+                const complex even = data[start + k];
+                const complex odd  = data[start + k + half] * twiddle;
+
+                data[start + k]        = even + odd;
+                data[start + k + half] = even - odd;
+            }
+        }
+    }
+}
+
+template <size_t Dimensions>
+void nbs::forces::pm::fft_grid(
+    const FFTPlan&        plan,
+    IN OUT complex*       grid,
+    bool                  inverse,
+    complex*              line_buffers,
+    parallel::ThreadPool* pool /*= nullptr*/,
+    size_t                grain /*= 16*/
+) {
+    const size_t size = plan.size;
+
+    size_t line_count = 1;
+    for (size_t dim = 1; dim < Dimensions; ++dim) line_count *= size;
+
+    size_t axis_stride = 1;
+    for (size_t axis = 0; axis < Dimensions; ++axis) {
+        // Lines along axis are indexed by the coordinates below axis, which vary
+        // fastest, and those above it.
+        auto transform_line = [&, axis_stride](size_t line_idx, ui32 worker_idx) {
+            const size_t below = line_idx % axis_stride;
+            const size_t above = line_idx / axis_stride;
+            complex*     first = grid + below + above * axis_stride * size;
+
+            complex* line = line_buffers + worker_idx * size;
+            for (size_t idx = 0; idx < size; ++idx) {
+                line[idx] = first[idx * axis_stride];
+            }
+
+            fft(plan, line, inverse);
+
+            for (size_t idx = 0; idx < size; ++idx) {
+                first[idx * axis_stride] = line[idx];
+            }
+        };
+
+        parallel::parallel_for(pool, 0, line_count, grain, transform_line);
+
+        axis_stride *= size;
+    }
+}
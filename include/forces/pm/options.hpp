@@ -0,0 +1,44 @@
+#ifndef N_BODY_SIM_FORCES_PM_OPTIONS_HPP
+#define N_BODY_SIM_FORCES_PM_OPTIONS_HPP
+
+#pragma once
+
+namespace nbs {
+    namespace forces {
+        namespace pm {
+            enum class MassAssignment {
+                // Cloud-in-cell, linear weights over 2 cells per axis.
+                CLOUD_IN_CELL,
+                // Triangular-shaped cloud, quadratic weights over 3 cells per axis.
+                TRIANGULAR_SHAPED_CLOUD
+            };
+
+            enum class Boundary {
+                // Particles and their images tile space with period box_size.
+                PERIODIC,
+                // Particles interact only with each other, at the cost of a mesh
+                // twice as fine on each axis being transformed.
+                ISOLATED
+            };
+
+            struct PMOptions {
+                ui32 particle_count = 1000;
+                // Cells on each axis of the mesh covering the particles, must be a
+                // power of two.
+                ui32           grid_size  = 64;
+                MassAssignment assignment = MassAssignment::CLOUD_IN_CELL;
+                Boundary       boundary   = Boundary::ISOLATED;
+                // Side of the periodic box [0, box_size)^D, unused if isolated.
+                NBS_PRECISION box_size = 1.0;
+                // Scale r_s of the Gaussian splitting off the long-range part of the
+                // force, which alone is then calculated on the mesh; zero calculates
+                // the whole force. Should span at least a cell or so.
+                NBS_PRECISION split_scale = 0.0;
+                // Number of particles or mesh cells handed to a thread at a time.
+                ui32 grain = 256;
+            };
+        }  // namespace pm
+    }      // namespace forces
+}  // namespace nbs
+
+#endif  // N_BODY_SIM_FORCES_PM_OPTIONS_HPP
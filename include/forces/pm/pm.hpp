@@ -0,0 +1,54 @@
+#ifndef N_BODY_SIM_FORCES_PM_PM_HPP
+#define N_BODY_SIM_FORCES_PM_PM_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "forces/pm/buffers.hpp"
+#include "forces/pm/fft.hpp"
+#include "forces/pm/options.hpp"
+#include "parallel/thread_pool.hpp"
+
+namespace nbs {
+    namespace forces {
+        namespace pm {
+            /**
+             * \brief Calculates the Newtonian gravitational force on each particle
+             * with the particle-mesh method: mass is assigned to a uniform mesh, the
+             * potential found by FFT convolution with the Green's function, and the
+             * field differenced on the mesh and interpolated back to the particles.
+             * Forces are attractive with G = 1 and particle masses from mass_of, and
+             * are softened on the scale of a cell, so the method suits large, fairly
+             * uniform distributions. The result overwrites particle.force.
+             *
+             * With isolated boundaries the mesh is fitted to the particles each call.
+             * With periodic boundaries, only in 3D, particles are wrapped into the box
+             * [0, box_size)^3 and feel every image of every other particle. With a
+             * split scale, only the long-range part of the force is calculated, see
+             * forces/p3m/p3m.hpp for adding the short-range part.
+             *
+             * \param particles The particles to calculate forces for, their order is
+             * left untouched.
+             * \param buffers Buffers allocated with allocate_pm_buffers.
+             * \param pool Pool over which assignment, FFTs and interpolation are
+             * parallelised, if null the calculation is serial. Each cell sums the
+             * mass assigned to it in a fixed order, so forces do not depend on the
+             * number of threads.
+             */
+            template <
+                size_t                    Dimensions,
+                ForceParticle<Dimensions> ParticleType,
+                PMOptions                 Options>
+            void calculate_forces(
+                IN OUT ParticleType* particles,
+                IN OUT PMBuffers<Dimensions, Options> buffers,
+                parallel::ThreadPool*                 pool = nullptr
+            );
+        }  // namespace pm
+    }      // namespace forces
+}  // namespace nbs
+
+#include "pm.inl"
+
+#endif  // N_BODY_SIM_FORCES_PM_PM_HPP
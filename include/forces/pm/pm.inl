@@ -0,0 +1,373 @@
+namespace nbs {
+    namespace forces {
+        namespace pm {
+            namespace detail {
+                inline size_t wrap(i64 coord, size_t cells_on_axis) {
+                    const i64 size = static_cast<i64>(cells_on_axis);
+                    return static_cast<size_t>(((coord % size) + size) % size);
+                }
+
+                /**
+                 * \brief First cell and weights of the cells touched on one axis by a
+                 * particle at coordinate, in units of cells with cell centres at
+                 * integer coordinates.
+                 */
+                template <MassAssignment Assignment>
+                i64 stencil_weights(
+                    NBS_PRECISION coordinate, OUT NBS_PRECISION* weights
+                ) {
+                    if constexpr (Assignment == MassAssignment::CLOUD_IN_CELL) {
+                        const NBS_PRECISION first = std::floor(coordinate);
+                        const NBS_PRECISION frac  = coordinate - first;
+
+                        weights[0] = 1 - frac;
+                        weights[1] = frac;
+
+                        return static_cast<i64>(first);
+                    } else {
+                        const NBS_PRECISION nearest = std::round(coordinate);
+                        const NBS_PRECISION d       = coordinate - nearest;
+
+                        weights[0] = (1 - 2 * d) * (1 - 2 * d) / 8;
+                        weights[1] = (3 - 4 * d * d) / 4;
+                        weights[2] = (1 + 2 * d) * (1 + 2 * d) / 8;
+
+                        return static_cast<i64>(nearest) - 1;
+                    }
+                }
+            }  // namespace detail
+        }      // namespace pm
+    }          // namespace forces
+}  // namespace nbs
+
+template <
+    size_t                         Dimensions,
+    nbs::ForceParticle<Dimensions> ParticleType,
+    nbs::forces::pm::PMOptions     Options>
+void nbs::forces::pm::calculate_forces(
+    IN OUT ParticleType* particles,
+    IN OUT PMBuffers<Dimensions, Options> buffers,
+    parallel::ThreadPool*                 pool /*= nullptr*/
+) {
+    static_assert(
+        Options.boundary == Boundary::ISOLATED || Dimensions == 3,
+        "Periodic particle-mesh gravity solves Poisson in 3D."
+    );
+    static_assert(
+        Options.boundary == Boundary::PERIODIC || Options.grid_size > 4,
+        "Isolated particle-mesh gravity needs a margin of two cells either side."
+    );
+    assert(buffers.worker_count == (pool ? pool->thread_count() : 1));
+
+    using Shape = detail::MeshShape<Dimensions, Options>;
+
+    constexpr size_t M       = Shape::cells_on_axis;
+    constexpr size_t N       = Shape::fft_cells_on_axis;
+    constexpr size_t STENCIL = Shape::stencil_size;
+
+    constexpr bool PERIODIC = Options.boundary == Boundary::PERIODIC;
+
+    /************
+       Fit the mesh to the particles.
+                            ************/
+
+    vec<Dimensions, NBS_PRECISION> mesh_origin{};
+    NBS_PRECISION                  cell_size;
+
+    if constexpr (PERIODIC) {
+        cell_size = Options.box_size / static_cast<NBS_PRECISION>(M);
+    } else {
+        vec<Dimensions, NBS_PRECISION> domain_min = particles[0].position;
+        vec<Dimensions, NBS_PRECISION> domain_max = particles[0].position;
+        for (size_t particle_idx = 1; particle_idx < Options.particle_count;
+             ++particle_idx)
+        {
+            domain_min = math::min(domain_min, particles[particle_idx].position);
+            domain_max = math::max(domain_max, particles[particle_idx].position);
+        }
+
+        NBS_PRECISION domain_size = 0;
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            domain_size = std::max(domain_size, domain_max[dim] - domain_min[dim]);
+        }
+        domain_size = std::max(domain_size, std::numeric_limits<NBS_PRECISION>::min());
+
+        // Leave two cells either side of the particles, so the stencils of
+        // assignment and of differencing the potential stay on the mesh and within
+        // reach of the zero-padded convolution.
+        cell_size   = domain_size / static_cast<NBS_PRECISION>(M - 4);
+        mesh_origin = domain_min - cell_size * 2;
+    }
+
+    const NBS_PRECISION inverse_cell_size = 1 / cell_size;
+
+    // Mesh coordinates of a particle, in units of cells.
+    auto mesh_coordinates = [&](const ParticleType& particle) {
+        vec<Dimensions, NBS_PRECISION> coords
+            = (particle.position - mesh_origin) * inverse_cell_size;
+
+        if constexpr (PERIODIC) {
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                const NBS_PRECISION mesh_size = static_cast<NBS_PRECISION>(M);
+                coords[dim] -= mesh_size * std::floor(coords[dim] / mesh_size);
+            }
+        }
+
+        return coords;
+    };
+
+    // Calls func(cell_idx, weight) for each mesh cell touched by a particle.
+    auto for_each_stencil_cell = [](const vec<Dimensions, NBS_PRECISION>& coords,
+                                    auto&&                                func) {
+        i64           first[Dimensions];
+        NBS_PRECISION weights[Dimensions][STENCIL];
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            first[dim] = detail::stencil_weights<Options.assignment>(
+                coords[dim], weights[dim]
+            );
+        }
+
+        constexpr size_t stencil_cell_count = Shape::cell_count(STENCIL);
+        for (size_t code = 0; code < stencil_cell_count; ++code) {
+            size_t        cell_idx  = 0;
+            size_t        stride    = 1;
+            NBS_PRECISION weight    = 1;
+            size_t        remainder = code;
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                const size_t offset  = remainder % STENCIL;
+                remainder           /= STENCIL;
+
+                cell_idx += detail::wrap(first[dim] + static_cast<i64>(offset), M)
+                            * stride;
+                stride   *= M;
+                weight   *= weights[dim][offset];
+            }
+
+            func(cell_idx, weight);
+        }
+    };
+
+    if constexpr (!PERIODIC && Options.split_scale > 0) {
+        detail::calculate_isolated_greens<Dimensions, Options>(
+            buffers, cell_size, pool
+        );
+    }
+
+    /************
+       Assign mass to the mesh.
+                      ************/
+
+    // Mass is gathered onto each cell from the particles whose stencils reach it,
+    // rather than scattered from each particle, so that every cell sums its
+    // contributions in the same order however particles are shared between threads.
+
+    constexpr size_t STENCIL_WEIGHTS = Dimensions * STENCIL;
+
+    auto find_stencil = [&](size_t particle_idx) {
+        const ParticleType&                  particle = particles[particle_idx];
+        const vec<Dimensions, NBS_PRECISION> coords   = mesh_coordinates(particle);
+
+        NBS_PRECISION* weights
+            = buffers.particle_weights + particle_idx * STENCIL_WEIGHTS;
+
+        size_t cell_idx = 0;
+        size_t stride   = 1;
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            const i64 first = detail::stencil_weights<Options.assignment>(
+                coords[dim], weights + dim * STENCIL
+            );
+
+            cell_idx += detail::wrap(first, M) * stride;
+            stride   *= M;
+        }
+
+        const NBS_PRECISION mass = mass_of(particle);
+        for (size_t offset = 0; offset < STENCIL; ++offset) weights[offset] *= mass;
+
+        buffers.particle_cells[particle_idx] = static_cast<ui32>(cell_idx);
+    };
+
+    parallel::parallel_for(
+        pool, 0, Options.particle_count, Options.grain, find_stencil
+    );
+
+    // Counting sort of particles by cell, stable so each bin is in particle order.
+    std::fill_n(buffers.cell_starts, Shape::mesh_cell_count + 1, 0);
+    for (size_t particle_idx = 0; particle_idx < Options.particle_count;
+         ++particle_idx)
+    {
+        ++buffers.cell_starts[buffers.particle_cells[particle_idx] + 1];
+    }
+    for (size_t cell_idx = 0; cell_idx < Shape::mesh_cell_count; ++cell_idx) {
+        buffers.cell_starts[cell_idx + 1] += buffers.cell_starts[cell_idx];
+    }
+    for (size_t particle_idx = 0; particle_idx < Options.particle_count;
+         ++particle_idx)
+    {
+        ui32& next = buffers.cell_starts[buffers.particle_cells[particle_idx]];
+
+        buffers.binned_particles[next++] = static_cast<ui32>(particle_idx);
+    }
+    // Placing particles advanced each start to the next cell's, so shift back.
+    for (size_t cell_idx = Shape::mesh_cell_count; cell_idx > 0; --cell_idx) {
+        buffers.cell_starts[cell_idx] = buffers.cell_starts[cell_idx - 1];
+    }
+    buffers.cell_starts[0] = 0;
+
+    // Sums into a cell the mass of the particles of each cell whose stencils reach
+    // it, the stencil offset of the cell from them being code.
+    auto gather_mass = [&](size_t cell_idx) {
+        i64    coords[Dimensions];
+        size_t remainder = cell_idx;
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            coords[dim]  = static_cast<i64>(remainder % M);
+            remainder   /= M;
+        }
+
+        NBS_PRECISION mass = 0;
+
+        constexpr size_t stencil_cell_count = Shape::cell_count(STENCIL);
+        for (size_t code = 0; code < stencil_cell_count; ++code) {
+            size_t offsets[Dimensions];
+            size_t source_cell_idx = 0;
+            size_t stride          = 1;
+            remainder              = code;
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                offsets[dim]  = remainder % STENCIL;
+                remainder    /= STENCIL;
+
+                source_cell_idx
+                    += detail::wrap(coords[dim] - static_cast<i64>(offsets[dim]), M)
+                       * stride;
+                stride *= M;
+            }
+
+            const ui32 bin_end = buffers.cell_starts[source_cell_idx + 1];
+            for (ui32 bin_idx = buffers.cell_starts[source_cell_idx]; bin_idx < bin_end;
+                 ++bin_idx)
+            {
+                const NBS_PRECISION* weights
+                    = buffers.particle_weights
+                      + buffers.binned_particles[bin_idx] * STENCIL_WEIGHTS;
+
+                NBS_PRECISION weight = 1;
+                for (size_t dim = 0; dim < Dimensions; ++dim) {
+                    weight *= weights[dim * STENCIL + offsets[dim]];
+                }
+
+                mass += weight;
+            }
+        }
+
+        buffers.density[cell_idx] = mass;
+    };
+
+    parallel::parallel_for(
+        pool, 0, Shape::mesh_cell_count, Options.grain, gather_mass
+    );
+
+    /************
+       Convolve with the Green's function for the potential.
+                                                  ************/
+
+    // Copies the mesh into the corner of the FFT mesh, zeroing any padding.
+    auto fill_fft_mesh = [&](size_t fft_cell_idx) {
+        size_t mesh_cell_idx = 0;
+        size_t stride        = 1;
+        size_t remainder     = fft_cell_idx;
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            const size_t coord  = remainder % N;
+            remainder          /= N;
+
+            if (coord >= M) {
+                buffers.mesh[fft_cell_idx] = complex{};
+                return;
+            }
+
+            mesh_cell_idx += coord * stride;
+            stride        *= M;
+        }
+
+        buffers.mesh[fft_cell_idx] = complex(buffers.density[mesh_cell_idx]);
+    };
+
+    parallel::parallel_for(
+        pool, 0, Shape::fft_cell_count, Options.grain, fill_fft_mesh
+    );
+
+    fft_grid<Dimensions>(buffers.plan, buffers.mesh, false, buffers.line_buffers, pool);
+
+    // The unsplit isolated Green's function is for unit cells.
+    const NBS_PRECISION greens_scale
+        = PERIODIC || Options.split_scale > 0 ? 1 : inverse_cell_size;
+
+    auto apply_greens = [&](size_t fft_cell_idx) {
+        buffers.mesh[fft_cell_idx] *= buffers.greens[fft_cell_idx] * greens_scale;
+    };
+
+    parallel::parallel_for(pool, 0, Shape::fft_cell_count, Options.grain, apply_greens);
+
+    fft_grid<Dimensions>(buffers.plan, buffers.mesh, true, buffers.line_buffers, pool);
+
+    /************
+       Difference the potential for the field on the mesh.
+                                                 ************/
+
+    // Fourth-order central differences of the potential, field = -grad(potential).
+    const NBS_PRECISION near_weight = inverse_cell_size * 8 / 12;
+    const NBS_PRECISION far_weight  = inverse_cell_size / 12;
+
+    auto difference_potential = [&](size_t mesh_cell_idx) {
+        i64    coords[Dimensions];
+        size_t remainder = mesh_cell_idx;
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            coords[dim]  = static_cast<i64>(remainder % M);
+            remainder   /= M;
+        }
+
+        auto potential = [&](size_t axis, i64 offset) {
+            size_t fft_cell_idx = 0;
+            size_t stride       = 1;
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                const i64 coord  = coords[dim] + (dim == axis ? offset : 0);
+                fft_cell_idx    += detail::wrap(coord, N) * stride;
+                stride          *= N;
+            }
+            return buffers.mesh[fft_cell_idx].real();
+        };
+
+        for (size_t axis = 0; axis < Dimensions; ++axis) {
+            buffers.field[axis][mesh_cell_idx]
+                = far_weight * (potential(axis, 2) - potential(axis, -2))
+                  - near_weight * (potential(axis, 1) - potential(axis, -1));
+        }
+    };
+
+    parallel::parallel_for(
+        pool, 0, Shape::mesh_cell_count, Options.grain, difference_potential
+    );
+
+    /************
+       Interpolate the field back to the particles.
+                                          ************/
+
+    auto interpolate_field = [&](size_t particle_idx) {
+        ParticleType& particle = particles[particle_idx];
+
+        vec<Dimensions, NBS_PRECISION> field{};
+        for_each_stencil_cell(
+            mesh_coordinates(particle),
+            [&](size_t cell_idx, NBS_PRECISION weight) {
+                for (size_t dim = 0; dim < Dimensions; ++dim) {
+                    field[dim] += weight * buffers.field[dim][cell_idx];
+                }
+            }
+        );
+
+        particle.force = field * mass_of(particle);
+    };
+
+    parallel::parallel_for(
+        pool, 0, Options.particle_count, Options.grain, interpolate_field
+    );
+}
@@ -0,0 +1,75 @@
+#ifndef N_BODY_SIM_FORCES_SHORT_RANGE_HPP
+#define N_BODY_SIM_FORCES_SHORT_RANGE_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "forces/laws.hpp"
+#include "parallel/thread_pool.hpp"
+#include "spatial/cell_list.hpp"
+
+namespace nbs {
+    namespace forces {
+        namespace detail {
+            /**
+             * \brief Adds the force of a cut-off law to particle.force, summing over
+             * the neighbours for_each_neighbour(particles, cell_list, particle_idx,
+             * func) gives each particle.
+             */
+            template <
+                size_t                    Dimensions,
+                ForceParticle<Dimensions> ParticleType,
+                ForceLaw                  Law,
+                spatial::CellListOptions  Options,
+                typename ForEachNeighbour>
+            void add_neighbour_forces(
+                IN OUT ParticleType* particles,
+                const spatial::CellList<Dimensions, Options>& cell_list,
+                parallel::ThreadPool*                         pool,
+                ForEachNeighbour&&                            for_each_neighbour
+            );
+        }  // namespace detail
+
+        /**
+         * \brief Adds the force of a cut-off law to particle.force, summing over
+         * the neighbours of each particle in an up-to-date cell list. Each particle
+         * sums its own neighbours, so the cost is linear in the particle count for a
+         * bounded density, rather than quadratic as in a direct sum.
+         *
+         * If the particles have a potential member and the law defines a potential,
+         * the potential energy of each particle's pairs is added to it alongside.
+         */
+        template <
+            size_t                    Dimensions,
+            ForceParticle<Dimensions> ParticleType,
+            ForceLaw                  Law,
+            spatial::CellListOptions  Options>
+        void add_short_range_forces(
+            IN OUT ParticleType* particles,
+            const spatial::CellList<Dimensions, Options>& cell_list,
+            parallel::ThreadPool*                         pool = nullptr
+        );
+
+        /**
+         * \brief As add_short_range_forces, but walking the neighbour lists of the
+         * cell list, which must be up to date, see spatial::update_neighbour_lists.
+         * Lists are rebuilt only every so many steps, so between rebuilds each
+         * particle reads its neighbours directly rather than searching cells.
+         */
+        template <
+            size_t                    Dimensions,
+            ForceParticle<Dimensions> ParticleType,
+            ForceLaw                  Law,
+            spatial::CellListOptions  Options>
+        void add_listed_short_range_forces(
+            IN OUT ParticleType* particles,
+            const spatial::CellList<Dimensions, Options>& cell_list,
+            parallel::ThreadPool*                         pool = nullptr
+        );
+    }  // namespace forces
+}  // namespace nbs
+
+#include "short_range.inl"
+
+#endif  // N_BODY_SIM_FORCES_SHORT_RANGE_HPP
@@ -0,0 +1,89 @@
+template <
+    size_t                         Dimensions,
+    nbs::ForceParticle<Dimensions> ParticleType,
+    nbs::forces::ForceLaw          Law,
+    nbs::spatial::CellListOptions  Options,
+    typename ForEachNeighbour>
+void nbs::forces::detail::add_neighbour_forces(
+    IN OUT ParticleType* particles,
+    const spatial::CellList<Dimensions, Options>& cell_list,
+    parallel::ThreadPool*                         pool,
+    ForEachNeighbour&&                            for_each_neighbour
+) {
+    static_assert(
+        Law::cutoff_radius <= Options.cutoff_radius,
+        "Short-range laws must be cut off within the cell list's cutoff radius."
+    );
+
+    constexpr bool with_potential
+        = PotentialParticle<ParticleType> && PotentialLaw<Law>;
+
+    auto particle_forces = [&](size_t particle_idx) {
+        ParticleType& particle = particles[particle_idx];
+
+        vec<Dimensions, NBS_PRECISION> force{};
+        NBS_PRECISION                  potential = 0;
+        for_each_neighbour(
+            particles,
+            cell_list,
+            particle_idx,
+            [&](size_t                                other_idx,
+                const vec<Dimensions, NBS_PRECISION>& displacement,
+                NBS_PRECISION                         distance_2) {
+                const NBS_PRECISION other_mass = mass_of(particles[other_idx]);
+
+                force += displacement * (Law::scale(distance_2) * other_mass);
+
+                if constexpr (with_potential) {
+                    potential += Law::potential(distance_2) * other_mass;
+                }
+            }
+        );
+
+        particle.force += force * mass_of(particle);
+
+        if constexpr (with_potential) {
+            particle.potential += potential * mass_of(particle);
+        }
+    };
+
+    parallel::parallel_for(
+        pool, 0, Options.particle_count, Options.grain, particle_forces
+    );
+}
+
+template <
+    size_t                         Dimensions,
+    nbs::ForceParticle<Dimensions> ParticleType,
+    nbs::forces::ForceLaw          Law,
+    nbs::spatial::CellListOptions  Options>
+void nbs::forces::add_short_range_forces(
+    IN OUT ParticleType* particles,
+    const spatial::CellList<Dimensions, Options>& cell_list,
+    parallel::ThreadPool*                         pool /*= nullptr*/
+) {
+    detail::add_neighbour_forces<Dimensions, ParticleType, Law, Options>(
+        particles,
+        cell_list,
+        pool,
+        [](auto&&... args) { spatial::for_each_neighbour(args...); }
+    );
+}
+
+template <
+    size_t                         Dimensions,
+    nbs::ForceParticle<Dimensions> ParticleType,
+    nbs::forces::ForceLaw          Law,
+    nbs::spatial::CellListOptions  Options>
+void nbs::forces::add_listed_short_range_forces(
+    IN OUT ParticleType* particles,
+    const spatial::CellList<Dimensions, Options>& cell_list,
+    parallel::ThreadPool*                         pool /*= nullptr*/
+) {
+    detail::add_neighbour_forces<Dimensions, ParticleType, Law, Options>(
+        particles,
+        cell_list,
+        pool,
+        [](auto&&... args) { spatial::for_each_listed_neighbour(args...); }
+    );
+}
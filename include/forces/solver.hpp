@@ -0,0 +1,245 @@
+#ifndef N_BODY_SIM_FORCES_SOLVER_HPP
+#define N_BODY_SIM_FORCES_SOLVER_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "clustering/cluster.hpp"
+#include "clustering/moments.hpp"
+#include "forces/cluster_multipole.hpp"
+#include "forces/direct_kernel.hpp"
+#include "forces/ewald/table.hpp"
+#include "forces/laws.hpp"
+#include "parallel/thread_pool.hpp"
+#include "spatial/periodic.hpp"
+
+namespace nbs {
+    namespace forces {
+        struct ForceSolverOptions {
+            // Clusters whose radius subtends less than this angle at a particle are
+            // approximated by their multipole expansion.
+            NBS_PRECISION opening_angle = 0.5;
+            // Whether space wraps with period box_size on every axis, pairs then
+            // interact through their nearest images. Clusters must be well under half
+            // the box across.
+            bool          periodic = false;
+            NBS_PRECISION box_size = 1;
+            // Whether, if periodic, the further images of each cluster also act
+            // through the Ewald sum of their monopoles. Only for gravity in 3D.
+            bool ewald_summation = true;
+            // Clusters costing more than 1 / block_split_count of a step are split
+            // into blocks of their particles, each a task of its own, so that as many
+            // workers can share a step without one cluster holding it up. Blocks are
+            // no fewer than min_block_size particles.
+            ui32 block_split_count = 32;
+            ui32 min_block_size    = 64;
+        };
+
+        namespace detail {
+            // Radii of clusters are taken this fraction larger when building
+            // interaction lists, so that the lists hold as clusters drift.
+            constexpr NBS_PRECISION INTERACTION_LIST_SKIN = 0.25;
+
+            /**
+             * \brief Particles [begin, end) of a cluster, whose forces are
+             * calculated by one task.
+             */
+            struct ClusterBlock {
+                ui32   cluster_idx;
+                ui32   begin;
+                ui32   end;
+                size_t cost;
+            };
+
+            template <ForceSolverOptions Options>
+            constexpr bool uses_ewald_summation
+                = Options.periodic && Options.ewald_summation;
+
+            // Potentials are calculated alongside forces if both particle and law
+            // support them.
+            template <typename ParticleType, typename Law>
+            constexpr bool computes_potential
+                = PotentialParticle<ParticleType> && PotentialLaw<Law>;
+
+            template <ForceSolverOptions Options>
+            constexpr ewald::EwaldOptions solver_ewald_options
+                = ewald::EwaldOptions{ .box_size = Options.box_size };
+
+            /**
+             * \brief Displacement from one position to another, to the nearest image
+             * of the other if periodic.
+             */
+            template <size_t Dimensions, ForceSolverOptions Options>
+            vec<Dimensions, NBS_PRECISION> separation(
+                const vec<Dimensions, NBS_PRECISION>& from,
+                const vec<Dimensions, NBS_PRECISION>& to
+            );
+        }  // namespace detail
+
+        // Which forces on each particle to calculate, so that integrators can step
+        // near and far forces at different rates.
+        enum class ForceRange {
+            ALL,
+            // Pairs within its cluster, and clusters on its interaction list.
+            NEAR,
+            // Clusters acting through its cluster's local expansion, and further
+            // images if Ewald summing.
+            FAR
+        };
+
+        struct InteractionListCounters {
+            // Times interaction lists have been checked, once per calculation.
+            size_t checks;
+            // Times interaction lists were found not to hold and were rebuilt.
+            size_t rebuilds;
+        };
+
+        /**
+         * \brief Calculates forces on clustered particles: pairs within a cluster
+         * are summed directly, other clusters act through their multipole
+         * expansion unless too close, in which case they are summed directly.
+         *
+         * Clusters well separated from a cluster act on it through one local
+         * expansion of their fields about its centre, built once per step, so each
+         * particle pays for the near clusters only. Which clusters are near each is
+         * held in interaction lists, built with radii a little larger than the
+         * clusters' and reused until invalidated or a cluster strays outside that
+         * larger radius.
+         *
+         * Work is split across the thread pool a cluster at a time, most expensive
+         * first, costing a cluster of n particles n^2 + n k for k clusters. A
+         * cluster's task is the only writer of its particles' forces, so
+         * intra-cluster pairs apply Newton's third law without synchronisation.
+         * Clusters costing more than a fraction of the step are instead split into
+         * blocks of their particles, whose tasks each sum all pairs of their own
+         * particles, so no one cluster holds up a step. Which clusters are split
+         * does not depend on the number of threads, so neither do forces.
+         *
+         * In a periodic box, with Ewald summation, each cluster's images beyond the
+         * nearest act through the correction to its monopole, which varies slowly
+         * enough across the cluster for that to hold.
+         *
+         * If the particles have a potential member and the law defines a potential,
+         * particle potentials are calculated in the same pass, far clusters acting
+         * through the potential of their multipole and local expansions. With Ewald
+         * summation, potentials leave out the further images.
+         *
+         * Law is a force law policy, see forces/laws.hpp.
+         */
+        template <
+            size_t                        Dimensions,
+            ClusteredParticle<Dimensions> ParticleType,
+            ForceLaw                      Law,
+            ForceSolverOptions            Options>
+        class ForceSolver {
+            static_assert(
+                ForceParticle<ParticleType, Dimensions>,
+                "Force solver particles must have a force member."
+            );
+            static_assert(
+                !Options.periodic || !Options.ewald_summation || Dimensions == 3,
+                "Ewald summation is only implemented in 3D."
+            );
+            static_assert(
+                Options.min_block_size > 0,
+                "Blocks of split clusters must hold at least one particle."
+            );
+        public:
+            ForceSolver(size_t max_cluster_count, parallel::ThreadPool* pool = nullptr);
+            ~ForceSolver();
+
+            NBS_NON_COPYABLE(ForceSolver);
+            NBS_NON_MOVABLE(ForceSolver);
+
+            /**
+             * \brief Overwrites particle.force of every particle held by clusters,
+             * and particle.potential if calculating potentials.
+             *
+             * If active is given, indexed by cluster_metadata_idx, only the forces of
+             * active particles are calculated and the rest are left untouched. All
+             * particles still act as sources.
+             *
+             * If range is NEAR or FAR, only those forces are calculated, which sum
+             * to the forces of ALL. Far forces skip the direct sums and near forces
+             * skip building the local expansions. Near forces don't rebuild
+             * interaction lists that have strayed, so that the split between near
+             * and far stays as it was at the last far forces until invalidated.
+             */
+            void calculate_forces(
+                IN OUT ParticleType* particles,
+                const cluster::Cluster<Dimensions, ParticleType>* clusters,
+                size_t                                            cluster_count,
+                const bool*                                       active = nullptr,
+                ForceRange range = ForceRange::ALL
+            );
+
+            /**
+             * \brief Marks interaction lists to be rebuilt on the next calculation,
+             * for when clusters have been rebuilt, e.g. by reclustering.
+             */
+            void invalidate_interaction_lists() { m_interaction_cluster_count = 0; }
+
+            const InteractionListCounters& interaction_list_counters() const {
+                return m_interaction_list_counters;
+            }
+
+            const cluster::ClusterMoments<Dimensions>* moments() const {
+                return m_moments;
+            }
+        protected:
+            /**
+             * \brief Whether every cluster that had particles when the interaction
+             * lists were built still lies within the larger radius it was given, and
+             * no others have particles, so that the lists still hold.
+             */
+            bool interaction_lists_hold(
+                const cluster::Cluster<Dimensions, ParticleType>* clusters,
+                size_t                                            cluster_count
+            ) const;
+
+            void build_interaction_lists(
+                const cluster::Cluster<Dimensions, ParticleType>* clusters,
+                size_t                                            cluster_count
+            );
+
+            void calculate_cluster_forces(
+                IN OUT ParticleType* particles,
+                const cluster::Cluster<Dimensions, ParticleType>* clusters,
+                size_t                                            cluster_count,
+                const detail::ClusterBlock&                       block,
+                const bool*                                       active,
+                ForceRange                                        range,
+                ui32                                              worker_idx
+            );
+
+            size_t                               m_max_cluster_count;
+            parallel::ThreadPool*                m_pool;
+            cluster::ClusterMoments<Dimensions>* m_moments;
+            // Blocks of the current step, most expensive first.
+            detail::ClusterBlock* m_schedule;
+            // Sources too near each cluster to act through its local expansion,
+            // sorted, those of cluster_idx being m_near_sources[m_near_offsets[
+            // cluster_idx], m_near_offsets[cluster_idx + 1]). Sized for every other
+            // cluster being near each, so the lists never grow mid-step.
+            ui32* m_near_offsets;
+            ui32* m_near_sources;
+            // Centre and larger radius of each cluster when the interaction lists
+            // were built, radii negative for clusters then empty, and the number of
+            // clusters, zero if the lists are to be rebuilt.
+            vec<Dimensions, NBS_PRECISION>* m_reference_centres;
+            NBS_PRECISION*                  m_reference_radii;
+            size_t                          m_interaction_cluster_count;
+            LocalExpansion<Dimensions>*     m_local_expansions;
+            InteractionListCounters         m_interaction_list_counters;
+            // Direct kernel scratch for each worker of the pool.
+            DirectKernelScratch<Dimensions>* m_scratch;
+            // Only allocated if using Ewald summation.
+            ewald::EwaldTable<detail::solver_ewald_options<Options>> m_ewald_table;
+        };
+    }  // namespace forces
+}  // namespace nbs
+
+#include "solver.inl"
+
+#endif  // N_BODY_SIM_FORCES_SOLVER_HPP
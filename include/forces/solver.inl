@@ -0,0 +1,587 @@
+template <size_t Dimensions, nbs::forces::ForceSolverOptions Options>
+nbs::vec<Dimensions, NBS_PRECISION> nbs::forces::detail::separation(
+    const vec<Dimensions, NBS_PRECISION>& from, const vec<Dimensions, NBS_PRECISION>& to
+) {
+    if constexpr (Options.periodic) {
+        return spatial::nearest_image<Dimensions>(to - from, Options.box_size);
+    } else {
+        return to - from;
+    }
+}
+
+template <
+    size_t                             Dimensions,
+    nbs::ClusteredParticle<Dimensions> ParticleType,
+    nbs::forces::ForceLaw              Law,
+    nbs::forces::ForceSolverOptions    Options>
+nbs::forces::ForceSolver<Dimensions, ParticleType, Law, Options>::ForceSolver(
+    size_t max_cluster_count, parallel::ThreadPool* pool /*= nullptr*/
+) :
+    m_max_cluster_count(max_cluster_count),
+    m_pool(pool),
+    m_moments(new cluster::ClusterMoments<Dimensions>[max_cluster_count]),
+    m_schedule(new detail::ClusterBlock[max_cluster_count + Options.block_split_count]),
+    m_near_offsets(new ui32[max_cluster_count + 1]),
+    m_near_sources(new ui32[max_cluster_count * max_cluster_count]),
+    m_reference_centres(new vec<Dimensions, NBS_PRECISION>[max_cluster_count]),
+    m_reference_radii(new NBS_PRECISION[max_cluster_count]),
+    m_interaction_cluster_count(0),
+    m_local_expansions(new LocalExpansion<Dimensions>[max_cluster_count]),
+    m_interaction_list_counters{},
+    m_scratch(new DirectKernelScratch<Dimensions>[pool ? pool->thread_count() : 1]{}),
+    m_ewald_table{} {
+    if constexpr (detail::uses_ewald_summation<Options>) {
+        ewald::allocate_ewald_table(m_ewald_table, pool);
+    }
+}
+
+template <
+    size_t                             Dimensions,
+    nbs::ClusteredParticle<Dimensions> ParticleType,
+    nbs::forces::ForceLaw              Law,
+    nbs::forces::ForceSolverOptions    Options>
+nbs::forces::ForceSolver<Dimensions, ParticleType, Law, Options>::~ForceSolver() {
+    const ui32 worker_count = m_pool ? m_pool->thread_count() : 1;
+    for (ui32 worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+        deallocate_direct_kernel_scratch(m_scratch[worker_idx]);
+    }
+
+    delete[] m_moments;
+    delete[] m_schedule;
+    delete[] m_near_offsets;
+    delete[] m_near_sources;
+    delete[] m_reference_centres;
+    delete[] m_reference_radii;
+    delete[] m_local_expansions;
+    delete[] m_scratch;
+
+    if constexpr (detail::uses_ewald_summation<Options>) {
+        ewald::deallocate_ewald_table(m_ewald_table);
+    }
+}
+
+template <
+    size_t                             Dimensions,
+    nbs::ClusteredParticle<Dimensions> ParticleType,
+    nbs::forces::ForceLaw              Law,
+    nbs::forces::ForceSolverOptions    Options>
+void nbs::forces::ForceSolver<Dimensions, ParticleType, Law, Options>::
+    calculate_forces(
+        IN OUT ParticleType* particles,
+        const cluster::Cluster<Dimensions, ParticleType>* clusters,
+        size_t                                            cluster_count,
+        const bool*                                       active /*= nullptr*/,
+        ForceRange                                        range /*= ForceRange::ALL*/
+    ) {
+    assert(cluster_count <= m_max_cluster_count);
+
+    /************
+       Bring cluster moments up to date with particle positions.
+                                                       ************/
+
+    auto update_moments = [&](size_t cluster_idx) {
+        cluster::calculate_cluster_moments<Dimensions, ParticleType>(
+            particles,
+            clusters + cluster_idx,
+            1,
+            m_moments + cluster_idx,
+            Options.periodic ? Options.box_size : 0
+        );
+    };
+
+    parallel::parallel_for(m_pool, 0, cluster_count, 1, update_moments);
+
+    /************
+       Expand the fields of the clusters far from each cluster about its centre,
+       first rebuilding the interaction lists if they no longer hold.
+                                                               ************/
+
+    ++m_interaction_list_counters.checks;
+
+    // Near forces are exact for any lists, so keep the lists, and with them the
+    // split between near and far forces, unless they are for other clusters.
+    const bool lists_hold = range == ForceRange::NEAR
+                                ? m_interaction_cluster_count == cluster_count
+                                : interaction_lists_hold(clusters, cluster_count);
+
+    if (!lists_hold) {
+        build_interaction_lists(clusters, cluster_count);
+
+        ++m_interaction_list_counters.rebuilds;
+    }
+
+    auto expand_far_clusters = [&](size_t cluster_idx) {
+        LocalExpansion<Dimensions>& local = m_local_expansions[cluster_idx];
+
+        local = {};
+
+        if (clusters[cluster_idx].particle_count == 0) return;
+
+        const vec<Dimensions, NBS_PRECISION>& centre = m_moments[cluster_idx].centre;
+
+        const ui32* near_source     = m_near_sources + m_near_offsets[cluster_idx];
+        const ui32* near_source_end = m_near_sources + m_near_offsets[cluster_idx + 1];
+
+        for (ui32 source_idx = 0; source_idx < cluster_count; ++source_idx) {
+            // Near sources are sorted, so are stepped past in turn.
+            if (near_source != near_source_end && *near_source == source_idx) {
+                ++near_source;
+                continue;
+            }
+
+            if (source_idx == cluster_idx || clusters[source_idx].particle_count == 0)
+            {
+                continue;
+            }
+
+            const cluster::ClusterMoments<Dimensions>& source_moments
+                = m_moments[source_idx];
+
+            // The expansion is about the source's centre, so if periodic place the
+            // centre at its image nearest to it.
+            const vec<Dimensions, NBS_PRECISION> to_source_centre
+                = detail::separation<Dimensions, Options>(
+                    centre, source_moments.centre
+                );
+
+            add_to_local_expansion(
+                local, source_moments.centre - to_source_centre, source_moments
+            );
+        }
+    };
+
+    if (range != ForceRange::NEAR) {
+        parallel::parallel_for(m_pool, 0, cluster_count, 1, expand_far_clusters);
+    }
+
+    /************
+       Schedule clusters most expensive first, so the largest direct sums are not
+       left to run alone at the end of the step, splitting any cluster costing more
+       than a fraction of the step into blocks.
+                                         ************/
+
+    auto cluster_cost = [&clusters, cluster_count, range](size_t cluster_idx) {
+        size_t particle_count = clusters[cluster_idx].particle_count;
+        size_t pair_count = range == ForceRange::FAR ? 0 : particle_count;
+        return particle_count * pair_count + particle_count * cluster_count;
+    };
+
+    size_t total_cost = 0;
+    for (size_t cluster_idx = 0; cluster_idx < cluster_count; ++cluster_idx) {
+        total_cost += cluster_cost(cluster_idx);
+    }
+
+    // Each cluster is split into at most cost / max_block_cost + 1 blocks, so the
+    // schedule holds at most block_split_count blocks beyond one per cluster.
+    const size_t max_block_cost
+        = (total_cost + Options.block_split_count - 1) / Options.block_split_count;
+
+    size_t block_count = 0;
+    for (ui32 cluster_idx = 0; cluster_idx < cluster_count; ++cluster_idx) {
+        const size_t particle_count = clusters[cluster_idx].particle_count;
+        const size_t cost           = cluster_cost(cluster_idx);
+
+        // Blocks lose the halving of intra-cluster pairs by Newton's third law, so
+        // only clusters that would hold up a step are split.
+        size_t split_count = 1;
+        if (max_block_cost > 0 && cost > max_block_cost) {
+            split_count = std::min<size_t>(
+                (cost + max_block_cost - 1) / max_block_cost,
+                particle_count / Options.min_block_size
+            );
+            split_count = std::max<size_t>(split_count, 1);
+        }
+
+        for (size_t split_idx = 0; split_idx < split_count; ++split_idx) {
+            const ui32 begin
+                = static_cast<ui32>(particle_count * split_idx / split_count);
+            const ui32 end
+                = static_cast<ui32>(particle_count * (split_idx + 1) / split_count);
+
+            m_schedule[block_count++] = detail::ClusterBlock{
+                .cluster_idx = cluster_idx,
+                .begin       = begin,
+                .end         = end,
+                .cost        = split_count == 1
+                                   ? cost
+                                   : (end - begin) * (particle_count + cluster_count)
+            };
+        }
+    }
+
+    assert(block_count <= m_max_cluster_count + Options.block_split_count);
+
+    std::sort(
+        m_schedule,
+        m_schedule + block_count,
+        [](const detail::ClusterBlock& lhs, const detail::ClusterBlock& rhs) {
+            return lhs.cost > rhs.cost;
+        }
+    );
+
+    /************
+       Calculate forces a block at a time.
+                                 ************/
+
+    auto block_forces = [&](size_t schedule_idx, ui32 worker_idx) {
+        calculate_cluster_forces(
+            particles,
+            clusters,
+            cluster_count,
+            m_schedule[schedule_idx],
+            active,
+            range,
+            worker_idx
+        );
+    };
+
+    parallel::parallel_for(m_pool, 0, block_count, 1, block_forces);
+}
+
+template <
+    size_t                             Dimensions,
+    nbs::ClusteredParticle<Dimensions> ParticleType,
+    nbs::forces::ForceLaw              Law,
+    nbs::forces::ForceSolverOptions    Options>
+bool nbs::forces::ForceSolver<Dimensions, ParticleType, Law, Options>::
+    interaction_lists_hold(
+        const cluster::Cluster<Dimensions, ParticleType>* clusters,
+        size_t                                            cluster_count
+    ) const {
+    if (m_interaction_cluster_count != cluster_count) return false;
+
+    // While each cluster lies within the larger radius about its old centre, clusters
+    // well separated at the larger radii remain well separated.
+    for (size_t cluster_idx = 0; cluster_idx < cluster_count; ++cluster_idx) {
+        if (clusters[cluster_idx].particle_count == 0) continue;
+
+        if (m_reference_radii[cluster_idx] < 0) return false;
+
+        const vec<Dimensions, NBS_PRECISION> drift
+            = detail::separation<Dimensions, Options>(
+                m_reference_centres[cluster_idx], m_moments[cluster_idx].centre
+            );
+
+        if (math::length(drift) + m_moments[cluster_idx].radius
+            > m_reference_radii[cluster_idx])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <
+    size_t                             Dimensions,
+    nbs::ClusteredParticle<Dimensions> ParticleType,
+    nbs::forces::ForceLaw              Law,
+    nbs::forces::ForceSolverOptions    Options>
+void nbs::forces::ForceSolver<Dimensions, ParticleType, Law, Options>::
+    build_interaction_lists(
+        const cluster::Cluster<Dimensions, ParticleType>* clusters,
+        size_t                                            cluster_count
+    ) {
+    for (size_t cluster_idx = 0; cluster_idx < cluster_count; ++cluster_idx) {
+        m_reference_centres[cluster_idx] = m_moments[cluster_idx].centre;
+        m_reference_radii[cluster_idx]
+            = clusters[cluster_idx].particle_count == 0
+                  ? -1
+                  : m_moments[cluster_idx].radius * (1 + detail::INTERACTION_LIST_SKIN);
+    }
+
+    ui32 near_count = 0;
+    for (size_t cluster_idx = 0; cluster_idx < cluster_count; ++cluster_idx) {
+        m_near_offsets[cluster_idx] = near_count;
+
+        if (m_reference_radii[cluster_idx] < 0) continue;
+
+        for (ui32 source_idx = 0; source_idx < cluster_count; ++source_idx) {
+            if (source_idx == cluster_idx || m_reference_radii[source_idx] < 0) {
+                continue;
+            }
+
+            const vec<Dimensions, NBS_PRECISION> separation
+                = detail::separation<Dimensions, Options>(
+                    m_reference_centres[cluster_idx], m_reference_centres[source_idx]
+                );
+
+            // If periodic, far clusters enter the local expansion at their image
+            // nearest the centre, which must also be the image nearest each particle,
+            // that which the Ewald correction leaves out. Clusters whose nearest
+            // image may differ across the cluster are kept near.
+            bool same_image = true;
+            if constexpr (Options.periodic) {
+                const NBS_PRECISION reach
+                    = m_reference_radii[cluster_idx] + m_reference_radii[source_idx];
+
+                for (size_t dim = 0; dim < Dimensions; ++dim) {
+                    same_image = same_image
+                                 && std::abs(separation[dim]) + reach
+                                        < Options.box_size / 2;
+                }
+            }
+
+            if (same_image
+                && are_well_separated(
+                    separation,
+                    m_reference_radii[cluster_idx],
+                    m_reference_radii[source_idx],
+                    Options.opening_angle
+                ))
+            {
+                continue;
+            }
+
+            assert(near_count < m_max_cluster_count * m_max_cluster_count);
+            m_near_sources[near_count++] = source_idx;
+        }
+    }
+    m_near_offsets[cluster_count] = near_count;
+
+    m_interaction_cluster_count = cluster_count;
+}
+
+template <
+    size_t                             Dimensions,
+    nbs::ClusteredParticle<Dimensions> ParticleType,
+    nbs::forces::ForceLaw              Law,
+    nbs::forces::ForceSolverOptions    Options>
+void nbs::forces::ForceSolver<Dimensions, ParticleType, Law, Options>::
+    calculate_cluster_forces(
+        IN OUT ParticleType* particles,
+        const cluster::Cluster<Dimensions, ParticleType>* clusters,
+        size_t                                            cluster_count,
+        const detail::ClusterBlock&                       block,
+        const bool*                                       active,
+        ForceRange                                        range,
+        ui32                                              worker_idx
+    ) {
+    constexpr bool with_potential = detail::computes_potential<ParticleType, Law>;
+
+    const bool with_near = range != ForceRange::FAR;
+    const bool with_far  = range != ForceRange::NEAR;
+
+    const size_t cluster_idx = block.cluster_idx;
+    const auto&  cluster     = clusters[cluster_idx];
+
+    ParticleType* cluster_particles = particles + cluster.particle_offset;
+
+    // Blocks of a split cluster run alongside each other, so may only write the
+    // forces of their own particles.
+    const bool whole_cluster = block.begin == 0 && block.end == cluster.particle_count;
+
+    auto is_active = [active](const ParticleType& particle) {
+        return active == nullptr || active[particle.cluster_metadata_idx];
+    };
+
+    size_t active_count = 0;
+    for (size_t offset = block.begin; offset < block.end; ++offset) {
+        if (!is_active(cluster_particles[offset])) continue;
+
+        cluster_particles[offset].force = {};
+        if constexpr (with_potential) cluster_particles[offset].potential = 0;
+
+        ++active_count;
+    }
+
+    if (active_count == 0) return;
+
+    // Adds the force on particle_1 from particle_2 to force, and the potential
+    // energy of the pair to potential if calculating potentials.
+    auto add_pair = [](const ParticleType&                    particle_1,
+                       const ParticleType&                    particle_2,
+                       IN OUT vec<Dimensions, NBS_PRECISION>& force,
+                       IN OUT NBS_PRECISION&                  potential) {
+        const vec<Dimensions, NBS_PRECISION> displacement
+            = detail::separation<Dimensions, Options>(
+                particle_1.position, particle_2.position
+            );
+        const NBS_PRECISION distance_2   = math::dot(displacement, displacement);
+        const NBS_PRECISION mass_product = mass_of(particle_1) * mass_of(particle_2);
+
+        force += displacement * (Law::scale(distance_2) * mass_product);
+
+        if constexpr (with_potential) {
+            potential += Law::potential(distance_2) * mass_product;
+        }
+    };
+
+    /************
+       Direct sum within the cluster, using Newton's third law unless only a few
+       particles are active or the cluster is split into blocks. Near forces only.
+                                                      ************/
+
+    if (with_near) {
+        DirectKernelScratch<Dimensions>& scratch = m_scratch[worker_idx];
+
+        gather_direct_kernel_scratch<Dimensions, ParticleType>(
+            cluster_particles, cluster.particle_count, scratch
+        );
+
+        // Take each particle at its nearest image to the cluster's centre, so the
+        // kernels see the cluster whole.
+        if constexpr (Options.periodic) {
+            const vec<Dimensions, NBS_PRECISION>& centre
+                = m_moments[cluster_idx].centre;
+
+            for (size_t dim = 0; dim < Dimensions; ++dim) {
+                const NBS_COMPUTE_PRECISION box_size = Options.box_size;
+                const NBS_COMPUTE_PRECISION relative_centre
+                    = centre[dim] - scratch.origin[dim];
+
+                for (size_t offset = 0; offset < cluster.particle_count; ++offset) {
+                    NBS_COMPUTE_PRECISION& coord = scratch.positions[dim][offset];
+
+                    coord -= box_size
+                             * std::round((coord - relative_centre) / box_size);
+                }
+            }
+        }
+
+        if (whole_cluster && active_count == cluster.particle_count) {
+            direct_sum_symmetric<Dimensions, Law, with_potential>(
+                scratch, cluster.particle_count
+            );
+            scatter_direct_kernel_scratch<Dimensions, ParticleType>(
+                scratch, cluster.particle_count, cluster_particles
+            );
+        } else {
+            // Symmetric kernel evaluates each pair once, targeted kernel evaluates
+            // count pairs per active particle, so switch over at half active.
+            const bool use_symmetric
+                = whole_cluster && 2 * active_count > cluster.particle_count;
+
+            if (use_symmetric) {
+                direct_sum_symmetric<Dimensions, Law, with_potential>(
+                    scratch, cluster.particle_count
+                );
+            }
+
+            for (size_t offset = block.begin; offset < block.end; ++offset) {
+                auto& particle = cluster_particles[offset];
+
+                if (!is_active(particle)) continue;
+
+                if (!use_symmetric) {
+                    direct_sum_onto<Dimensions, Law, with_potential>(
+                        scratch, cluster.particle_count, offset
+                    );
+                }
+
+                for (size_t dim = 0; dim < Dimensions; ++dim) {
+                    particle.force[dim] += scratch.forces[dim][offset];
+                }
+
+                if constexpr (with_potential) {
+                    particle.potential += scratch.potentials[offset];
+                }
+            }
+        }
+    }
+
+    /************
+       Far field from the local expansion of the far clusters and from the further
+       images of every cluster if Ewald summing, which are far forces, and from
+       each near cluster, which are near forces.
+                                                                 ************/
+
+    const LocalExpansion<Dimensions>&     local  = m_local_expansions[cluster_idx];
+    const vec<Dimensions, NBS_PRECISION>& centre = m_moments[cluster_idx].centre;
+
+    // Near clusters are walked only for near forces.
+    const ui32* near_sources     = m_near_sources + m_near_offsets[cluster_idx];
+    const ui32* near_sources_end
+        = with_near ? m_near_sources + m_near_offsets[cluster_idx + 1] : near_sources;
+
+    for (size_t p1_offset = block.begin; p1_offset < block.end; ++p1_offset) {
+        auto& particle_1 = cluster_particles[p1_offset];
+
+        if (!is_active(particle_1)) continue;
+
+        const vec<Dimensions, NBS_PRECISION> offset
+            = detail::separation<Dimensions, Options>(centre, particle_1.position);
+
+        vec<Dimensions, NBS_PRECISION> field{};
+        vec<Dimensions, NBS_PRECISION> force{};
+        // Potential energy per unit mass from far clusters, and of direct pairs.
+        NBS_PRECISION field_potential = 0;
+        NBS_PRECISION potential       = 0;
+
+        if (with_far) {
+            field = local_expansion_field(local, offset);
+
+            if constexpr (with_potential) {
+                field_potential = local_expansion_potential(local, offset);
+            }
+        }
+
+        if constexpr (detail::uses_ewald_summation<Options>) {
+            for (size_t other_cluster_idx = 0;
+                 with_far && other_cluster_idx < cluster_count;
+                 ++other_cluster_idx)
+            {
+                const auto& other_moments = m_moments[other_cluster_idx];
+
+                if (clusters[other_cluster_idx].particle_count == 0) continue;
+
+                field += ewald::ewald_correction(
+                             m_ewald_table,
+                             detail::separation<Dimensions, Options>(
+                                 particle_1.position, other_moments.centre
+                             )
+                         )
+                         * other_moments.mass;
+            }
+        }
+
+        for (const ui32* near_source = near_sources; near_source != near_sources_end;
+             ++near_source)
+        {
+            const auto& other_cluster = clusters[*near_source];
+            const auto& other_moments = m_moments[*near_source];
+
+            if (other_cluster.particle_count == 0) continue;
+
+            // The expansion is about the centre, so if periodic place the particle at
+            // its image nearest to it.
+            const vec<Dimensions, NBS_PRECISION> position
+                = Options.periodic
+                      ? other_moments.centre
+                            - detail::separation<Dimensions, Options>(
+                                particle_1.position, other_moments.centre
+                            )
+                      : particle_1.position;
+
+            if (is_well_separated(position, other_moments, Options.opening_angle)) {
+                field += cluster_multipole_field(position, other_moments);
+
+                if constexpr (with_potential) {
+                    field_potential
+                        += cluster_multipole_potential(position, other_moments);
+                }
+
+                continue;
+            }
+
+            // Too close for the expansion to hold, sum the other cluster's particles
+            // directly instead.
+            for (size_t p2_offset = 0; p2_offset < other_cluster.particle_count;
+                 ++p2_offset)
+            {
+                add_pair(
+                    particle_1,
+                    particles[other_cluster.particle_offset + p2_offset],
+                    force,
+                    potential
+                );
+            }
+        }
+
+        particle_1.force += field * mass_of(particle_1) + force;
+
+        if constexpr (with_potential) {
+            particle_1.potential += field_potential * mass_of(particle_1) + potential;
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef N_BODY_SIM_INTEGRATORS_BLOCK_TIMESTEP_HPP
+#define N_BODY_SIM_INTEGRATORS_BLOCK_TIMESTEP_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "integrators/kick_drift.hpp"
+#include "parallel/thread_pool.hpp"
+
+namespace nbs {
+    namespace integrators {
+        struct BlockTimestepOptions {
+            ui32 particle_count = 1000;
+            // Particles on rung r step by time_step / 2^r, so the finest step is
+            // time_step / 2^max_rung.
+            ui32 max_rung = 8;
+            // Eta in dt = eta |a| / |da/dt|. The jerk is estimated from a single
+            // step, so eta must be smaller than for higher order criteria; on A1
+            // this matches the energy error of leapfrog at the finest step.
+            NBS_PRECISION accuracy = 0.0075;
+            // Length scale for the first choice of rungs, before any jerk is known,
+            // for which dt = eta sqrt(length / |a|).
+            NBS_PRECISION initial_length_scale = 1;
+        };
+
+        /**
+         * \brief Per-particle block timestep state, indexed by cluster_metadata_idx so
+         * that it survives reclustering.
+         */
+        template <size_t Dimensions, BlockTimestepOptions Options>
+        struct BlockTimestepBuffers {
+            ui32* rungs;
+            // Acceleration at each particle's last force evaluation.
+            vec<Dimensions, NBS_PRECISION>* accelerations;
+            // Particles whose forces are due on the current substep.
+            bool* active;
+        };
+
+        template <size_t Dimensions, BlockTimestepOptions Options>
+        void allocate_block_timestep_buffers(
+            OUT CALLER_DELETE BlockTimestepBuffers<Dimensions, Options>& buffers
+        );
+
+        template <size_t Dimensions, BlockTimestepOptions Options>
+        void deallocate_block_timestep_buffers(
+            OUT CALLER_DELETE BlockTimestepBuffers<Dimensions, Options>& buffers
+        );
+
+        /**
+         * \brief Chooses each particle's first rung from its acceleration. Particle
+         * forces must be current.
+         */
+        template <
+            size_t                        Dimensions,
+            ClusteredParticle<Dimensions> ParticleType,
+            BlockTimestepOptions          Options>
+        void initialise_block_timesteps(
+            const ParticleType*                             particles,
+            NBS_PRECISION                                   time_step,
+            OUT BlockTimestepBuffers<Dimensions, Options>& buffers
+        );
+
+        /**
+         * \brief Advances particles by time_step with hierarchical block timesteps.
+         *
+         * The step is made of 2^max_rung substeps. Each particle takes kick-drift-kick
+         * steps of time_step / 2^rung, and its rung is chosen again at the end of each
+         * of its steps from its acceleration and its jerk, estimated from the change
+         * in acceleration over the step. A particle may move to any finer rung but
+         * only to the next coarser one, and only when that rung's step boundaries line
+         * up with the current time.
+         *
+         * All particles drift every substep, which predicts the positions of those
+         * between kicks, but only particles ending a step on a substep are active
+         * for it. calculate_forces(active) is called once per substep, with active
+         * indexed by cluster_metadata_idx, and must overwrite the force of each active
+         * particle from the current positions of all particles, e.g. a ForceSolver
+         * given the active flags. Forces must be current on entry.
+         *
+         * Every particle ends a step on the last substep, so particles may be
+         * reclustered between calls, e.g. by recluster_if_drifted, which reconsiders
+         * only the particles that have moved since they were last clustered.
+         *
+         * Returns the number of particle force evaluations made.
+         */
+        template <
+            size_t                        Dimensions,
+            ClusteredParticle<Dimensions> ParticleType,
+            BlockTimestepOptions          Options,
+            typename ForceCalculator>
+        size_t block_timestep(
+            IN OUT ParticleType*                              particles,
+            NBS_PRECISION                                     time_step,
+            ForceCalculator&&                                 calculate_forces,
+            IN OUT BlockTimestepBuffers<Dimensions, Options>& buffers,
+            parallel::ThreadPool*                             pool = nullptr
+        );
+    }  // namespace integrators
+}  // namespace nbs
+
+#include "block_timestep.inl"
+
+#endif  // N_BODY_SIM_INTEGRATORS_BLOCK_TIMESTEP_HPP
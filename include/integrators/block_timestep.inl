@@ -0,0 +1,189 @@
+template <size_t Dimensions, nbs::integrators::BlockTimestepOptions Options>
+void nbs::integrators::allocate_block_timestep_buffers(
+    OUT CALLER_DELETE BlockTimestepBuffers<Dimensions, Options>& buffers
+) {
+    buffers.rungs         = new ui32[Options.particle_count];
+    buffers.accelerations = new vec<Dimensions, NBS_PRECISION>[Options.particle_count];
+    buffers.active        = new bool[Options.particle_count];
+}
+
+template <size_t Dimensions, nbs::integrators::BlockTimestepOptions Options>
+void nbs::integrators::deallocate_block_timestep_buffers(
+    OUT CALLER_DELETE BlockTimestepBuffers<Dimensions, Options>& buffers
+) {
+    delete[] buffers.rungs;
+    delete[] buffers.accelerations;
+    delete[] buffers.active;
+}
+
+namespace nbs {
+    namespace integrators {
+        namespace detail {
+            // Finest rung whose step, time_step / 2^rung, is no longer than dt.
+            template <BlockTimestepOptions Options>
+            ui32 rung_for_timestep(NBS_PRECISION time_step, NBS_PRECISION dt) {
+                if (!(dt > 0)) return Options.max_rung;
+                if (dt >= time_step) return 0;
+
+                const ui32 rung
+                    = static_cast<ui32>(math::ceil(std::log2(time_step / dt)));
+
+                return std::min(rung, Options.max_rung);
+            }
+        }  // namespace detail
+    }      // namespace integrators
+}  // namespace nbs
+
+template <
+    size_t                                 Dimensions,
+    nbs::ClusteredParticle<Dimensions>     ParticleType,
+    nbs::integrators::BlockTimestepOptions Options>
+void nbs::integrators::initialise_block_timesteps(
+    const ParticleType*                             particles,
+    NBS_PRECISION                                   time_step,
+    OUT BlockTimestepBuffers<Dimensions, Options>& buffers
+) {
+    for (size_t idx = 0; idx < Options.particle_count; ++idx) {
+        const auto&  particle = particles[idx];
+        const size_t id       = particle.cluster_metadata_idx;
+
+        buffers.accelerations[id] = particle.force / mass_of(particle);
+
+        const NBS_PRECISION acceleration = math::length(buffers.accelerations[id]);
+
+        // Unaccelerated particles may as well start on the coarsest rung.
+        buffers.rungs[id] = 0;
+        if (acceleration > 0) {
+            buffers.rungs[id] = detail::rung_for_timestep<Options>(
+                time_step,
+                Options.accuracy
+                    * math::sqrt(Options.initial_length_scale / acceleration)
+            );
+        }
+    }
+}
+
+template <
+    size_t                                 Dimensions,
+    nbs::ClusteredParticle<Dimensions>     ParticleType,
+    nbs::integrators::BlockTimestepOptions Options,
+    typename ForceCalculator>
+size_t nbs::integrators::block_timestep(
+    IN OUT ParticleType*                              particles,
+    NBS_PRECISION                                     time_step,
+    ForceCalculator&&                                 calculate_forces,
+    IN OUT BlockTimestepBuffers<Dimensions, Options>& buffers,
+    parallel::ThreadPool*                             pool /*= nullptr*/
+) {
+    static_assert(
+        DynamicParticle<ParticleType, Dimensions>,
+        "Block timestep particles must have force and velocity members."
+    );
+
+    const ui32          substep_count = static_cast<ui32>(1) << Options.max_rung;
+    const NBS_PRECISION finest_step
+        = time_step / static_cast<NBS_PRECISION>(substep_count);
+
+    auto rung_step = [time_step](ui32 rung) {
+        return time_step / static_cast<NBS_PRECISION>(static_cast<ui32>(1) << rung);
+    };
+
+    // Whether a step of the given rung begins or ends on the given substep.
+    auto on_rung_boundary = [](ui32 substep, ui32 rung) {
+        return substep % (static_cast<ui32>(1) << (Options.max_rung - rung)) == 0;
+    };
+
+    size_t force_evaluations = 0;
+
+    for (ui32 substep = 0; substep < substep_count; ++substep) {
+        /************
+           Opening half-kick of particles beginning a step.
+                                                  ************/
+
+        auto open_kick = [&](size_t idx) {
+            auto&      particle = particles[idx];
+            const ui32 rung     = buffers.rungs[particle.cluster_metadata_idx];
+
+            if (!on_rung_boundary(substep, rung)) return;
+
+            particle.velocity += particle.force
+                                 * (rung_step(rung) / (2 * mass_of(particle)));
+        };
+
+        parallel::parallel_for(
+            pool, 0, Options.particle_count, KICK_DRIFT_GRAIN, open_kick
+        );
+
+        /************
+           Drift everything, predicting positions of particles between kicks.
+                                                              ************/
+
+        drift<Dimensions, ParticleType>(
+            particles, Options.particle_count, finest_step, pool
+        );
+
+        /************
+           Forces on particles ending a step.
+                                    ************/
+
+        const ui32 next_substep = substep + 1;
+
+        size_t active_count = 0;
+        for (size_t idx = 0; idx < Options.particle_count; ++idx) {
+            const size_t id = particles[idx].cluster_metadata_idx;
+
+            buffers.active[id] = on_rung_boundary(next_substep, buffers.rungs[id]);
+            if (buffers.active[id]) ++active_count;
+        }
+
+        if (active_count == 0) continue;
+
+        calculate_forces(static_cast<const bool*>(buffers.active));
+        force_evaluations += active_count;
+
+        /************
+           Closing half-kick and choice of next rung.
+                                            ************/
+
+        auto close_kick = [&](size_t idx) {
+            auto&        particle = particles[idx];
+            const size_t id       = particle.cluster_metadata_idx;
+
+            if (!buffers.active[id]) return;
+
+            const ui32          rung = buffers.rungs[id];
+            const NBS_PRECISION dt   = rung_step(rung);
+
+            const vec<Dimensions, NBS_PRECISION> acceleration
+                = particle.force / mass_of(particle);
+
+            particle.velocity += acceleration * (dt / 2);
+
+            const NBS_PRECISION jerk
+                = math::length(acceleration - buffers.accelerations[id]) / dt;
+            buffers.accelerations[id] = acceleration;
+
+            // An unchanged acceleration puts no limit on the step.
+            ui32 next_rung = 0;
+            if (jerk > 0) {
+                next_rung = detail::rung_for_timestep<Options>(
+                    time_step, Options.accuracy * math::length(acceleration) / jerk
+                );
+            }
+
+            // Coarsen by at most one rung at a time, and only onto a rung whose
+            // steps line up with the current time.
+            next_rung = std::max(next_rung, rung > 0 ? rung - 1 : 0);
+            while (!on_rung_boundary(next_substep, next_rung)) {
+                ++next_rung;
+            }
+            buffers.rungs[id] = next_rung;
+        };
+
+        parallel::parallel_for(
+            pool, 0, Options.particle_count, KICK_DRIFT_GRAIN, close_kick
+        );
+    }
+
+    return force_evaluations;
+}
@@ -0,0 +1,5 @@
+#include "block_timestep.hpp"
+#include "leapfrog.hpp"
+#include "respa.hpp"
+#include "velocity_verlet.hpp"
+#include "yoshida.hpp"
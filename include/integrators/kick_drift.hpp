@@ -0,0 +1,47 @@
+#ifndef N_BODY_SIM_INTEGRATORS_KICK_DRIFT_HPP
+#define N_BODY_SIM_INTEGRATORS_KICK_DRIFT_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "diagnostics/diagnostics.hpp"
+#include "parallel/thread_pool.hpp"
+
+namespace nbs {
+    namespace integrators {
+        // Particles handed out to each thread at a time by kick and drift.
+        constexpr size_t KICK_DRIFT_GRAIN = 512;
+
+        /**
+         * \brief Advances velocities by time_step under the current forces.
+         *
+         * If diagnostics is given, it is reset and the diagnostics of the kicked
+         * particles accumulated into it in the same pass. It must have been allocated
+         * for at least particle_count particles.
+         */
+        template <size_t Dimensions, DynamicParticle<Dimensions> ParticleType>
+        void kick(
+            IN OUT ParticleType*                             particles,
+            size_t                                           particle_count,
+            NBS_PRECISION                                    time_step,
+            parallel::ThreadPool*                            pool        = nullptr,
+            diagnostics::DiagnosticsAccumulator<Dimensions>* diagnostics = nullptr
+        );
+
+        /**
+         * \brief Advances positions by time_step under the current velocities.
+         */
+        template <size_t Dimensions, DynamicParticle<Dimensions> ParticleType>
+        void drift(
+            IN OUT ParticleType*  particles,
+            size_t                particle_count,
+            NBS_PRECISION         time_step,
+            parallel::ThreadPool* pool = nullptr
+        );
+    }  // namespace integrators
+}  // namespace nbs
+
+#include "kick_drift.inl"
+
+#endif  // N_BODY_SIM_INTEGRATORS_KICK_DRIFT_HPP
@@ -0,0 +1,65 @@
+template <size_t Dimensions, nbs::DynamicParticle<Dimensions> ParticleType>
+void nbs::integrators::kick(
+    IN OUT ParticleType*                             particles,
+    size_t                                           particle_count,
+    NBS_PRECISION                                    time_step,
+    parallel::ThreadPool*                            pool /*= nullptr*/,
+    diagnostics::DiagnosticsAccumulator<Dimensions>* diagnostics /*= nullptr*/
+) {
+    auto kick_particle = [particles, time_step](size_t idx) {
+        auto& particle = particles[idx];
+
+        particle.velocity += particle.force * (time_step / mass_of(particle));
+    };
+
+    if (diagnostics == nullptr) {
+        parallel::parallel_for(
+            pool, 0, particle_count, KICK_DRIFT_GRAIN, kick_particle
+        );
+        return;
+    }
+
+    constexpr size_t block_size = diagnostics::DIAGNOSTICS_BLOCK_SIZE;
+
+    assert(particle_count <= diagnostics->block_count * block_size);
+
+    diagnostics::reset_diagnostics_accumulator(*diagnostics);
+
+    // Handed out a block at a time, so that each block is summed by one thread in
+    // particle order.
+    auto kick_and_measure_block = [&](size_t block_idx) {
+        const size_t block_begin = block_idx * block_size;
+        const size_t block_end   = std::min(block_begin + block_size, particle_count);
+
+        diagnostics::Diagnostics<Dimensions>& sums
+            = diagnostics->block_sums[block_idx];
+
+        for (size_t idx = block_begin; idx < block_end; ++idx) {
+            kick_particle(idx);
+
+            diagnostics::accumulate_particle_diagnostics<Dimensions>(
+                sums, particles[idx]
+            );
+        }
+    };
+
+    const size_t block_count = (particle_count + block_size - 1) / block_size;
+
+    parallel::parallel_for(pool, 0, block_count, 1, kick_and_measure_block);
+}
+
+template <size_t Dimensions, nbs::DynamicParticle<Dimensions> ParticleType>
+void nbs::integrators::drift(
+    IN OUT ParticleType*  particles,
+    size_t                particle_count,
+    NBS_PRECISION         time_step,
+    parallel::ThreadPool* pool /*= nullptr*/
+) {
+    auto drift_particle = [particles, time_step](size_t idx) {
+        auto& particle = particles[idx];
+
+        particle.position += particle.velocity * time_step;
+    };
+
+    parallel::parallel_for(pool, 0, particle_count, KICK_DRIFT_GRAIN, drift_particle);
+}
@@ -0,0 +1,23 @@
+template <
+    size_t                           Dimensions,
+    nbs::DynamicParticle<Dimensions> ParticleType,
+    typename ForceCalculator>
+void nbs::integrators::Leapfrog::step(
+    IN OUT ParticleType*                             particles,
+    size_t                                           particle_count,
+    NBS_PRECISION                                    time_step,
+    ForceCalculator&&                                calculate_forces,
+    parallel::ThreadPool*                            pool /*= nullptr*/,
+    diagnostics::DiagnosticsAccumulator<Dimensions>* diagnostics /*= nullptr*/
+) {
+    const NBS_PRECISION half_step = time_step / static_cast<NBS_PRECISION>(2);
+
+    kick<Dimensions, ParticleType>(particles, particle_count, half_step, pool);
+    drift<Dimensions, ParticleType>(particles, particle_count, time_step, pool);
+
+    calculate_forces();
+
+    kick<Dimensions, ParticleType>(
+        particles, particle_count, half_step, pool, diagnostics
+    );
+}
@@ -0,0 +1,102 @@
+#ifndef N_BODY_SIM_INTEGRATORS_RESPA_HPP
+#define N_BODY_SIM_INTEGRATORS_RESPA_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "diagnostics/diagnostics.hpp"
+#include "integrators/leapfrog.hpp"
+#include "parallel/thread_pool.hpp"
+
+namespace nbs {
+    namespace integrators {
+        struct RespaOptions {
+            ui32 particle_count = 1000;
+            // Leapfrog substeps under the fast forces per step under the slow forces.
+            ui32 substeps = 4;
+        };
+
+        /**
+         * \brief Fast and slow forces on each particle as of their last evaluation,
+         * indexed by cluster_metadata_idx so that they survive reordering.
+         */
+        template <size_t Dimensions, RespaOptions Options>
+        struct RespaBuffers {
+            vec<Dimensions, NBS_PRECISION>* fast_forces;
+            vec<Dimensions, NBS_PRECISION>* slow_forces;
+            // Only written if particles have a potential member.
+            NBS_PRECISION* fast_potentials;
+            NBS_PRECISION* slow_potentials;
+        };
+
+        template <size_t Dimensions, RespaOptions Options>
+        void allocate_respa_buffers(
+            OUT CALLER_DELETE RespaBuffers<Dimensions, Options>& buffers
+        );
+
+        template <size_t Dimensions, RespaOptions Options>
+        void deallocate_respa_buffers(
+            OUT CALLER_DELETE RespaBuffers<Dimensions, Options>& buffers
+        );
+
+        /**
+         * \brief Calculates the fast and slow forces of the particles into buffers,
+         * leaving particle forces (and potentials) as their sum. Call once before
+         * the first respa_step.
+         */
+        template <
+            size_t                        Dimensions,
+            ClusteredParticle<Dimensions> ParticleType,
+            RespaOptions                  Options,
+            typename FastForceCalculator,
+            typename SlowForceCalculator>
+        void initialise_respa(
+            IN OUT ParticleType*                   particles,
+            FastForceCalculator&&                  calculate_fast_forces,
+            SlowForceCalculator&&                  calculate_slow_forces,
+            OUT RespaBuffers<Dimensions, Options>& buffers,
+            parallel::ThreadPool*                  pool = nullptr
+        );
+
+        /**
+         * \brief Advances particles by time_step with impulse multiple time
+         * stepping (r-RESPA), symplectic and second order.
+         *
+         * The slow forces kick velocities by half of time_step at either end of the
+         * step, and in between particles take Options.substeps leapfrog steps under
+         * the fast forces. calculate_fast_forces is so called once per substep and
+         * calculate_slow_forces once per step, each overwriting the force of every
+         * particle from their current positions, e.g. the NEAR and FAR forces of a
+         * ForceSolver. Slow forces should vary little over a step for it to hold.
+         * If calculating the slow forces can change which forces are fast, e.g. by
+         * the ForceSolver rebuilding its interaction lists, calculate_slow_forces
+         * should return true when it has, and the fast forces are then recalculated
+         * under the new split.
+         *
+         * Fast and slow forces must be current in buffers on entry, see
+         * initialise_respa, and are current on return, particle forces (and
+         * potentials) then being their sum. If diagnostics is given, the diagnostics
+         * of the particles at the end of the step are accumulated into it.
+         */
+        template <
+            size_t                        Dimensions,
+            ClusteredParticle<Dimensions> ParticleType,
+            RespaOptions                  Options,
+            typename FastForceCalculator,
+            typename SlowForceCalculator>
+        void respa_step(
+            IN OUT ParticleType*                             particles,
+            NBS_PRECISION                                    time_step,
+            FastForceCalculator&&                            calculate_fast_forces,
+            SlowForceCalculator&&                            calculate_slow_forces,
+            IN OUT RespaBuffers<Dimensions, Options>&        buffers,
+            parallel::ThreadPool*                            pool        = nullptr,
+            diagnostics::DiagnosticsAccumulator<Dimensions>* diagnostics = nullptr
+        );
+    }  // namespace integrators
+}  // namespace nbs
+
+#include "respa.inl"
+
+#endif  // N_BODY_SIM_INTEGRATORS_RESPA_HPP
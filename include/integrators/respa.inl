@@ -0,0 +1,286 @@
+template <size_t Dimensions, nbs::integrators::RespaOptions Options>
+void nbs::integrators::allocate_respa_buffers(
+    OUT CALLER_DELETE RespaBuffers<Dimensions, Options>& buffers
+) {
+    buffers.fast_forces
+        = new vec<Dimensions, NBS_PRECISION>[Options.particle_count];
+    buffers.slow_forces
+        = new vec<Dimensions, NBS_PRECISION>[Options.particle_count];
+    buffers.fast_potentials = new NBS_PRECISION[Options.particle_count];
+    buffers.slow_potentials = new NBS_PRECISION[Options.particle_count];
+}
+
+template <size_t Dimensions, nbs::integrators::RespaOptions Options>
+void nbs::integrators::deallocate_respa_buffers(
+    OUT CALLER_DELETE RespaBuffers<Dimensions, Options>& buffers
+) {
+    delete[] buffers.fast_forces;
+    delete[] buffers.slow_forces;
+    delete[] buffers.fast_potentials;
+    delete[] buffers.slow_potentials;
+}
+
+namespace nbs {
+    namespace integrators {
+        namespace detail {
+            // Puts particle's force (and potential) aside in buffers as its fast
+            // force.
+            template <
+                size_t                        Dimensions,
+                ClusteredParticle<Dimensions> ParticleType,
+                RespaOptions                  Options>
+            void store_fast_force(
+                const ParticleType&                       particle,
+                IN OUT RespaBuffers<Dimensions, Options>& buffers
+            ) {
+                const size_t id = particle.cluster_metadata_idx;
+
+                buffers.fast_forces[id] = particle.force;
+                if constexpr (PotentialParticle<ParticleType>) {
+                    buffers.fast_potentials[id] = particle.potential;
+                }
+            }
+
+            // Puts particle's force (and potential) aside in buffers as its slow
+            // force, then sets it to the sum of its fast and slow forces.
+            template <
+                size_t                        Dimensions,
+                ClusteredParticle<Dimensions> ParticleType,
+                RespaOptions                  Options>
+            void store_slow_force(
+                IN OUT ParticleType&                      particle,
+                IN OUT RespaBuffers<Dimensions, Options>& buffers
+            ) {
+                const size_t id = particle.cluster_metadata_idx;
+
+                buffers.slow_forces[id]  = particle.force;
+                particle.force          += buffers.fast_forces[id];
+                if constexpr (PotentialParticle<ParticleType>) {
+                    buffers.slow_potentials[id]  = particle.potential;
+                    particle.potential          += buffers.fast_potentials[id];
+                }
+            }
+
+            // Calculates the slow forces, returning whether doing so changed which
+            // forces are fast, which only slow force calculators returning bool can.
+            template <typename SlowForceCalculator>
+            bool calculate_slow_forces(SlowForceCalculator&& calculate_slow_forces) {
+                if constexpr (std::is_same_v<
+                                  std::invoke_result_t<SlowForceCalculator>,
+                                  bool>)
+                {
+                    return calculate_slow_forces();
+                } else {
+                    calculate_slow_forces();
+                    return false;
+                }
+            }
+
+            // Recalculates the fast forces of particles from their current
+            // positions into buffers, leaving particles with the slow forces they
+            // held on entry.
+            template <
+                size_t                        Dimensions,
+                ClusteredParticle<Dimensions> ParticleType,
+                RespaOptions                  Options,
+                typename FastForceCalculator>
+            void recalculate_fast_forces(
+                IN OUT ParticleType*                      particles,
+                FastForceCalculator&&                     calculate_fast_forces,
+                IN OUT RespaBuffers<Dimensions, Options>& buffers,
+                parallel::ThreadPool*                     pool
+            ) {
+                auto put_aside_slow_force = [&](size_t idx) {
+                    const ParticleType& particle = particles[idx];
+                    const size_t        id       = particle.cluster_metadata_idx;
+
+                    buffers.slow_forces[id] = particle.force;
+                    if constexpr (PotentialParticle<ParticleType>) {
+                        buffers.slow_potentials[id] = particle.potential;
+                    }
+                };
+
+                parallel::parallel_for(
+                    pool,
+                    0,
+                    Options.particle_count,
+                    KICK_DRIFT_GRAIN,
+                    put_aside_slow_force
+                );
+
+                calculate_fast_forces();
+
+                auto restore_slow_force = [&](size_t idx) {
+                    ParticleType& particle = particles[idx];
+                    const size_t  id       = particle.cluster_metadata_idx;
+
+                    store_fast_force(particle, buffers);
+
+                    particle.force = buffers.slow_forces[id];
+                    if constexpr (PotentialParticle<ParticleType>) {
+                        particle.potential = buffers.slow_potentials[id];
+                    }
+                };
+
+                parallel::parallel_for(
+                    pool,
+                    0,
+                    Options.particle_count,
+                    KICK_DRIFT_GRAIN,
+                    restore_slow_force
+                );
+            }
+        }  // namespace detail
+    }      // namespace integrators
+}  // namespace nbs
+
+template <
+    size_t                             Dimensions,
+    nbs::ClusteredParticle<Dimensions> ParticleType,
+    nbs::integrators::RespaOptions     Options,
+    typename FastForceCalculator,
+    typename SlowForceCalculator>
+void nbs::integrators::initialise_respa(
+    IN OUT ParticleType*                   particles,
+    FastForceCalculator&&                  calculate_fast_forces,
+    SlowForceCalculator&&                  calculate_slow_forces,
+    OUT RespaBuffers<Dimensions, Options>& buffers,
+    parallel::ThreadPool*                  pool /*= nullptr*/
+) {
+    calculate_fast_forces();
+
+    parallel::parallel_for(
+        pool,
+        0,
+        Options.particle_count,
+        KICK_DRIFT_GRAIN,
+        [&](size_t idx) { detail::store_fast_force(particles[idx], buffers); }
+    );
+
+    if (detail::calculate_slow_forces(calculate_slow_forces)) {
+        detail::recalculate_fast_forces(
+            particles, calculate_fast_forces, buffers, pool
+        );
+    }
+
+    parallel::parallel_for(
+        pool,
+        0,
+        Options.particle_count,
+        KICK_DRIFT_GRAIN,
+        [&](size_t idx) { detail::store_slow_force(particles[idx], buffers); }
+    );
+}
+
+template <
+    size_t                             Dimensions,
+    nbs::ClusteredParticle<Dimensions> ParticleType,
+    nbs::integrators::RespaOptions     Options,
+    typename FastForceCalculator,
+    typename SlowForceCalculator>
+void nbs::integrators::respa_step(
+    IN OUT ParticleType*                             particles,
+    NBS_PRECISION                                    time_step,
+    FastForceCalculator&&                            calculate_fast_forces,
+    SlowForceCalculator&&                            calculate_slow_forces,
+    IN OUT RespaBuffers<Dimensions, Options>&        buffers,
+    parallel::ThreadPool*                            pool /*= nullptr*/,
+    diagnostics::DiagnosticsAccumulator<Dimensions>* diagnostics /*= nullptr*/
+) {
+    static_assert(
+        DynamicParticle<ParticleType, Dimensions>,
+        "RESPA particles must have force and velocity members."
+    );
+    static_assert(Options.substeps > 0, "RESPA must take at least one substep.");
+
+    constexpr size_t PARTICLE_COUNT = Options.particle_count;
+
+    const NBS_PRECISION half_step = time_step / static_cast<NBS_PRECISION>(2);
+    const NBS_PRECISION substep
+        = time_step / static_cast<NBS_PRECISION>(Options.substeps);
+
+    /************
+       Opening half-kick under the slow forces, leaving particles with their fast
+       forces for the substeps.
+                                                         ************/
+
+    auto open_kick = [&](size_t idx) {
+        auto&        particle = particles[idx];
+        const size_t id       = particle.cluster_metadata_idx;
+
+        particle.velocity += buffers.slow_forces[id] * (half_step / mass_of(particle));
+        particle.force     = buffers.fast_forces[id];
+    };
+
+    parallel::parallel_for(pool, 0, PARTICLE_COUNT, KICK_DRIFT_GRAIN, open_kick);
+
+    /************
+       Leapfrog substeps under the fast forces.
+                                  ************/
+
+    for (ui32 substep_idx = 0; substep_idx < Options.substeps; ++substep_idx) {
+        Leapfrog::step<Dimensions, ParticleType>(
+            particles, PARTICLE_COUNT, substep, calculate_fast_forces, pool
+        );
+    }
+
+    /************
+       Slow forces at the new positions, then the closing half-kick under them.
+                                                              ************/
+
+    parallel::parallel_for(
+        pool,
+        0,
+        PARTICLE_COUNT,
+        KICK_DRIFT_GRAIN,
+        [&](size_t idx) { detail::store_fast_force(particles[idx], buffers); }
+    );
+
+    // The fast forces of the last substep fall under the old split if the slow
+    // forces have changed it.
+    if (detail::calculate_slow_forces(calculate_slow_forces)) {
+        detail::recalculate_fast_forces(
+            particles, calculate_fast_forces, buffers, pool
+        );
+    }
+
+    auto close_kick = [&](size_t idx) {
+        auto& particle = particles[idx];
+
+        particle.velocity += particle.force * (half_step / mass_of(particle));
+
+        detail::store_slow_force(particle, buffers);
+    };
+
+    if (diagnostics == nullptr) {
+        parallel::parallel_for(pool, 0, PARTICLE_COUNT, KICK_DRIFT_GRAIN, close_kick);
+        return;
+    }
+
+    constexpr size_t block_size = diagnostics::DIAGNOSTICS_BLOCK_SIZE;
+
+    assert(PARTICLE_COUNT <= diagnostics->block_count * block_size);
+
+    diagnostics::reset_diagnostics_accumulator(*diagnostics);
+
+    // As for kick, a block at a time so each block is summed in particle order.
+    auto close_kick_and_measure_block = [&](size_t block_idx) {
+        const size_t block_begin = block_idx * block_size;
+        const size_t block_end   = std::min(block_begin + block_size, PARTICLE_COUNT);
+
+        diagnostics::Diagnostics<Dimensions>& sums
+            = diagnostics->block_sums[block_idx];
+
+        for (size_t idx = block_begin; idx < block_end; ++idx) {
+            close_kick(idx);
+
+            diagnostics::accumulate_particle_diagnostics<Dimensions>(
+                sums, particles[idx]
+            );
+        }
+    };
+
+    const size_t block_count = (PARTICLE_COUNT + block_size - 1) / block_size;
+
+    parallel::parallel_for(pool, 0, block_count, 1, close_kick_and_measure_block);
+}
@@ -0,0 +1,45 @@
+#ifndef N_BODY_SIM_INTEGRATORS_VELOCITY_VERLET_HPP
+#define N_BODY_SIM_INTEGRATORS_VELOCITY_VERLET_HPP
+
+#pragma once
+
+#include "integrators/kick_drift.hpp"
+
+namespace nbs {
+    namespace integrators {
+        /**
+         * \brief Velocity Verlet, x += v dt + a dt^2 / 2 then v += (a + a') dt / 2.
+         *
+         * The same trajectory as kick-drift-kick leapfrog, but the opening
+         * half-kick and the drift are fused into a single pass over the particles.
+         * As for Leapfrog, forces must be current on entry to step.
+         */
+        struct VelocityVerlet {
+            /**
+             * \brief Advances particles by time_step. calculate_forces is called
+             * once, and must overwrite the force of every particle from their
+             * current positions, and their potential if diagnostics are to
+             * include potential energy.
+             *
+             * If diagnostics is given, the diagnostics of the particles at the end of
+             * the step are accumulated into it by the last kick.
+             */
+            template <
+                size_t                      Dimensions,
+                DynamicParticle<Dimensions> ParticleType,
+                typename ForceCalculator>
+            static void step(
+                IN OUT ParticleType*                             particles,
+                size_t                                           particle_count,
+                NBS_PRECISION                                    time_step,
+                ForceCalculator&&                                calculate_forces,
+                parallel::ThreadPool*                            pool        = nullptr,
+                diagnostics::DiagnosticsAccumulator<Dimensions>* diagnostics = nullptr
+            );
+        };
+    }  // namespace integrators
+}  // namespace nbs
+
+#include "velocity_verlet.inl"
+
+#endif  // N_BODY_SIM_INTEGRATORS_VELOCITY_VERLET_HPP
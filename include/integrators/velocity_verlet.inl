@@ -0,0 +1,29 @@
+template <
+    size_t                           Dimensions,
+    nbs::DynamicParticle<Dimensions> ParticleType,
+    typename ForceCalculator>
+void nbs::integrators::VelocityVerlet::step(
+    IN OUT ParticleType*                             particles,
+    size_t                                           particle_count,
+    NBS_PRECISION                                    time_step,
+    ForceCalculator&&                                calculate_forces,
+    parallel::ThreadPool*                            pool /*= nullptr*/,
+    diagnostics::DiagnosticsAccumulator<Dimensions>* diagnostics /*= nullptr*/
+) {
+    const NBS_PRECISION half_step = time_step / static_cast<NBS_PRECISION>(2);
+
+    auto advance_particle = [particles, time_step, half_step](size_t idx) {
+        auto& particle = particles[idx];
+
+        particle.velocity += particle.force * (half_step / mass_of(particle));
+        particle.position += particle.velocity * time_step;
+    };
+
+    parallel::parallel_for(pool, 0, particle_count, KICK_DRIFT_GRAIN, advance_particle);
+
+    calculate_forces();
+
+    kick<Dimensions, ParticleType>(
+        particles, particle_count, half_step, pool, diagnostics
+    );
+}
@@ -0,0 +1,50 @@
+#ifndef N_BODY_SIM_INTEGRATORS_YOSHIDA_HPP
+#define N_BODY_SIM_INTEGRATORS_YOSHIDA_HPP
+
+#pragma once
+
+#include "integrators/leapfrog.hpp"
+
+namespace nbs {
+    namespace integrators {
+        /**
+         * \brief Yoshida's fourth order symplectic integrator, three leapfrog steps
+         * of w1 dt, w0 dt and w1 dt, where w1 = 1 / (2 - 2^(1/3)) and
+         * w0 = 1 - 2 w1.
+         *
+         * Costs three force evaluations a step rather than one, but its error
+         * falls as dt^4 so much larger steps can be taken for the same energy
+         * error. As for Leapfrog, forces must be current on entry to step.
+         */
+        struct Yoshida4 {
+            static constexpr f64 W1 = 1.3512071919596578;
+            static constexpr f64 W0 = -1.7024143839193155;
+
+            /**
+             * \brief Advances particles by time_step. calculate_forces is called
+             * three times, and must overwrite the force of every particle from their
+             * current positions, and their potential if diagnostics are to
+             * include potential energy.
+             *
+             * If diagnostics is given, the diagnostics of the particles at the end of
+             * the step are accumulated into it by the last kick.
+             */
+            template <
+                size_t                      Dimensions,
+                DynamicParticle<Dimensions> ParticleType,
+                typename ForceCalculator>
+            static void step(
+                IN OUT ParticleType*                             particles,
+                size_t                                           particle_count,
+                NBS_PRECISION                                    time_step,
+                ForceCalculator&&                                calculate_forces,
+                parallel::ThreadPool*                            pool        = nullptr,
+                diagnostics::DiagnosticsAccumulator<Dimensions>* diagnostics = nullptr
+            );
+        };
+    }  // namespace integrators
+}  // namespace nbs
+
+#include "yoshida.inl"
+
+#endif  // N_BODY_SIM_INTEGRATORS_YOSHIDA_HPP
@@ -0,0 +1,25 @@
+template <
+    size_t                           Dimensions,
+    nbs::DynamicParticle<Dimensions> ParticleType,
+    typename ForceCalculator>
+void nbs::integrators::Yoshida4::step(
+    IN OUT ParticleType*                             particles,
+    size_t                                           particle_count,
+    NBS_PRECISION                                    time_step,
+    ForceCalculator&&                                calculate_forces,
+    parallel::ThreadPool*                            pool /*= nullptr*/,
+    diagnostics::DiagnosticsAccumulator<Dimensions>* diagnostics /*= nullptr*/
+) {
+    const NBS_PRECISION outer_step = static_cast<NBS_PRECISION>(W1) * time_step;
+    const NBS_PRECISION inner_step = static_cast<NBS_PRECISION>(W0) * time_step;
+
+    Leapfrog::step<Dimensions, ParticleType>(
+        particles, particle_count, outer_step, calculate_forces, pool
+    );
+    Leapfrog::step<Dimensions, ParticleType>(
+        particles, particle_count, inner_step, calculate_forces, pool
+    );
+    Leapfrog::step<Dimensions, ParticleType>(
+        particles, particle_count, outer_step, calculate_forces, pool, diagnostics
+    );
+}
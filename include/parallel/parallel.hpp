@@ -0,0 +1,4 @@
+#include "reduce.hpp"
+#include "scan.hpp"
+#include "task_group.hpp"
+#include "thread_pool.hpp"
@@ -0,0 +1,52 @@
+#ifndef N_BODY_SIM_PARALLEL_REDUCE_HPP
+#define N_BODY_SIM_PARALLEL_REDUCE_HPP
+
+#pragma once
+
+#include "parallel/thread_pool.hpp"
+
+namespace nbs {
+    namespace parallel {
+        // Most chunks parallel_reduce cuts a range into, so that their partials fit
+        // on the stack.
+        constexpr size_t MAX_REDUCE_CHUNKS = 256;
+
+        /**
+         * \brief Combines values pairwise in a tree whose shape depends only on
+         * count, overwriting values. Returns identity if count is zero.
+         */
+        template <typename Type, typename Combine>
+        Type tree_reduce(
+            IN OUT Type* values, size_t count, Type identity, Combine&& combine
+        );
+
+        /**
+         * \brief Reduces func(idx) over each idx in [begin, end) with combine,
+         * starting from identity, on the threads of pool. Runs serially if pool is
+         * null. As with parallel_for, func may also accept the index of the calling
+         * worker.
+         *
+         * The range is cut into chunks of grain indices, widened if need be so that
+         * there are no more than MAX_REDUCE_CHUNKS, each reduced in index order, and
+         * the partials of the chunks are combined by tree_reduce. The order of every
+         * combination is so fixed by the range and grain alone, and results are
+         * bit-identical for any number of threads, including none. combine must
+         * still be associative for results to match a serial loop. Type must be
+         * default constructible.
+         */
+        template <typename Type, typename Func, typename Combine>
+        Type parallel_reduce(
+            ThreadPool* pool,
+            size_t      begin,
+            size_t      end,
+            size_t      grain,
+            Type        identity,
+            Func&&      func,
+            Combine&&   combine
+        );
+    }  // namespace parallel
+}  // namespace nbs
+
+#include "reduce.inl"
+
+#endif  // N_BODY_SIM_PARALLEL_REDUCE_HPP
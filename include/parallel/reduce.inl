@@ -0,0 +1,61 @@
+template <typename Type, typename Combine>
+Type nbs::parallel::tree_reduce(
+    IN OUT Type* values, size_t count, Type identity, Combine&& combine
+) {
+    if (count == 0) return identity;
+
+    for (size_t stride = 1; stride < count; stride *= 2) {
+        for (size_t idx = 0; idx + stride < count; idx += 2 * stride) {
+            values[idx] = combine(values[idx], values[idx + stride]);
+        }
+    }
+
+    return values[0];
+}
+
+template <typename Type, typename Func, typename Combine>
+Type nbs::parallel::parallel_reduce(
+    ThreadPool* pool,
+    size_t      begin,
+    size_t      end,
+    size_t      grain,
+    Type        identity,
+    Func&&      func,
+    Combine&&   combine
+) {
+    auto reduce_chunk = [&](size_t chunk_begin, size_t chunk_end, ui32 worker_idx) {
+        Type result = identity;
+        for (size_t idx = chunk_begin; idx < chunk_end; ++idx) {
+            if constexpr (std::is_invocable_v<Func, size_t, ui32>) {
+                result = combine(result, func(idx, worker_idx));
+            } else {
+                result = combine(result, func(idx));
+            }
+        }
+        return result;
+    };
+
+    if (end <= begin) return identity;
+
+    const size_t count = end - begin;
+
+    grain = std::max(grain, static_cast<size_t>(1));
+    grain = std::max(grain, (count + MAX_REDUCE_CHUNKS - 1) / MAX_REDUCE_CHUNKS);
+
+    const size_t chunk_count = (count + grain - 1) / grain;
+
+    if (chunk_count == 1) {
+        return reduce_chunk(begin, end, detail::serial_worker_idx(pool));
+    }
+
+    std::array<Type, MAX_REDUCE_CHUNKS> partials;
+
+    parallel_for(pool, 0, chunk_count, 1, [&](size_t chunk_idx, ui32 worker_idx) {
+        const size_t chunk_begin = begin + chunk_idx * grain;
+        const size_t chunk_end   = std::min(chunk_begin + grain, end);
+
+        partials[chunk_idx] = reduce_chunk(chunk_begin, chunk_end, worker_idx);
+    });
+
+    return tree_reduce(partials.data(), chunk_count, identity, combine);
+}
@@ -0,0 +1,63 @@
+#ifndef N_BODY_SIM_PARALLEL_SCAN_HPP
+#define N_BODY_SIM_PARALLEL_SCAN_HPP
+
+#pragma once
+
+#include "parallel/thread_pool.hpp"
+
+namespace nbs {
+    namespace parallel {
+        /**
+         * \brief Number of blocks a scan of count elements in blocks of grain is
+         * made in, and so the size of the block scratch it needs.
+         */
+        constexpr size_t scan_block_count(size_t count, size_t grain) {
+            grain = std::max(grain, static_cast<size_t>(1));
+
+            return (count + grain - 1) / grain;
+        }
+
+        /**
+         * \brief Writes to output[idx] the combination of input[0] through
+         * input[idx], starting from identity, on the threads of pool. Runs serially
+         * if pool is null. input and output may be the same array.
+         *
+         * Scans in blocks of grain elements: each block is reduced in parallel, the
+         * block totals are scanned serially, then each block is scanned in parallel
+         * from its offset. Blocks depend only on grain, so results do not depend on
+         * the number of threads. block_scratch must hold scan_block_count(count,
+         * grain) elements, so that scanning allocates nothing.
+         */
+        template <typename Type, typename Combine>
+        void parallel_inclusive_scan(
+            ThreadPool*  pool,
+            const Type*  input,
+            OUT Type*    output,
+            size_t       count,
+            size_t       grain,
+            Type         identity,
+            Combine&&    combine,
+            IN OUT Type* block_scratch
+        );
+
+        /**
+         * \brief As parallel_inclusive_scan, but output[idx] combines input[0]
+         * through input[idx - 1], output[0] being identity.
+         */
+        template <typename Type, typename Combine>
+        void parallel_exclusive_scan(
+            ThreadPool*  pool,
+            const Type*  input,
+            OUT Type*    output,
+            size_t       count,
+            size_t       grain,
+            Type         identity,
+            Combine&&    combine,
+            IN OUT Type* block_scratch
+        );
+    }  // namespace parallel
+}  // namespace nbs
+
+#include "scan.inl"
+
+#endif  // N_BODY_SIM_PARALLEL_SCAN_HPP
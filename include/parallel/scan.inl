@@ -0,0 +1,100 @@
+namespace nbs {
+    namespace parallel {
+        namespace detail {
+            template <bool Inclusive, typename Type, typename Combine>
+            void scan(
+                ThreadPool*  pool,
+                const Type*  input,
+                OUT Type*    output,
+                size_t       count,
+                size_t       grain,
+                Type         identity,
+                Combine&     combine,
+                IN OUT Type* block_offsets
+            ) {
+                // Scans [begin, end) on from running, which it returns advanced.
+                auto scan_block = [&](size_t begin, size_t end, Type running) {
+                    for (size_t idx = begin; idx < end; ++idx) {
+                        const Type value = input[idx];
+                        if constexpr (Inclusive) {
+                            running     = combine(running, value);
+                            output[idx] = running;
+                        } else {
+                            output[idx] = running;
+                            running     = combine(running, value);
+                        }
+                    }
+                    return running;
+                };
+
+                grain = std::max(grain, static_cast<size_t>(1));
+
+                // Serially too blocks are scanned as they would be in parallel, for
+                // the same result.
+                if (count <= grain) {
+                    scan_block(0, count, identity);
+                    return;
+                }
+
+                const size_t block_count = scan_block_count(count, grain);
+
+                parallel_for(pool, 0, block_count, 1, [&](size_t block_idx) {
+                    const size_t end = std::min((block_idx + 1) * grain, count);
+
+                    Type total = identity;
+                    for (size_t idx = block_idx * grain; idx < end; ++idx) {
+                        total = combine(total, input[idx]);
+                    }
+                    block_offsets[block_idx] = total;
+                });
+
+                Type running = identity;
+                for (size_t block_idx = 0; block_idx < block_count; ++block_idx) {
+                    const Type total         = block_offsets[block_idx];
+                    block_offsets[block_idx] = running;
+                    running                  = combine(running, total);
+                }
+
+                parallel_for(pool, 0, block_count, 1, [&](size_t block_idx) {
+                    scan_block(
+                        block_idx * grain,
+                        std::min((block_idx + 1) * grain, count),
+                        block_offsets[block_idx]
+                    );
+                });
+            }
+        }  // namespace detail
+    }      // namespace parallel
+}  // namespace nbs
+
+template <typename Type, typename Combine>
+void nbs::parallel::parallel_inclusive_scan(
+    ThreadPool*  pool,
+    const Type*  input,
+    OUT Type*    output,
+    size_t       count,
+    size_t       grain,
+    Type         identity,
+    Combine&&    combine,
+    IN OUT Type* block_scratch
+) {
+    detail::scan<true>(
+        pool, input, output, count, grain, identity, combine, block_scratch
+    );
+}
+
+template <typename Type, typename Combine>
+void nbs::parallel::parallel_exclusive_scan(
+    ThreadPool*  pool,
+    const Type*  input,
+    OUT Type*    output,
+    size_t       count,
+    size_t       grain,
+    Type         identity,
+    Combine&&    combine,
+    IN OUT Type* block_scratch
+) {
+    detail::scan<false>(
+        pool, input, output, count, grain, identity, combine, block_scratch
+    );
+}
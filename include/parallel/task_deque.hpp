@@ -0,0 +1,63 @@
+#ifndef N_BODY_SIM_PARALLEL_TASK_DEQUE_HPP
+#define N_BODY_SIM_PARALLEL_TASK_DEQUE_HPP
+
+#pragma once
+
+namespace nbs {
+    namespace parallel {
+        namespace detail {
+            /**
+             * \brief A unit of work for the pool's workers to steal, run as
+             * invoke(context, begin, end, worker_idx). Tasks point at state owned by
+             * whoever spawned them, so queueing one does not allocate. pending is
+             * decremented once the task has run.
+             */
+            struct Task {
+                using Invoker = void (*)(void*, size_t, size_t, ui32);
+
+                Invoker              invoke;
+                void*                context;
+                size_t               begin;
+                size_t               end;
+                std::atomic<size_t>* pending;
+            };
+
+            void run_task(const Task& task, ui32 worker_idx);
+
+            /**
+             * \brief Fixed capacity deque of tasks belonging to one worker. The owner
+             * pushes and pops newest first, staying in cache with the work it just
+             * split off, while thieves steal oldest first, taking the largest pieces
+             * of work.
+             */
+            class alignas(64) TaskDeque {
+            public:
+                static constexpr size_t CAPACITY = 256;
+
+                TaskDeque();
+
+                NBS_NON_COPYABLE(TaskDeque);
+                NBS_NON_MOVABLE(TaskDeque);
+
+                // False if full, in which case the caller should run task itself.
+                bool push(const Task& task);
+                bool pop(OUT Task& task);
+                bool steal(OUT Task& task);
+
+                // Whether the deque was empty at some recent point, without locking.
+                bool empty() const {
+                    return m_size.load(std::memory_order_relaxed) == 0;
+                }
+            protected:
+                std::mutex          m_mutex;
+                Task                m_tasks[CAPACITY];
+                size_t              m_front;
+                std::atomic<size_t> m_size;
+            };
+        }  // namespace detail
+    }      // namespace parallel
+}  // namespace nbs
+
+#include "task_deque.inl"
+
+#endif  // N_BODY_SIM_PARALLEL_TASK_DEQUE_HPP
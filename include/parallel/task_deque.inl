@@ -0,0 +1,47 @@
+inline void nbs::parallel::detail::run_task(const Task& task, ui32 worker_idx) {
+    task.invoke(task.context, task.begin, task.end, worker_idx);
+    task.pending->fetch_sub(1, std::memory_order_release);
+}
+
+inline nbs::parallel::detail::TaskDeque::TaskDeque() : m_front(0), m_size(0) {}
+
+inline bool nbs::parallel::detail::TaskDeque::push(const Task& task) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const size_t size = m_size.load(std::memory_order_relaxed);
+    if (size == CAPACITY) return false;
+
+    m_tasks[(m_front + size) % CAPACITY] = task;
+    m_size.store(size + 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+inline bool nbs::parallel::detail::TaskDeque::pop(OUT Task& task) {
+    if (empty()) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const size_t size = m_size.load(std::memory_order_relaxed);
+    if (size == 0) return false;
+
+    task = m_tasks[(m_front + size - 1) % CAPACITY];
+    m_size.store(size - 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+inline bool nbs::parallel::detail::TaskDeque::steal(OUT Task& task) {
+    if (empty()) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const size_t size = m_size.load(std::memory_order_relaxed);
+    if (size == 0) return false;
+
+    task    = m_tasks[m_front];
+    m_front = (m_front + 1) % CAPACITY;
+    m_size.store(size - 1, std::memory_order_relaxed);
+
+    return true;
+}
@@ -0,0 +1,53 @@
+#ifndef N_BODY_SIM_PARALLEL_TASK_GROUP_HPP
+#define N_BODY_SIM_PARALLEL_TASK_GROUP_HPP
+
+#pragma once
+
+#include "parallel/thread_pool.hpp"
+
+namespace nbs {
+    namespace parallel {
+        /**
+         * \brief Fork-join group of tasks on a pool. Tasks spawned on the group are
+         * queued for the pool's workers to steal, and wait runs queued tasks until
+         * every task of the group has finished. Groups nest, tasks may spawn and
+         * wait on groups of their own.
+         *
+         * Tasks only run in parallel within run_tasks, or a parallel_for, on the
+         * same pool. Elsewhere, or without a pool, spawn runs each task on the spot.
+         */
+        class TaskGroup {
+        public:
+            TaskGroup(ThreadPool* pool);
+            ~TaskGroup();
+
+            NBS_NON_COPYABLE(TaskGroup);
+            NBS_NON_MOVABLE(TaskGroup);
+
+            /**
+             * \brief Spawns func(worker_idx) as a task. The task refers to func
+             * rather than copying it, so func must live until wait returns.
+             */
+            template <typename Func>
+            void spawn(Func& func);
+
+            void wait();
+        protected:
+            ThreadPool*         m_pool;
+            std::atomic<size_t> m_pending;
+        };
+
+        /**
+         * \brief Runs root(worker_idx) with the threads of pool stealing tasks it
+         * spawns, returning once root has and every task is done. Safe to call from
+         * within a job of the same pool, in which case root runs directly on the
+         * calling worker. Runs root(0) serially if pool is null.
+         */
+        template <typename Root>
+        void run_tasks(ThreadPool* pool, Root&& root);
+    }  // namespace parallel
+}  // namespace nbs
+
+#include "task_group.inl"
+
+#endif  // N_BODY_SIM_PARALLEL_TASK_GROUP_HPP
@@ -0,0 +1,41 @@
+inline nbs::parallel::TaskGroup::TaskGroup(ThreadPool* pool) :
+    m_pool(pool), m_pending(0) {}
+
+inline nbs::parallel::TaskGroup::~TaskGroup() {
+    wait();
+}
+
+template <typename Func>
+void nbs::parallel::TaskGroup::spawn(Func& func) {
+    auto invoke = [](void* func_ptr, size_t, size_t, ui32 worker_idx) {
+        (*static_cast<Func*>(func_ptr))(worker_idx);
+    };
+
+    if (m_pool == nullptr || detail::current_pool != m_pool) {
+        func(0);
+        return;
+    }
+
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    m_pool->spawn(
+        detail::Task{ invoke, static_cast<void*>(&func), 0, 0, &m_pending },
+        detail::current_worker_idx
+    );
+}
+
+inline void nbs::parallel::TaskGroup::wait() {
+    if (m_pool == nullptr || m_pending.load(std::memory_order_acquire) == 0) return;
+
+    m_pool->help_until_done(m_pending, detail::current_worker_idx);
+}
+
+template <typename Root>
+void nbs::parallel::run_tasks(ThreadPool* pool, Root&& root) {
+    if (pool == nullptr) {
+        root(0);
+    } else if (detail::current_pool == pool) {
+        root(detail::current_worker_idx);
+    } else {
+        pool->run_tasks(root);
+    }
+}
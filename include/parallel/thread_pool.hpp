@@ -0,0 +1,132 @@
+#ifndef N_BODY_SIM_PARALLEL_THREAD_POOL_HPP
+#define N_BODY_SIM_PARALLEL_THREAD_POOL_HPP
+
+#pragma once
+
+#include "parallel/task_deque.hpp"
+
+namespace nbs {
+    namespace parallel {
+        class ThreadPool;
+
+        namespace detail {
+            // Pool whose job the calling thread is running, if any, and as which
+            // worker.
+            inline thread_local ThreadPool* current_pool       = nullptr;
+            inline thread_local ui32        current_worker_idx = 0;
+
+            // Worker the calling thread runs as for work of pool done serially: the
+            // worker it already is if running a job of pool, so that it does not
+            // share worker zero's scratch, else zero.
+            inline ui32 serial_worker_idx(const ThreadPool* pool) {
+                return current_pool == pool ? current_worker_idx : 0;
+            }
+        }  // namespace detail
+
+        enum class ThreadAffinity {
+            // Workers run wherever the OS schedules them.
+            NONE,
+            // Each spawned worker is pinned to its own core, worker N to core N, so
+            // per-worker scratch stays in that core's cache. The calling thread, as
+            // worker zero, is left unpinned. Only supported on Linux, elsewhere the
+            // same as NONE.
+            PIN_TO_CORES
+        };
+
+        /**
+         * \brief Persistent pool of worker threads. The calling thread participates
+         * as worker zero, so a pool of N threads spawns N - 1 workers.
+         */
+        class ThreadPool {
+        public:
+            ThreadPool(
+                ui32           thread_count = std::thread::hardware_concurrency(),
+                ThreadAffinity affinity     = ThreadAffinity::NONE
+            );
+            ~ThreadPool();
+
+            NBS_NON_COPYABLE(ThreadPool);
+            NBS_NON_MOVABLE(ThreadPool);
+
+            ui32 thread_count() const { return m_thread_count; }
+
+            /**
+             * \brief Runs job(worker_idx) once on every thread of the pool and blocks
+             * until all have returned. The job is not copied, so running it does not
+             * allocate.
+             */
+            template <typename Job>
+            void run(Job& job);
+
+            /**
+             * \brief Runs root(0) on the calling thread while the other workers
+             * steal and run tasks spawned from it, until root returns. root must
+             * wait on every task it spawns.
+             */
+            template <typename Root>
+            void run_tasks(Root& root);
+
+            /************
+               Work stealing, as used by parallel_for and TaskGroup. Each worker
+               queues tasks it spawns in its own deque, which idle workers steal
+               from.
+                     ************/
+
+            // Queues task on worker_idx's deque, or runs it if the deque is full.
+            void spawn(const detail::Task& task, ui32 worker_idx);
+
+            // Runs one task of worker_idx's own or, failing that, one stolen from
+            // another worker. False if no task was found.
+            bool try_run_task(ui32 worker_idx);
+
+            // Runs tasks until pending falls to zero.
+            void help_until_done(const std::atomic<size_t>& pending, ui32 worker_idx);
+
+            bool has_queued_tasks(ui32 worker_idx) const {
+                return !m_deques[worker_idx].empty();
+            }
+        protected:
+            using JobInvoker = void (*)(void*, ui32);
+
+            void run(void* job, JobInvoker invoke);
+
+            void worker_loop(ui32 worker_idx);
+
+            ui32                     m_thread_count;
+            std::vector<std::thread> m_workers;
+            detail::TaskDeque*       m_deques;
+
+            std::mutex              m_mutex;
+            std::condition_variable m_job_available;
+            std::condition_variable m_job_complete;
+
+            void*      m_job;
+            JobInvoker m_invoke;
+            ui64       m_generation;
+            ui32       m_pending;
+            bool       m_stopping;
+        };
+
+        /**
+         * \brief Calls func(idx) for each idx in [begin, end) on the threads of
+         * pool. Runs serially if pool is null. If func accepts it, the index of the
+         * calling worker is passed as a second argument, e.g. to select per-worker
+         * scratch space.
+         *
+         * Workers split their range in half whenever their deque runs dry, queueing
+         * the back half for idle workers to steal, so ranges are only split as
+         * finely as load balance needs, but never below grain indices. Called from
+         * within a job of the same pool, e.g. from the body of another
+         * parallel_for, the range is spread over the workers already running
+         * rather than blocking on them.
+         */
+        template <typename Func>
+        void parallel_for(
+            ThreadPool* pool, size_t begin, size_t end, size_t grain, Func&& func
+        );
+    }  // namespace parallel
+}  // namespace nbs
+
+#include "thread_pool.inl"
+
+#endif  // N_BODY_SIM_PARALLEL_THREAD_POOL_HPP
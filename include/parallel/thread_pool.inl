@@ -0,0 +1,252 @@
+namespace nbs {
+    namespace parallel {
+        namespace detail {
+            template <typename Invoke>
+            struct RangeContext {
+                ThreadPool*         pool;
+                size_t              grain;
+                Invoke*             invoke;
+                std::atomic<size_t> pending;
+            };
+
+            // Works through [begin, end) a grain at a time, splitting off the back
+            // half for thieves whenever this worker's deque is empty.
+            template <typename Invoke>
+            void run_range(
+                void* context_ptr, size_t begin, size_t end, ui32 worker_idx
+            ) {
+                auto& context = *static_cast<RangeContext<Invoke>*>(context_ptr);
+
+                while (begin < end) {
+                    if (end - begin > context.grain
+                        && !context.pool->has_queued_tasks(worker_idx))
+                    {
+                        const size_t middle = begin + (end - begin) / 2;
+
+                        context.pending.fetch_add(1, std::memory_order_relaxed);
+                        context.pool->spawn(
+                            Task{ &run_range<Invoke>,
+                                  context_ptr,
+                                  middle,
+                                  end,
+                                  &context.pending },
+                            worker_idx
+                        );
+
+                        end = middle;
+                        continue;
+                    }
+
+                    const size_t chunk_end = std::min(begin + context.grain, end);
+                    for (size_t idx = begin; idx < chunk_end; ++idx) {
+                        (*context.invoke)(idx, worker_idx);
+                    }
+                    begin = chunk_end;
+                }
+            }
+        }  // namespace detail
+    }      // namespace parallel
+}  // namespace nbs
+
+inline nbs::parallel::ThreadPool::ThreadPool(
+    ui32                            thread_count /*= hardware*/,
+    [[maybe_unused]] ThreadAffinity affinity /*= NONE*/
+) :
+    m_thread_count(std::max(thread_count, 1u)),
+    m_deques(new detail::TaskDeque[m_thread_count]),
+    m_job(nullptr),
+    m_invoke(nullptr),
+    m_generation(0),
+    m_pending(0),
+    m_stopping(false) {
+    m_workers.reserve(m_thread_count - 1);
+    for (ui32 worker_idx = 1; worker_idx < m_thread_count; ++worker_idx) {
+        m_workers.emplace_back([this, worker_idx]() { worker_loop(worker_idx); });
+    }
+
+#if defined(__linux__)
+    if (affinity == ThreadAffinity::PIN_TO_CORES) {
+        const ui32 core_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+        for (ui32 worker_idx = 1; worker_idx < m_thread_count; ++worker_idx) {
+            cpu_set_t cores;
+            CPU_ZERO(&cores);
+            CPU_SET(worker_idx % core_count, &cores);
+
+            pthread_setaffinity_np(
+                m_workers[worker_idx - 1].native_handle(), sizeof(cpu_set_t), &cores
+            );
+        }
+    }
+#endif
+}
+
+inline nbs::parallel::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_job_available.notify_all();
+
+    for (auto& worker : m_workers) worker.join();
+
+    delete[] m_deques;
+}
+
+template <typename Job>
+void nbs::parallel::ThreadPool::run(Job& job) {
+    run(static_cast<void*>(&job), [](void* job_ptr, ui32 worker_idx) {
+        (*static_cast<Job*>(job_ptr))(worker_idx);
+    });
+}
+
+template <typename Root>
+void nbs::parallel::ThreadPool::run_tasks(Root& root) {
+    std::atomic<bool> root_done = false;
+
+    auto job = [&](ui32 worker_idx) {
+        if (worker_idx == 0) {
+            root(worker_idx);
+            root_done.store(true, std::memory_order_release);
+            return;
+        }
+
+        while (!root_done.load(std::memory_order_acquire)) {
+            if (!try_run_task(worker_idx)) std::this_thread::yield();
+        }
+    };
+
+    run(job);
+}
+
+inline void
+nbs::parallel::ThreadPool::spawn(const detail::Task& task, ui32 worker_idx) {
+    if (!m_deques[worker_idx].push(task)) detail::run_task(task, worker_idx);
+}
+
+inline bool nbs::parallel::ThreadPool::try_run_task(ui32 worker_idx) {
+    detail::Task task;
+
+    bool found = m_deques[worker_idx].pop(task);
+    for (ui32 offset = 1; !found && offset < m_thread_count; ++offset) {
+        found = m_deques[(worker_idx + offset) % m_thread_count].steal(task);
+    }
+
+    if (!found) return false;
+
+    detail::run_task(task, worker_idx);
+
+    return true;
+}
+
+inline void nbs::parallel::ThreadPool::help_until_done(
+    const std::atomic<size_t>& pending, ui32 worker_idx
+) {
+    while (pending.load(std::memory_order_acquire) != 0) {
+        if (!try_run_task(worker_idx)) std::this_thread::yield();
+    }
+}
+
+inline void nbs::parallel::ThreadPool::run(void* job, JobInvoker invoke) {
+    // The calling thread is worker zero for the job's duration, restoring whatever
+    // pool it was working for after.
+    ThreadPool* const outer_pool       = detail::current_pool;
+    const ui32        outer_worker_idx = detail::current_worker_idx;
+
+    detail::current_pool       = this;
+    detail::current_worker_idx = 0;
+
+    if (m_thread_count == 1) {
+        invoke(job, 0);
+
+        detail::current_pool       = outer_pool;
+        detail::current_worker_idx = outer_worker_idx;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job     = job;
+        m_invoke  = invoke;
+        m_pending = m_thread_count - 1;
+        ++m_generation;
+    }
+    m_job_available.notify_all();
+
+    invoke(job, 0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_job_complete.wait(lock, [this]() { return m_pending == 0; });
+    m_job    = nullptr;
+    m_invoke = nullptr;
+
+    detail::current_pool       = outer_pool;
+    detail::current_worker_idx = outer_worker_idx;
+}
+
+inline void nbs::parallel::ThreadPool::worker_loop(ui32 worker_idx) {
+    detail::current_pool       = this;
+    detail::current_worker_idx = worker_idx;
+
+    ui64 seen_generation = 0;
+
+    while (true) {
+        void*      job;
+        JobInvoker invoke;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_job_available.wait(lock, [this, &seen_generation]() {
+                return m_stopping || m_generation != seen_generation;
+            });
+
+            if (m_stopping) return;
+
+            seen_generation = m_generation;
+            job             = m_job;
+            invoke          = m_invoke;
+        }
+
+        invoke(job, worker_idx);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pending == 0) m_job_complete.notify_one();
+        }
+    }
+}
+
+template <typename Func>
+void nbs::parallel::parallel_for(
+    ThreadPool* pool, size_t begin, size_t end, size_t grain, Func&& func
+) {
+    if (begin >= end) return;
+
+    auto invoke = [&func](size_t idx, ui32 worker_idx) {
+        if constexpr (std::is_invocable_v<Func, size_t, ui32>) {
+            func(idx, worker_idx);
+        } else {
+            func(idx);
+        }
+    };
+
+    grain = std::max(grain, static_cast<size_t>(1));
+
+    if (pool == nullptr || pool->thread_count() == 1 || end - begin <= grain) {
+        const ui32 worker_idx = detail::serial_worker_idx(pool);
+        for (size_t idx = begin; idx < end; ++idx) invoke(idx, worker_idx);
+        return;
+    }
+
+    detail::RangeContext<decltype(invoke)> context{ pool, grain, &invoke, 0 };
+
+    auto root = [&](ui32 worker_idx) {
+        detail::run_range<decltype(invoke)>(&context, begin, end, worker_idx);
+        pool->help_until_done(context.pending, worker_idx);
+    };
+
+    if (detail::current_pool == pool) {
+        root(detail::current_worker_idx);
+    } else {
+        pool->run_tasks(root);
+    }
+}
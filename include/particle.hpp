@@ -18,6 +18,45 @@ namespace nbs {
                                                      x.cluster_metadata_idx
                                                      } -> std::same_as<size_t&>;
                                              };
+
+    template <typename Candidate, size_t Dimensions>
+    concept ForceParticle
+        = Particle<Candidate, Dimensions>
+          && std::same_as<decltype(Candidate::force), vec<Dimensions, NBS_PRECISION>>;
+
+    template <typename Candidate, size_t Dimensions>
+    concept DynamicParticle
+        = ForceParticle<Candidate, Dimensions>
+          && std::same_as<
+              decltype(Candidate::velocity),
+              vec<Dimensions, NBS_PRECISION>>;
+
+    /**
+     * \brief Particles with a potential member are given their potential energy in
+     * the field of every other particle alongside their force, by laws that define
+     * one.
+     */
+    template <typename Candidate>
+    concept PotentialParticle = requires (Candidate x) {
+                                    { x.potential } -> std::same_as<NBS_PRECISION&>;
+                                };
+
+    template <typename Candidate>
+    concept MassiveParticle = requires (Candidate x) {
+                                  { x.mass } -> std::same_as<NBS_PRECISION&>;
+                              };
+
+    /**
+     * \brief Mass of a particle, particles without a mass member are unit mass.
+     */
+    template <typename ParticleType>
+    inline NBS_PRECISION mass_of(const ParticleType& particle) {
+        if constexpr (MassiveParticle<ParticleType>) {
+            return particle.mass;
+        } else {
+            return static_cast<NBS_PRECISION>(1);
+        }
+    }
 }  // namespace nbs
 
 #endif  // N_BODY_SIM_PARTICLE_HPP
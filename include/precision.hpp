@@ -1,7 +1,27 @@
+// Precision particle state is stored in. Mixed precision stores it in double
+// precision, so large coordinates keep the precision of the differences between them.
 #if !defined(NBS_PRECISION)
-#  if defined(NBS_USE_DOUBLE_PRECISION)
+#  if defined(NBS_USE_DOUBLE_PRECISION) || defined(NBS_USE_MIXED_PRECISION)
 #    define NBS_PRECISION nbs::f64
 #  else
 #    define NBS_PRECISION nbs::f32
 #  endif
 #endif
+
+// Precision the direct force kernels compute in. Mixed precision computes in single
+// precision, on positions taken relative to a nearby origin, so as not to halve SIMD
+// throughput.
+#if !defined(NBS_COMPUTE_PRECISION)
+#  if defined(NBS_USE_MIXED_PRECISION)
+#    define NBS_COMPUTE_PRECISION nbs::f32
+#  else
+#    define NBS_COMPUTE_PRECISION NBS_PRECISION
+#  endif
+#endif
+
+// Precision sums over many particles, such as of positions for centroids, are
+// accumulated in. Single precision sums of millions of particles lose most of their
+// digits, while the sums are too few to be worth their SIMD width.
+#if !defined(NBS_ACCUMULATION_PRECISION)
+#  define NBS_ACCUMULATION_PRECISION nbs::f64
+#endif
@@ -0,0 +1,53 @@
+#ifndef N_BODY_SIM_SIMD_HPP
+#define N_BODY_SIM_SIMD_HPP
+
+#pragma once
+
+#if defined(__AVX2__)
+#  define NBS_SIMD_AVX2
+#endif
+
+// Batched kernels work in single precision lanes, so are only used when they compute
+// in single precision.
+#if defined(NBS_SIMD_AVX2)                                                             \
+    && (!defined(NBS_USE_DOUBLE_PRECISION) || defined(NBS_USE_MIXED_PRECISION))
+#  define NBS_SIMD_F32_KERNELS
+#endif
+
+namespace nbs {
+    namespace simd {
+#if defined(NBS_SIMD_AVX2)
+        constexpr size_t f32_width = 8;
+
+        /**
+         * \brief Reciprocal square root, refining the ~12-bit hardware estimate with
+         * one Newton-Raphson step to ~23 bits.
+         */
+        inline __m256 rsqrt(__m256 x) {
+            const __m256 estimate = _mm256_rsqrt_ps(x);
+            const __m256 half_x   = _mm256_mul_ps(_mm256_set1_ps(0.5f), x);
+
+            // y (1.5 - 0.5 x y^2)
+            return _mm256_mul_ps(
+                estimate,
+                _mm256_sub_ps(
+                    _mm256_set1_ps(1.5f),
+                    _mm256_mul_ps(half_x, _mm256_mul_ps(estimate, estimate))
+                )
+            );
+        }
+
+        inline f32 horizontal_sum(__m256 x) {
+            __m128 sum
+                = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+            sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+            sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+            return _mm_cvtss_f32(sum);
+        }
+#else
+        constexpr size_t f32_width = 1;
+#endif
+    }  // namespace simd
+}  // namespace nbs
+
+#endif  // N_BODY_SIM_SIMD_HPP
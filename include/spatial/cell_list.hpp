@@ -0,0 +1,176 @@
+#ifndef N_BODY_SIM_SPATIAL_CELL_LIST_HPP
+#define N_BODY_SIM_SPATIAL_CELL_LIST_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "parallel/reduce.hpp"
+#include "parallel/thread_pool.hpp"
+#include "spatial/options.hpp"
+#include "spatial/periodic.hpp"
+
+namespace nbs {
+    namespace spatial {
+        struct NeighbourListCounters {
+            // Times neighbour lists have been brought up to date.
+            size_t updates;
+            // Times neighbour lists have been built.
+            size_t rebuilds;
+            // Furthest any particle had moved since the lists were built, at the
+            // last update.
+            NBS_PRECISION last_displacement;
+        };
+
+        /**
+         * \brief Uniform grid of cells at least a cutoff radius wide, with particles
+         * sorted by cell so that the neighbours of any particle within the cutoff lie
+         * in its own cell and those adjacent.
+         */
+        template <size_t Dimensions, CellListOptions Options>
+        struct CellList {
+            vec<Dimensions, NBS_PRECISION> origin;
+            NBS_PRECISION                  inverse_cell_size;
+            // Zero until first updated.
+            ui32 cells_on_axis;
+            // Particles sorted by cell: particle_order[cell_offsets[cell] ...
+            // cell_offsets[cell + 1]) index the particles in that cell.
+            ui32* cell_offsets;
+            ui32* particle_order;
+            ui32* particle_cell;
+            // Neighbours of each particle, once built: neighbours[neighbour_offsets[
+            // particle] ... neighbour_offsets[particle + 1]) index the particles
+            // within the cutoff and skin of that particle.
+            ui32*  neighbour_offsets;
+            ui32*  neighbours;
+            size_t neighbour_capacity;
+            // Positions of particles when the neighbour lists were last built, and
+            // whether the lists must be rebuilt regardless of them.
+            vec<Dimensions, NBS_PRECISION>* list_positions;
+            bool                            stale_neighbour_lists;
+            NeighbourListCounters           counters;
+        };
+
+        template <size_t Dimensions, CellListOptions Options>
+        void allocate_cell_list(
+            OUT CALLER_DELETE CellList<Dimensions, Options>& cell_list
+        );
+
+        template <size_t Dimensions, CellListOptions Options>
+        void deallocate_cell_list(
+            OUT CALLER_DELETE CellList<Dimensions, Options>& cell_list
+        );
+
+        /**
+         * \brief Displacement from one position to another, to the nearest image of
+         * the other if periodic.
+         */
+        template <size_t Dimensions, CellListOptions Options>
+        vec<Dimensions, NBS_PRECISION> displacement(
+            const vec<Dimensions, NBS_PRECISION>& from,
+            const vec<Dimensions, NBS_PRECISION>& to
+        );
+
+        /**
+         * \brief Brings the cell list up to date with particle positions.
+         *
+         * The grid is kept between updates while it still covers every particle, so
+         * that only particles are rebinned, and they are only re-sorted if any
+         * changed cell. Otherwise the grid is refitted around the particles, with a
+         * margin of a cell either side so it can be kept for a while.
+         *
+         * \return The number of particles that changed cell, every particle if the
+         * grid was refitted.
+         */
+        template <
+            size_t               Dimensions,
+            Particle<Dimensions> ParticleType,
+            CellListOptions      Options>
+        size_t update_cell_list(
+            const ParticleType*                   particles,
+            IN OUT CellList<Dimensions, Options>& cell_list,
+            parallel::ThreadPool*                 pool = nullptr
+        );
+
+        /**
+         * \brief Calls func(other_idx, displacement, distance_2) for each other
+         * particle within the cutoff radius of particles[particle_idx], with the
+         * displacement from that particle to the other. The cell list must be up to
+         * date.
+         */
+        template <
+            size_t               Dimensions,
+            Particle<Dimensions> ParticleType,
+            CellListOptions      Options,
+            typename Func>
+        void for_each_neighbour(
+            const ParticleType*                  particles,
+            const CellList<Dimensions, Options>& cell_list,
+            size_t                               particle_idx,
+            Func&&                               func
+        );
+
+        /**
+         * \brief Builds the neighbour list of every particle from the cell list,
+         * which must be up to date, taking pairs within the cutoff radius and skin.
+         * Lists are symmetric, and ordered by cell.
+         */
+        template <
+            size_t               Dimensions,
+            Particle<Dimensions> ParticleType,
+            CellListOptions      Options>
+        void build_neighbour_lists(
+            const ParticleType*                   particles,
+            IN OUT CellList<Dimensions, Options>& cell_list,
+            parallel::ThreadPool*                 pool = nullptr
+        );
+
+        /**
+         * \brief Marks neighbour lists to be rebuilt on the next update, for when
+         * particles have been reordered, e.g. by sorting along a curve.
+         */
+        template <size_t Dimensions, CellListOptions Options>
+        void invalidate_neighbour_lists(
+            IN OUT CellList<Dimensions, Options>& cell_list
+        );
+
+        /**
+         * \brief Brings neighbour lists up to date with particle positions,
+         * updating the cell list and rebuilding the lists only if they are stale or
+         * some particle has moved more than half the skin since they were built. The
+         * lists otherwise still hold every pair within the cutoff radius, as
+         * neither particle of a pair can have closed more than half the skin.
+         *
+         * \return Whether the lists were rebuilt.
+         */
+        template <
+            size_t               Dimensions,
+            Particle<Dimensions> ParticleType,
+            CellListOptions      Options>
+        bool update_neighbour_lists(
+            const ParticleType*                   particles,
+            IN OUT CellList<Dimensions, Options>& cell_list,
+            parallel::ThreadPool*                 pool = nullptr
+        );
+
+        /**
+         * \brief As for_each_neighbour, but walking the neighbour list of
+         * particles[particle_idx], which must be up to date.
+         */
+        template <
+            size_t               Dimensions,
+            Particle<Dimensions> ParticleType,
+            CellListOptions      Options,
+            typename Func>
+        void for_each_listed_neighbour(
+            const ParticleType*                  particles,
+            const CellList<Dimensions, Options>& cell_list,
+            size_t                               particle_idx,
+            Func&&                               func
+        );
+    }  // namespace spatial
+}  // namespace nbs
+
+#include "cell_list.inl"
+
+#endif  // N_BODY_SIM_SPATIAL_CELL_LIST_HPP
@@ -0,0 +1,501 @@
+namespace nbs {
+    namespace spatial {
+        namespace detail {
+            template <size_t Dimensions, CellListOptions Options>
+            constexpr size_t max_cell_count = [] {
+                size_t count = 1;
+                for (size_t dim = 0; dim < Dimensions; ++dim) {
+                    count *= Options.max_cells_on_axis;
+                }
+                return count;
+            }();
+
+            // Pairs within this are taken into neighbour lists, so cells are at
+            // least this wide.
+            template <CellListOptions Options>
+            constexpr NBS_PRECISION list_radius = Options.cutoff_radius + Options.skin;
+
+            template <size_t Dimensions>
+            constexpr size_t adjacent_cell_count = [] {
+                size_t count = 1;
+                for (size_t dim = 0; dim < Dimensions; ++dim) count *= 3;
+                return count;
+            }();
+
+            template <size_t Dimensions, CellListOptions Options>
+            size_t cell_count(const CellList<Dimensions, Options>& cell_list) {
+                size_t count = 1;
+                for (size_t dim = 0; dim < Dimensions; ++dim) {
+                    count *= cell_list.cells_on_axis;
+                }
+                return count;
+            }
+
+            // Coordinates of the cell holding position, or false if the grid does
+            // not cover it.
+            template <size_t Dimensions, CellListOptions Options>
+            bool cell_coords(
+                const CellList<Dimensions, Options>&  cell_list,
+                const vec<Dimensions, NBS_PRECISION>& position,
+                OUT vec<Dimensions, i32>&             coords
+            ) {
+                for (size_t dim = 0; dim < Dimensions; ++dim) {
+                    NBS_PRECISION offset = position[dim] - cell_list.origin[dim];
+                    if constexpr (Options.periodic) {
+                        offset -= Options.box_size
+                                  * std::floor(offset / Options.box_size);
+                    }
+
+                    const NBS_PRECISION coord = offset * cell_list.inverse_cell_size;
+                    if constexpr (Options.periodic) {
+                        // Rounding can leave a wrapped offset of exactly box_size.
+                        coords[dim] = std::min(
+                            static_cast<i32>(coord),
+                            static_cast<i32>(cell_list.cells_on_axis) - 1
+                        );
+                    } else {
+                        if (!(coord >= 0)
+                            || !(coord < static_cast<NBS_PRECISION>(
+                                     cell_list.cells_on_axis
+                                 )))
+                            return false;
+
+                        coords[dim] = static_cast<i32>(coord);
+                    }
+                }
+                return true;
+            }
+
+            template <size_t Dimensions, CellListOptions Options>
+            size_t cell_index(
+                const CellList<Dimensions, Options>& cell_list,
+                const vec<Dimensions, i32>&          coords
+            ) {
+                size_t cell_idx = 0;
+                for (size_t dim = Dimensions; dim-- > 0;) {
+                    cell_idx = cell_idx * cell_list.cells_on_axis
+                               + static_cast<size_t>(coords[dim]);
+                }
+                return cell_idx;
+            }
+
+            // Fits the grid around the particles, or to the box if periodic.
+            template <
+                size_t               Dimensions,
+                Particle<Dimensions> ParticleType,
+                CellListOptions      Options>
+            void fit_grid(
+                const ParticleType*                   particles,
+                IN OUT CellList<Dimensions, Options>& cell_list
+            ) {
+                NBS_PRECISION domain_size;
+
+                if constexpr (Options.periodic) {
+                    cell_list.origin = {};
+                    domain_size      = Options.box_size;
+                } else {
+                    vec<Dimensions, NBS_PRECISION> domain_min = particles[0].position;
+                    vec<Dimensions, NBS_PRECISION> domain_max = particles[0].position;
+                    for (size_t particle_idx = 1; particle_idx < Options.particle_count;
+                         ++particle_idx)
+                    {
+                        domain_min
+                            = math::min(domain_min, particles[particle_idx].position);
+                        domain_max
+                            = math::max(domain_max, particles[particle_idx].position);
+                    }
+
+                    domain_size = 0;
+                    for (size_t dim = 0; dim < Dimensions; ++dim) {
+                        domain_size
+                            = std::max(domain_size, domain_max[dim] - domain_min[dim]);
+                    }
+
+                    // Leave a cell's margin either side, so particles can move a
+                    // while before the grid must be refitted.
+                    const NBS_PRECISION margin = list_radius<Options>;
+                    cell_list.origin           = domain_min - margin;
+                    domain_size                = domain_size + 2 * margin;
+                }
+
+                cell_list.cells_on_axis = static_cast<ui32>(std::clamp<size_t>(
+                    static_cast<size_t>(domain_size / list_radius<Options>),
+                    1,
+                    Options.max_cells_on_axis
+                ));
+                cell_list.inverse_cell_size
+                    = static_cast<NBS_PRECISION>(cell_list.cells_on_axis) / domain_size;
+            }
+
+            // Calls func(other_idx, displacement, distance_2) for each other
+            // particle within the square root of radius_2 of particles[particle_idx],
+            // searching its own cell and those adjacent.
+            template <
+                size_t               Dimensions,
+                Particle<Dimensions> ParticleType,
+                CellListOptions      Options,
+                typename Func>
+            void for_each_particle_within(
+                const ParticleType*                  particles,
+                const CellList<Dimensions, Options>& cell_list,
+                size_t                               particle_idx,
+                NBS_PRECISION                        radius_2,
+                Func&&                               func
+            ) {
+                const vec<Dimensions, NBS_PRECISION>& position
+                    = particles[particle_idx].position;
+
+                vec<Dimensions, i32> coords;
+                cell_coords(cell_list, position, coords);
+
+                const i32 cells_on_axis = static_cast<i32>(cell_list.cells_on_axis);
+
+                for (size_t code = 0; code < adjacent_cell_count<Dimensions>; ++code) {
+                    vec<Dimensions, i32> other_coords;
+
+                    bool   in_bounds = true;
+                    size_t remainder = code;
+                    for (size_t dim = 0; dim < Dimensions; ++dim) {
+                        other_coords[dim]
+                            = coords[dim] + static_cast<i32>(remainder % 3) - 1;
+                        remainder /= 3;
+
+                        if constexpr (Options.periodic) {
+                            other_coords[dim]
+                                = (other_coords[dim] + cells_on_axis) % cells_on_axis;
+                        } else {
+                            in_bounds &= other_coords[dim] >= 0
+                                         && other_coords[dim] < cells_on_axis;
+                        }
+                    }
+
+                    if (!in_bounds) continue;
+
+                    const size_t other_cell_idx = cell_index(cell_list, other_coords);
+                    for (ui32 order_idx = cell_list.cell_offsets[other_cell_idx];
+                         order_idx < cell_list.cell_offsets[other_cell_idx + 1];
+                         ++order_idx)
+                    {
+                        const size_t other_idx = cell_list.particle_order[order_idx];
+                        if (other_idx == particle_idx) continue;
+
+                        const vec<Dimensions, NBS_PRECISION> offset
+                            = displacement<Dimensions, Options>(
+                                position, particles[other_idx].position
+                            );
+                        const NBS_PRECISION distance_2 = math::dot(offset, offset);
+
+                        if (distance_2 < radius_2) func(other_idx, offset, distance_2);
+                    }
+                }
+            }
+        }  // namespace detail
+    }      // namespace spatial
+}  // namespace nbs
+
+template <size_t Dimensions, nbs::spatial::CellListOptions Options>
+void nbs::spatial::allocate_cell_list(
+    OUT CALLER_DELETE CellList<Dimensions, Options>& cell_list
+) {
+    cell_list.cells_on_axis = 0;
+
+    constexpr size_t MAX_CELL_COUNT = detail::max_cell_count<Dimensions, Options>;
+
+    cell_list.cell_offsets   = new ui32[MAX_CELL_COUNT + 1];
+    cell_list.particle_order = new ui32[Options.particle_count];
+    cell_list.particle_cell  = new ui32[Options.particle_count];
+
+    cell_list.neighbour_capacity
+        = static_cast<size_t>(Options.particle_count) * Options.neighbours_per_particle;
+    cell_list.neighbour_offsets = new ui32[Options.particle_count + 1];
+    cell_list.neighbours        = new ui32[cell_list.neighbour_capacity];
+
+    cell_list.list_positions
+        = new vec<Dimensions, NBS_PRECISION>[Options.particle_count];
+    cell_list.stale_neighbour_lists = true;
+    cell_list.counters              = {};
+}
+
+template <size_t Dimensions, nbs::spatial::CellListOptions Options>
+void nbs::spatial::deallocate_cell_list(
+    OUT CALLER_DELETE CellList<Dimensions, Options>& cell_list
+) {
+    delete[] cell_list.list_positions;
+    delete[] cell_list.neighbours;
+    delete[] cell_list.neighbour_offsets;
+    delete[] cell_list.particle_cell;
+    delete[] cell_list.particle_order;
+    delete[] cell_list.cell_offsets;
+}
+
+template <size_t Dimensions, nbs::spatial::CellListOptions Options>
+nbs::vec<Dimensions, NBS_PRECISION> nbs::spatial::displacement(
+    const vec<Dimensions, NBS_PRECISION>& from, const vec<Dimensions, NBS_PRECISION>& to
+) {
+    if constexpr (Options.periodic) {
+        return nearest_image<Dimensions>(to - from, Options.box_size);
+    } else {
+        return to - from;
+    }
+}
+
+template <
+    size_t                        Dimensions,
+    nbs::Particle<Dimensions>     ParticleType,
+    nbs::spatial::CellListOptions Options>
+size_t nbs::spatial::update_cell_list(
+    const ParticleType*                   particles,
+    IN OUT CellList<Dimensions, Options>& cell_list,
+    parallel::ThreadPool*                 pool /*= nullptr*/
+) {
+    // Fewer than three cells on an axis would wrap a cell's neighbours onto each
+    // other.
+    static_assert(
+        !Options.periodic || Options.box_size >= 3 * detail::list_radius<Options>,
+        "Periodic cell lists need the box to span at least three cutoff radii and "
+        "skins."
+    );
+    static_assert(
+        !Options.periodic || Options.max_cells_on_axis >= 3,
+        "Periodic cell lists need at least three cells on each axis."
+    );
+
+    constexpr size_t PARTICLE_COUNT = Options.particle_count;
+
+    /************
+       Rebin particles on the current grid, refitting it if any fall outside.
+                                                                  ************/
+
+    std::atomic<size_t> changed_count = 0;
+    std::atomic<bool>   refit         = cell_list.cells_on_axis == 0;
+
+    auto rebin_particle = [&](size_t particle_idx) {
+        if (refit.load(std::memory_order_relaxed)) return;
+
+        vec<Dimensions, i32> coords;
+        if (!detail::cell_coords(cell_list, particles[particle_idx].position, coords))
+        {
+            refit.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        const ui32 cell_idx = static_cast<ui32>(detail::cell_index(cell_list, coords));
+        if (cell_idx != cell_list.particle_cell[particle_idx]) {
+            cell_list.particle_cell[particle_idx] = cell_idx;
+            changed_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    if (!refit) {
+        parallel::parallel_for(pool, 0, PARTICLE_COUNT, Options.grain, rebin_particle);
+    }
+
+    if (refit) {
+        detail::fit_grid(particles, cell_list);
+
+        auto bin_particle = [&](size_t particle_idx) {
+            vec<Dimensions, i32> coords;
+            detail::cell_coords(cell_list, particles[particle_idx].position, coords);
+
+            cell_list.particle_cell[particle_idx]
+                = static_cast<ui32>(detail::cell_index(cell_list, coords));
+        };
+
+        parallel::parallel_for(pool, 0, PARTICLE_COUNT, Options.grain, bin_particle);
+
+        changed_count = PARTICLE_COUNT;
+    }
+
+    if (changed_count == 0) return 0;
+
+    /************
+       Sort particles by cell.
+                     ************/
+
+    // Count into each cell's offset, accumulate to cell ends, then fill each cell
+    // from its end, leaving the offsets at cell starts.
+    const size_t cell_count = detail::cell_count(cell_list);
+
+    std::fill_n(cell_list.cell_offsets, cell_count, 0);
+    for (size_t particle_idx = 0; particle_idx < PARTICLE_COUNT; ++particle_idx) {
+        cell_list.cell_offsets[cell_list.particle_cell[particle_idx]] += 1;
+    }
+    for (size_t cell_idx = 1; cell_idx < cell_count; ++cell_idx) {
+        cell_list.cell_offsets[cell_idx] += cell_list.cell_offsets[cell_idx - 1];
+    }
+    cell_list.cell_offsets[cell_count] = static_cast<ui32>(PARTICLE_COUNT);
+    for (size_t particle_idx = PARTICLE_COUNT; particle_idx-- > 0;) {
+        const ui32 cell_idx = cell_list.particle_cell[particle_idx];
+        cell_list.particle_order[--cell_list.cell_offsets[cell_idx]]
+            = static_cast<ui32>(particle_idx);
+    }
+
+    return changed_count;
+}
+
+template <
+    size_t                        Dimensions,
+    nbs::Particle<Dimensions>     ParticleType,
+    nbs::spatial::CellListOptions Options,
+    typename Func>
+void nbs::spatial::for_each_neighbour(
+    const ParticleType*                  particles,
+    const CellList<Dimensions, Options>& cell_list,
+    size_t                               particle_idx,
+    Func&&                               func
+) {
+    constexpr NBS_PRECISION CUTOFF_RADIUS_2
+        = Options.cutoff_radius * Options.cutoff_radius;
+
+    detail::for_each_particle_within(
+        particles, cell_list, particle_idx, CUTOFF_RADIUS_2, std::forward<Func>(func)
+    );
+}
+
+template <
+    size_t                        Dimensions,
+    nbs::Particle<Dimensions>     ParticleType,
+    nbs::spatial::CellListOptions Options>
+void nbs::spatial::build_neighbour_lists(
+    const ParticleType*                   particles,
+    IN OUT CellList<Dimensions, Options>& cell_list,
+    parallel::ThreadPool*                 pool /*= nullptr*/
+) {
+    constexpr size_t        PARTICLE_COUNT = Options.particle_count;
+    constexpr NBS_PRECISION LIST_RADIUS_2
+        = detail::list_radius<Options> * detail::list_radius<Options>;
+
+    // Count neighbours, accumulate into offsets, then fill.
+    auto count_neighbours = [&](size_t particle_idx) {
+        ui32 count = 0;
+        detail::for_each_particle_within(
+            particles,
+            cell_list,
+            particle_idx,
+            LIST_RADIUS_2,
+            [&count](size_t, const vec<Dimensions, NBS_PRECISION>&, NBS_PRECISION) {
+                ++count;
+            }
+        );
+        cell_list.neighbour_offsets[particle_idx + 1] = count;
+    };
+
+    parallel::parallel_for(pool, 0, PARTICLE_COUNT, Options.grain, count_neighbours);
+
+    cell_list.neighbour_offsets[0] = 0;
+    for (size_t particle_idx = 0; particle_idx < PARTICLE_COUNT; ++particle_idx) {
+        cell_list.neighbour_offsets[particle_idx + 1]
+            += cell_list.neighbour_offsets[particle_idx];
+    }
+
+    const size_t neighbour_count = cell_list.neighbour_offsets[PARTICLE_COUNT];
+    if (neighbour_count > cell_list.neighbour_capacity) {
+        delete[] cell_list.neighbours;
+
+        // Grow with some slack, so slowly densifying particles don't reallocate
+        // every build.
+        cell_list.neighbour_capacity = neighbour_count + neighbour_count / 2;
+        cell_list.neighbours         = new ui32[cell_list.neighbour_capacity];
+    }
+
+    auto fill_neighbours = [&](size_t particle_idx) {
+        ui32* cursor = cell_list.neighbours + cell_list.neighbour_offsets[particle_idx];
+        detail::for_each_particle_within(
+            particles,
+            cell_list,
+            particle_idx,
+            LIST_RADIUS_2,
+            [&cursor](
+                size_t other_idx, const vec<Dimensions, NBS_PRECISION>&, NBS_PRECISION
+            ) { *cursor++ = static_cast<ui32>(other_idx); }
+        );
+
+        cell_list.list_positions[particle_idx] = particles[particle_idx].position;
+    };
+
+    parallel::parallel_for(pool, 0, PARTICLE_COUNT, Options.grain, fill_neighbours);
+
+    cell_list.stale_neighbour_lists = false;
+    ++cell_list.counters.rebuilds;
+}
+
+template <size_t Dimensions, nbs::spatial::CellListOptions Options>
+void nbs::spatial::invalidate_neighbour_lists(
+    IN OUT CellList<Dimensions, Options>& cell_list
+) {
+    cell_list.stale_neighbour_lists = true;
+}
+
+template <
+    size_t                        Dimensions,
+    nbs::Particle<Dimensions>     ParticleType,
+    nbs::spatial::CellListOptions Options>
+bool nbs::spatial::update_neighbour_lists(
+    const ParticleType*                   particles,
+    IN OUT CellList<Dimensions, Options>& cell_list,
+    parallel::ThreadPool*                 pool /*= nullptr*/
+) {
+    ++cell_list.counters.updates;
+
+    if (!cell_list.stale_neighbour_lists) {
+        const NBS_PRECISION max_displacement_2 = parallel::parallel_reduce(
+            pool,
+            0,
+            Options.particle_count,
+            Options.grain,
+            static_cast<NBS_PRECISION>(0),
+            [&](size_t particle_idx) {
+                const vec<Dimensions, NBS_PRECISION> offset
+                    = displacement<Dimensions, Options>(
+                        cell_list.list_positions[particle_idx],
+                        particles[particle_idx].position
+                    );
+                return math::dot(offset, offset);
+            },
+            [](NBS_PRECISION lhs, NBS_PRECISION rhs) { return std::max(lhs, rhs); }
+        );
+
+        cell_list.counters.last_displacement = math::sqrt(max_displacement_2);
+
+        if (2 * cell_list.counters.last_displacement <= Options.skin) return false;
+    }
+
+    update_cell_list(particles, cell_list, pool);
+    build_neighbour_lists(particles, cell_list, pool);
+
+    cell_list.counters.last_displacement = 0;
+
+    return true;
+}
+
+template <
+    size_t                        Dimensions,
+    nbs::Particle<Dimensions>     ParticleType,
+    nbs::spatial::CellListOptions Options,
+    typename Func>
+void nbs::spatial::for_each_listed_neighbour(
+    const ParticleType*                  particles,
+    const CellList<Dimensions, Options>& cell_list,
+    size_t                               particle_idx,
+    Func&&                               func
+) {
+    constexpr NBS_PRECISION CUTOFF_RADIUS_2
+        = Options.cutoff_radius * Options.cutoff_radius;
+
+    const vec<Dimensions, NBS_PRECISION>& position = particles[particle_idx].position;
+
+    for (ui32 list_idx = cell_list.neighbour_offsets[particle_idx];
+         list_idx < cell_list.neighbour_offsets[particle_idx + 1];
+         ++list_idx)
+    {
+        const size_t other_idx = cell_list.neighbours[list_idx];
+
+        const vec<Dimensions, NBS_PRECISION> offset
+            = displacement<Dimensions, Options>(
+                position, particles[other_idx].position
+            );
+        const NBS_PRECISION distance_2 = math::dot(offset, offset);
+
+        if (distance_2 < CUTOFF_RADIUS_2) func(other_idx, offset, distance_2);
+    }
+}
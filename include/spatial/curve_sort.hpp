@@ -0,0 +1,99 @@
+#ifndef N_BODY_SIM_SPATIAL_CURVE_SORT_HPP
+#define N_BODY_SIM_SPATIAL_CURVE_SORT_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "clustering/cluster.hpp"
+#include "parallel/thread_pool.hpp"
+#include "spatial/options.hpp"
+
+namespace nbs {
+    namespace spatial {
+        namespace detail {
+            // Radix sort digits, a byte at a time.
+            constexpr ui32 RADIX_BITS   = 8;
+            constexpr ui32 RADIX_VALUES = 1 << RADIX_BITS;
+
+            // Bits of each coordinate that go into a 64-bit key.
+            template <size_t Dimensions>
+            constexpr ui32 curve_bits_per_axis = std::min<ui32>(64 / Dimensions, 32);
+        }  // namespace detail
+
+        /**
+         * \brief Key of a point on the Morton curve through a grid of side
+         * 2^curve_bits_per_axis, the bits of its coordinates interleaved.
+         */
+        template <size_t Dimensions>
+        ui64 morton_key(vec<Dimensions, ui32> coords);
+
+        /**
+         * \brief Key of a point on the Hilbert curve through a grid of side
+         * 2^curve_bits_per_axis, by Skilling's transpose ("Programming the Hilbert
+         * curve", 2004).
+         */
+        template <size_t Dimensions>
+        ui64 hilbert_key(vec<Dimensions, ui32> coords);
+
+        template <typename ParticleType, CurveSortOptions Options>
+        struct CurveSortBuffers {
+            ui64* keys;
+            ui64* scratch_keys;
+            // Particles in key order, as indices into the range being sorted.
+            ui32*         order;
+            ui32*         scratch_order;
+            ParticleType* scratch_particles;
+            // Digit counts of each block of grain particles for a radix pass.
+            ui32* histograms;
+        };
+
+        template <typename ParticleType, CurveSortOptions Options>
+        void allocate_curve_sort_buffers(
+            OUT CALLER_DELETE CurveSortBuffers<ParticleType, Options>& buffers
+        );
+
+        template <typename ParticleType, CurveSortOptions Options>
+        void deallocate_curve_sort_buffers(
+            OUT CALLER_DELETE CurveSortBuffers<ParticleType, Options>& buffers
+        );
+
+        /**
+         * \brief Reorders particles along a space-filling curve through their
+         * bounding box, by a parallel LSD radix sort of their keys, so that particles
+         * close in space are close in memory. Best done before clustering, which
+         * keeps the order of particles within each cluster.
+         */
+        template <
+            size_t               Dimensions,
+            Particle<Dimensions> ParticleType,
+            CurveSortOptions     Options>
+        void sort_by_curve(
+            IN OUT ParticleType*                            particles,
+            IN OUT CurveSortBuffers<ParticleType, Options>& buffers,
+            parallel::ThreadPool*                           pool = nullptr
+        );
+
+        /**
+         * \brief Reorders the particles of each cluster along a space-filling curve
+         * through the cluster's bounding box, leaving clusters where they are. As
+         * cluster_metadata_idx goes with each particle, clustering state indexed by
+         * it is unaffected. Clusters are sorted in parallel, each serially.
+         */
+        template <
+            size_t                        Dimensions,
+            ClusteredParticle<Dimensions> ParticleType,
+            CurveSortOptions              Options>
+        void sort_clusters_by_curve(
+            IN OUT ParticleType*                              particles,
+            const cluster::Cluster<Dimensions, ParticleType>* clusters,
+            size_t                                            cluster_count,
+            IN OUT CurveSortBuffers<ParticleType, Options>&   buffers,
+            parallel::ThreadPool*                             pool = nullptr
+        );
+    }  // namespace spatial
+}  // namespace nbs
+
+#include "curve_sort.inl"
+
+#endif  // N_BODY_SIM_SPATIAL_CURVE_SORT_HPP
@@ -0,0 +1,329 @@
+namespace nbs {
+    namespace spatial {
+        namespace detail {
+            // Spreads the low curve_bits_per_axis bits of coord out to every
+            // Dimensions-th bit of the result.
+            template <size_t Dimensions>
+            ui64 spread_bits(ui32 coord) {
+                ui64 bits = coord;
+                if constexpr (Dimensions == 2) {
+                    bits = (bits | (bits << 16)) & 0x0000ffff0000ffff;
+                    bits = (bits | (bits << 8)) & 0x00ff00ff00ff00ff;
+                    bits = (bits | (bits << 4)) & 0x0f0f0f0f0f0f0f0f;
+                    bits = (bits | (bits << 2)) & 0x3333333333333333;
+                    bits = (bits | (bits << 1)) & 0x5555555555555555;
+                } else if constexpr (Dimensions == 3) {
+                    bits &= 0x1fffff;
+                    bits  = (bits | (bits << 32)) & 0x001f00000000ffff;
+                    bits  = (bits | (bits << 16)) & 0x001f0000ff0000ff;
+                    bits  = (bits | (bits << 8)) & 0x100f00f00f00f00f;
+                    bits  = (bits | (bits << 4)) & 0x10c30c30c30c30c3;
+                    bits  = (bits | (bits << 2)) & 0x1249249249249249;
+                } else {
+                    bits = 0;
+                    for (ui32 bit = 0; bit < curve_bits_per_axis<Dimensions>; ++bit) {
+                        bits |= ui64{ (coord >> bit) & 1u } << (bit * Dimensions);
+                    }
+                }
+                return bits;
+            }
+
+            // Keys of count particles on the curve through their bounding box.
+            template <
+                size_t               Dimensions,
+                Particle<Dimensions> ParticleType,
+                CurveSortOptions     Options>
+            void curve_keys(
+                const ParticleType*   particles,
+                size_t                count,
+                OUT ui64*             keys,
+                parallel::ThreadPool* pool
+            ) {
+                vec<Dimensions, NBS_PRECISION> lower = particles[0].position;
+                vec<Dimensions, NBS_PRECISION> upper = particles[0].position;
+                for (size_t idx = 1; idx < count; ++idx) {
+                    for (size_t dim = 0; dim < Dimensions; ++dim) {
+                        lower[dim] = std::min(lower[dim], particles[idx].position[dim]);
+                        upper[dim] = std::max(upper[dim], particles[idx].position[dim]);
+                    }
+                }
+
+                // Grid coordinates are finer than single precision resolves, so
+                // scale onto the grid in double precision.
+                constexpr f64 grid_max = static_cast<f64>(
+                    (ui64{ 1 } << curve_bits_per_axis<Dimensions>) - 1
+                );
+
+                f64 origin[Dimensions];
+                f64 scale[Dimensions];
+                for (size_t dim = 0; dim < Dimensions; ++dim) {
+                    const f64 extent = upper[dim] - lower[dim];
+
+                    origin[dim] = lower[dim];
+                    scale[dim]  = extent > 0 ? grid_max / extent : 0;
+                }
+
+                auto particle_key = [&](size_t idx) {
+                    vec<Dimensions, ui32> coords;
+                    for (size_t dim = 0; dim < Dimensions; ++dim) {
+                        const f64 position = particles[idx].position[dim];
+
+                        coords[dim] = static_cast<ui32>(
+                            std::min((position - origin[dim]) * scale[dim], grid_max)
+                        );
+                    }
+
+                    if constexpr (Options.curve == SpaceFillingCurve::MORTON) {
+                        keys[idx] = morton_key<Dimensions>(coords);
+                    } else {
+                        keys[idx] = hilbert_key<Dimensions>(coords);
+                    }
+                };
+
+                parallel::parallel_for(pool, 0, count, Options.grain, particle_key);
+            }
+
+            /**
+             * \brief Stable LSD radix sort of count keys, carrying order along with
+             * them. Each pass counts digits a block of grain keys at a time, with
+             * histograms holding RADIX_VALUES counts for each block, then scatters
+             * each block to its runs. Passes over digits every key shares are
+             * skipped.
+             *
+             * \return Whichever of order and scratch_order holds the sorted order.
+             */
+            inline const ui32* radix_sort(
+                ui64*                 keys,
+                ui64*                 scratch_keys,
+                ui32*                 order,
+                ui32*                 scratch_order,
+                size_t                count,
+                ui32*                 histograms,
+                size_t                grain,
+                parallel::ThreadPool* pool
+            ) {
+                const size_t block_count = (count + grain - 1) / grain;
+
+                for (ui32 shift = 0; shift < 64; shift += RADIX_BITS) {
+                    auto digit_of = [shift](ui64 key) {
+                        return static_cast<ui32>(key >> shift) & (RADIX_VALUES - 1);
+                    };
+
+                    auto count_digits = [&](size_t block_idx) {
+                        ui32* histogram = histograms + block_idx * RADIX_VALUES;
+                        std::fill_n(histogram, RADIX_VALUES, 0);
+
+                        const size_t end = std::min((block_idx + 1) * grain, count);
+                        for (size_t idx = block_idx * grain; idx < end; ++idx) {
+                            ++histogram[digit_of(keys[idx])];
+                        }
+                    };
+
+                    parallel::parallel_for(pool, 0, block_count, 1, count_digits);
+
+                    const ui32 first_digit  = digit_of(keys[0]);
+                    size_t     first_digits = 0;
+                    for (size_t block_idx = 0; block_idx < block_count; ++block_idx) {
+                        first_digits
+                            += histograms[block_idx * RADIX_VALUES + first_digit];
+                    }
+
+                    if (first_digits == count) continue;
+
+                    // Runs ordered by digit then block, keeping the sort stable.
+                    ui32 offset = 0;
+                    for (ui32 digit = 0; digit < RADIX_VALUES; ++digit) {
+                        for (size_t block_idx = 0; block_idx < block_count;
+                             ++block_idx)
+                        {
+                            ui32& run = histograms[block_idx * RADIX_VALUES + digit];
+
+                            const ui32 run_length  = run;
+                            run                    = offset;
+                            offset                += run_length;
+                        }
+                    }
+
+                    auto scatter_block = [&](size_t block_idx) {
+                        ui32* runs = histograms + block_idx * RADIX_VALUES;
+
+                        const size_t end = std::min((block_idx + 1) * grain, count);
+                        for (size_t idx = block_idx * grain; idx < end; ++idx) {
+                            const ui32 destination = runs[digit_of(keys[idx])]++;
+
+                            scratch_keys[destination]  = keys[idx];
+                            scratch_order[destination] = order[idx];
+                        }
+                    };
+
+                    parallel::parallel_for(pool, 0, block_count, 1, scatter_block);
+
+                    std::swap(keys, scratch_keys);
+                    std::swap(order, scratch_order);
+                }
+
+                return order;
+            }
+        }  // namespace detail
+    }      // namespace spatial
+}  // namespace nbs
+
+template <size_t Dimensions>
+nbs::ui64 nbs::spatial::morton_key(vec<Dimensions, ui32> coords) {
+    ui64 key = 0;
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        key |= detail::spread_bits<Dimensions>(coords[dim]) << (Dimensions - 1 - dim);
+    }
+    return key;
+}
+
+template <size_t Dimensions>
+nbs::ui64 nbs::spatial::hilbert_key(vec<Dimensions, ui32> coords) {
+    constexpr ui32 top_bit = ui32{ 1 } << (detail::curve_bits_per_axis<Dimensions> - 1);
+
+    // Undo the rotations and reflections of each level, leaving the transpose of
+    // the key's Gray code.
+    for (ui32 level = top_bit; level > 1; level >>= 1) {
+        const ui32 lower_bits = level - 1;
+
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            if (coords[dim] & level) {
+                coords[0] ^= lower_bits;
+            } else {
+                const ui32 swapped  = (coords[0] ^ coords[dim]) & lower_bits;
+                coords[0]          ^= swapped;
+                coords[dim]        ^= swapped;
+            }
+        }
+    }
+
+    // Gray decode.
+    for (size_t dim = 1; dim < Dimensions; ++dim) coords[dim] ^= coords[dim - 1];
+
+    ui32 flips = 0;
+    for (ui32 level = top_bit; level > 1; level >>= 1) {
+        if (coords[Dimensions - 1] & level) flips ^= level - 1;
+    }
+    for (size_t dim = 0; dim < Dimensions; ++dim) coords[dim] ^= flips;
+
+    // The transpose interleaves into the key as the Morton key does.
+    return morton_key<Dimensions>(coords);
+}
+
+template <typename ParticleType, nbs::spatial::CurveSortOptions Options>
+void nbs::spatial::allocate_curve_sort_buffers(
+    OUT CALLER_DELETE CurveSortBuffers<ParticleType, Options>& buffers
+) {
+    const size_t block_count
+        = (Options.particle_count + Options.grain - 1) / Options.grain;
+
+    buffers.keys              = new ui64[Options.particle_count];
+    buffers.scratch_keys      = new ui64[Options.particle_count];
+    buffers.order             = new ui32[Options.particle_count];
+    buffers.scratch_order     = new ui32[Options.particle_count];
+    buffers.scratch_particles = new ParticleType[Options.particle_count];
+    buffers.histograms        = new ui32[block_count * detail::RADIX_VALUES];
+}
+
+template <typename ParticleType, nbs::spatial::CurveSortOptions Options>
+void nbs::spatial::deallocate_curve_sort_buffers(
+    OUT CALLER_DELETE CurveSortBuffers<ParticleType, Options>& buffers
+) {
+    delete[] buffers.keys;
+    delete[] buffers.scratch_keys;
+    delete[] buffers.order;
+    delete[] buffers.scratch_order;
+    delete[] buffers.scratch_particles;
+    delete[] buffers.histograms;
+}
+
+template <
+    size_t                         Dimensions,
+    nbs::Particle<Dimensions>      ParticleType,
+    nbs::spatial::CurveSortOptions Options>
+void nbs::spatial::sort_by_curve(
+    IN OUT ParticleType*                            particles,
+    IN OUT CurveSortBuffers<ParticleType, Options>& buffers,
+    parallel::ThreadPool*                           pool /*= nullptr*/
+) {
+    constexpr size_t count = Options.particle_count;
+
+    if constexpr (count < 2) return;
+
+    detail::curve_keys<Dimensions, ParticleType, Options>(
+        particles, count, buffers.keys, pool
+    );
+
+    parallel::parallel_for(pool, 0, count, Options.grain, [&](size_t idx) {
+        buffers.order[idx] = static_cast<ui32>(idx);
+    });
+
+    const ui32* order = detail::radix_sort(
+        buffers.keys,
+        buffers.scratch_keys,
+        buffers.order,
+        buffers.scratch_order,
+        count,
+        buffers.histograms,
+        Options.grain,
+        pool
+    );
+
+    parallel::parallel_for(pool, 0, count, Options.grain, [&](size_t idx) {
+        buffers.scratch_particles[idx] = particles[order[idx]];
+    });
+    parallel::parallel_for(pool, 0, count, Options.grain, [&](size_t idx) {
+        particles[idx] = buffers.scratch_particles[idx];
+    });
+}
+
+template <
+    size_t                             Dimensions,
+    nbs::ClusteredParticle<Dimensions> ParticleType,
+    nbs::spatial::CurveSortOptions     Options>
+void nbs::spatial::sort_clusters_by_curve(
+    IN OUT ParticleType*                              particles,
+    const cluster::Cluster<Dimensions, ParticleType>* clusters,
+    size_t                                            cluster_count,
+    IN OUT CurveSortBuffers<ParticleType, Options>&   buffers,
+    parallel::ThreadPool*                             pool /*= nullptr*/
+) {
+    auto sort_cluster = [&](size_t cluster_idx) {
+        const auto&  cluster = clusters[cluster_idx];
+        const size_t offset  = cluster.particle_offset;
+        const size_t count   = cluster.particle_count;
+
+        if (count < 2) return;
+
+        ParticleType* cluster_particles = particles + offset;
+
+        detail::curve_keys<Dimensions, ParticleType, Options>(
+            cluster_particles, count, buffers.keys + offset, nullptr
+        );
+
+        for (size_t idx = 0; idx < count; ++idx) {
+            buffers.order[offset + idx] = static_cast<ui32>(idx);
+        }
+
+        // The cluster is sorted as a single block.
+        ui32 histogram[detail::RADIX_VALUES];
+
+        const ui32* order = detail::radix_sort(
+            buffers.keys + offset,
+            buffers.scratch_keys + offset,
+            buffers.order + offset,
+            buffers.scratch_order + offset,
+            count,
+            histogram,
+            count,
+            nullptr
+        );
+
+        for (size_t idx = 0; idx < count; ++idx) {
+            buffers.scratch_particles[offset + idx] = cluster_particles[order[idx]];
+        }
+        std::copy_n(buffers.scratch_particles + offset, count, cluster_particles);
+    };
+
+    parallel::parallel_for(pool, 0, cluster_count, 1, sort_cluster);
+}
@@ -0,0 +1,54 @@
+#ifndef N_BODY_SIM_SPATIAL_OPTIONS_HPP
+#define N_BODY_SIM_SPATIAL_OPTIONS_HPP
+
+#pragma once
+
+namespace nbs {
+    namespace spatial {
+        struct CellListOptions {
+            ui32 particle_count = 1000;
+            // Particles further apart than this are never neighbours, cells are at
+            // least this wide.
+            NBS_PRECISION cutoff_radius = 1.0;
+            // Most cells on each axis, bounding memory for widely spread particles.
+            ui32 max_cells_on_axis = 32;
+            // Whether space wraps with period box_size on every axis, particles are
+            // then treated as in [0, box_size)^D and pairs by their nearest images.
+            bool          periodic = false;
+            NBS_PRECISION box_size = 1.0;
+            // Neighbour lists take pairs up to skin beyond the cutoff radius, so that
+            // they hold every pair within it until some particle has moved half the
+            // skin. Cells are at least the cutoff radius and skin wide.
+            NBS_PRECISION skin = 0.0;
+            // Neighbours per particle that neighbour lists are first allocated for,
+            // they grow if needed.
+            ui32 neighbours_per_particle = 16;
+            // Number of particles handed to a thread at a time.
+            ui32 grain = 256;
+        };
+
+        enum class SpaceFillingCurve {
+            // Interleaves the bits of each coordinate, cheap but jumps across space
+            // between quadrants.
+            MORTON,
+            // Never jumps, so neighbours on the curve are always neighbours in
+            // space, at the cost of a few bit operations per level.
+            HILBERT
+        };
+
+        struct CurveSortOptions {
+            ui32              particle_count = 1000;
+            SpaceFillingCurve curve          = SpaceFillingCurve::HILBERT;
+            // Number of particles handed to a thread at a time.
+            ui32 grain = 4096;
+        };
+
+        struct RadixTreeOptions {
+            ui32 particle_count = 1000;
+            // Number of particles or nodes handed to a thread at a time.
+            ui32 grain = 4096;
+        };
+    }  // namespace spatial
+}  // namespace nbs
+
+#endif  // N_BODY_SIM_SPATIAL_OPTIONS_HPP
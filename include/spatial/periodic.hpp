@@ -0,0 +1,28 @@
+#ifndef N_BODY_SIM_SPATIAL_PERIODIC_HPP
+#define N_BODY_SIM_SPATIAL_PERIODIC_HPP
+
+#pragma once
+
+namespace nbs {
+    namespace spatial {
+        /**
+         * \brief Nearest image of a displacement in space wrapping with period
+         * box_size on every axis, each component then in [-box_size / 2, box_size / 2].
+         */
+        template <size_t Dimensions>
+        vec<Dimensions, NBS_PRECISION> nearest_image(
+            vec<Dimensions, NBS_PRECISION> displacement, NBS_PRECISION box_size
+        );
+
+        /**
+         * \brief Wraps a position into the box [0, box_size)^D.
+         */
+        template <size_t Dimensions>
+        vec<Dimensions, NBS_PRECISION>
+        wrap_position(vec<Dimensions, NBS_PRECISION> position, NBS_PRECISION box_size);
+    }  // namespace spatial
+}  // namespace nbs
+
+#include "periodic.inl"
+
+#endif  // N_BODY_SIM_SPATIAL_PERIODIC_HPP
@@ -0,0 +1,24 @@
+template <size_t Dimensions>
+nbs::vec<Dimensions, NBS_PRECISION> nbs::spatial::nearest_image(
+    vec<Dimensions, NBS_PRECISION> displacement, NBS_PRECISION box_size
+) {
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        displacement[dim] -= box_size * std::round(displacement[dim] / box_size);
+    }
+
+    return displacement;
+}
+
+template <size_t Dimensions>
+nbs::vec<Dimensions, NBS_PRECISION> nbs::spatial::wrap_position(
+    vec<Dimensions, NBS_PRECISION> position, NBS_PRECISION box_size
+) {
+    for (size_t dim = 0; dim < Dimensions; ++dim) {
+        position[dim] -= box_size * std::floor(position[dim] / box_size);
+
+        // Tiny negative coordinates can round up to box_size itself.
+        if (position[dim] >= box_size) position[dim] = 0;
+    }
+
+    return position;
+}
@@ -0,0 +1,77 @@
+#ifndef N_BODY_SIM_SPATIAL_RADIX_TREE_HPP
+#define N_BODY_SIM_SPATIAL_RADIX_TREE_HPP
+
+#pragma once
+
+#include "particle.hpp"
+
+#include "parallel/thread_pool.hpp"
+#include "spatial/curve_sort.hpp"
+#include "spatial/options.hpp"
+
+namespace nbs {
+    namespace spatial {
+        // Set on a child index that refers to a particle rather than an internal node.
+        constexpr ui32 LEAF_CHILD = ui32{ 1 } << 31;
+
+        /**
+         * \brief Binary radix tree over particles sorted by Morton key, with the
+         * particles as its leaves. A tree over n particles has n - 1 internal nodes,
+         * the root being node zero, each covering a contiguous range of particles.
+         */
+        template <size_t Dimensions, RadixTreeOptions Options>
+        struct RadixTree {
+            ui64* keys;
+            // Children of each internal node, internal nodes unless LEAF_CHILD is set.
+            ui32* left_children;
+            ui32* right_children;
+            // Parent of each internal node, the root being its own, and of each
+            // particle.
+            ui32* parents;
+            ui32* leaf_parents;
+            // Particles [range_begins[node], range_ends[node]) lie below node.
+            ui32* range_begins;
+            ui32* range_ends;
+            // Bounds, mass and centre of mass of the particles below each node.
+            vec<Dimensions, NBS_PRECISION>* lower_bounds;
+            vec<Dimensions, NBS_PRECISION>* upper_bounds;
+            NBS_PRECISION*                  masses;
+            vec<Dimensions, NBS_PRECISION>* centres_of_mass;
+            // Children of each node summarised so far, the second to arrive at a
+            // node summarises it.
+            std::atomic<ui32>* arrivals;
+        };
+
+        template <size_t Dimensions, RadixTreeOptions Options>
+        void allocate_radix_tree(
+            OUT CALLER_DELETE RadixTree<Dimensions, Options>& tree
+        );
+
+        template <size_t Dimensions, RadixTreeOptions Options>
+        void deallocate_radix_tree(
+            OUT CALLER_DELETE RadixTree<Dimensions, Options>& tree
+        );
+
+        /**
+         * \brief Builds the tree over particles, which must be in Morton order, e.g.
+         * by sort_by_curve with SpaceFillingCurve::MORTON. Each internal node is
+         * found independently of the others from the keys about it (Karras,
+         * "Maximizing Parallelism in the Construction of BVHs, Octrees, and k-d
+         * Trees", 2012), then summaries are built bottom-up, the second child to
+         * finish summarising its parent. Particles sharing a key are split by index.
+         */
+        template <
+            size_t               Dimensions,
+            Particle<Dimensions> ParticleType,
+            RadixTreeOptions     Options>
+        void build_radix_tree(
+            const ParticleType*                    particles,
+            IN OUT RadixTree<Dimensions, Options>& tree,
+            parallel::ThreadPool*                  pool = nullptr
+        );
+    }  // namespace spatial
+}  // namespace nbs
+
+#include "radix_tree.inl"
+
+#endif  // N_BODY_SIM_SPATIAL_RADIX_TREE_HPP
@@ -0,0 +1,203 @@
+namespace nbs {
+    namespace spatial {
+        namespace detail {
+            template <RadixTreeOptions Options>
+            constexpr CurveSortOptions morton_options{
+                .particle_count = Options.particle_count,
+                .curve          = SpaceFillingCurve::MORTON,
+                .grain          = Options.grain,
+            };
+
+            // Length of the prefix shared by the keys of particles idx and other,
+            // continuing into their indices if the keys are equal, or -1 if other is
+            // not a particle.
+            inline i32 common_prefix(const ui64* keys, i64 count, i64 idx, i64 other) {
+                if (other < 0 || other >= count) return -1;
+
+                const ui64 difference = keys[idx] ^ keys[other];
+                if (difference != 0) return std::countl_zero(difference);
+
+                return 64 + std::countl_zero(static_cast<ui64>(idx ^ other));
+            }
+        }  // namespace detail
+    }      // namespace spatial
+}  // namespace nbs
+
+template <size_t Dimensions, nbs::spatial::RadixTreeOptions Options>
+void nbs::spatial::allocate_radix_tree(
+    OUT CALLER_DELETE RadixTree<Dimensions, Options>& tree
+) {
+    constexpr size_t node_count = Options.particle_count - 1;
+
+    tree.keys            = new ui64[Options.particle_count];
+    tree.left_children   = new ui32[node_count];
+    tree.right_children  = new ui32[node_count];
+    tree.parents         = new ui32[node_count];
+    tree.leaf_parents    = new ui32[Options.particle_count];
+    tree.range_begins    = new ui32[node_count];
+    tree.range_ends      = new ui32[node_count];
+    tree.lower_bounds    = new vec<Dimensions, NBS_PRECISION>[node_count];
+    tree.upper_bounds    = new vec<Dimensions, NBS_PRECISION>[node_count];
+    tree.masses          = new NBS_PRECISION[node_count];
+    tree.centres_of_mass = new vec<Dimensions, NBS_PRECISION>[node_count];
+    tree.arrivals        = new std::atomic<ui32>[node_count];
+}
+
+template <size_t Dimensions, nbs::spatial::RadixTreeOptions Options>
+void nbs::spatial::deallocate_radix_tree(
+    OUT CALLER_DELETE RadixTree<Dimensions, Options>& tree
+) {
+    delete[] tree.keys;
+    delete[] tree.left_children;
+    delete[] tree.right_children;
+    delete[] tree.parents;
+    delete[] tree.leaf_parents;
+    delete[] tree.range_begins;
+    delete[] tree.range_ends;
+    delete[] tree.lower_bounds;
+    delete[] tree.upper_bounds;
+    delete[] tree.masses;
+    delete[] tree.centres_of_mass;
+    delete[] tree.arrivals;
+}
+
+template <
+    size_t                         Dimensions,
+    nbs::Particle<Dimensions>      ParticleType,
+    nbs::spatial::RadixTreeOptions Options>
+void nbs::spatial::build_radix_tree(
+    const ParticleType*                    particles,
+    IN OUT RadixTree<Dimensions, Options>& tree,
+    parallel::ThreadPool*                  pool /*= nullptr*/
+) {
+    constexpr i64 count = Options.particle_count;
+
+    detail::curve_keys<Dimensions, ParticleType, detail::morton_options<Options>>(
+        particles, count, tree.keys, pool
+    );
+
+    assert(std::is_sorted(tree.keys, tree.keys + count));
+
+    if constexpr (count < 2) return;
+
+    /************
+       Find the range and split of each internal node from the keys either side
+       of its first or last particle.
+                                  ************/
+
+    tree.parents[0] = 0;
+
+    auto build_node = [&](size_t node_idx) {
+        const i64 idx = static_cast<i64>(node_idx);
+
+        auto prefix = [&](i64 other) {
+            return detail::common_prefix(tree.keys, count, idx, other);
+        };
+
+        // The node's range runs from idx towards the neighbour sharing the longer
+        // prefix, as far as particles share more than the other neighbour does.
+        const i64 direction  = prefix(idx + 1) > prefix(idx - 1) ? 1 : -1;
+        const i32 min_prefix = prefix(idx - direction);
+
+        i64 max_length = 2;
+        while (prefix(idx + max_length * direction) > min_prefix) max_length *= 2;
+
+        i64 length = 0;
+        for (i64 step = max_length / 2; step > 0; step /= 2) {
+            if (prefix(idx + (length + step) * direction) > min_prefix) {
+                length += step;
+            }
+        }
+
+        // Split after the last particle sharing more than the whole range does.
+        const i32 node_prefix = prefix(idx + length * direction);
+
+        i64 split = 0;
+        i64 step  = length;
+        do {
+            step = (step + 1) / 2;
+            if (prefix(idx + (split + step) * direction) > node_prefix) split += step;
+        } while (step > 1);
+
+        const i64 first = std::min(idx, idx + length * direction);
+        const i64 last  = std::max(idx, idx + length * direction);
+        const i64 left  = idx + split * direction + std::min<i64>(direction, 0);
+        const i64 right = left + 1;
+
+        auto link_child = [&](i64 child, bool is_leaf) {
+            if (is_leaf) {
+                tree.leaf_parents[child] = static_cast<ui32>(node_idx);
+                return static_cast<ui32>(child) | LEAF_CHILD;
+            }
+            tree.parents[child] = static_cast<ui32>(node_idx);
+            return static_cast<ui32>(child);
+        };
+
+        tree.left_children[node_idx]  = link_child(left, left == first);
+        tree.right_children[node_idx] = link_child(right, right == last);
+        tree.range_begins[node_idx]   = static_cast<ui32>(first);
+        tree.range_ends[node_idx]     = static_cast<ui32>(last + 1);
+
+        tree.arrivals[node_idx].store(0, std::memory_order_relaxed);
+    };
+
+    parallel::parallel_for(pool, 0, count - 1, Options.grain, build_node);
+
+    /************
+       Summarise nodes bottom-up, climbing from each particle until reaching a
+       node whose other child is not yet summarised.
+                                               ************/
+
+    auto summarise_node = [&](ui32 node) {
+        vec<Dimensions, NBS_PRECISION> lower[2];
+        vec<Dimensions, NBS_PRECISION> upper[2];
+        NBS_PRECISION                  mass[2];
+        vec<Dimensions, NBS_PRECISION> centre[2];
+
+        const ui32 children[2]
+            = { tree.left_children[node], tree.right_children[node] };
+        for (size_t side = 0; side < 2; ++side) {
+            const ui32 child = children[side] & ~LEAF_CHILD;
+
+            if (children[side] & LEAF_CHILD) {
+                lower[side]  = particles[child].position;
+                upper[side]  = particles[child].position;
+                mass[side]   = mass_of(particles[child]);
+                centre[side] = particles[child].position;
+            } else {
+                lower[side]  = tree.lower_bounds[child];
+                upper[side]  = tree.upper_bounds[child];
+                mass[side]   = tree.masses[child];
+                centre[side] = tree.centres_of_mass[child];
+            }
+        }
+
+        tree.lower_bounds[node] = math::min(lower[0], lower[1]);
+        tree.upper_bounds[node] = math::max(upper[0], upper[1]);
+        tree.masses[node]       = mass[0] + mass[1];
+
+        if (tree.masses[node] > 0) {
+            tree.centres_of_mass[node]
+                = (centre[0] * mass[0] + centre[1] * mass[1]) / tree.masses[node];
+        } else {
+            tree.centres_of_mass[node]
+                = (tree.lower_bounds[node] + tree.upper_bounds[node])
+                  / static_cast<NBS_PRECISION>(2);
+        }
+    };
+
+    auto climb_from_particle = [&](size_t particle_idx) {
+        ui32 node = tree.leaf_parents[particle_idx];
+
+        // Acquire-release, so the second child to arrive sees the first's summary.
+        while (tree.arrivals[node].fetch_add(1, std::memory_order_acq_rel) == 1) {
+            summarise_node(node);
+
+            if (node == 0) return;
+
+            node = tree.parents[node];
+        }
+    };
+
+    parallel::parallel_for(pool, 0, count, Options.grain, climb_from_particle);
+}
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "clustering/cluster.hpp"
+#include "parallel/reduce.hpp"
 #include "particle.hpp"
 
 namespace nbs {
@@ -15,7 +16,8 @@ namespace nbs {
             size_t                        ClusterCount>
         f32 calculate_average_cluster_distance(
             ParticleType*                               particles,
-            cluster::Cluster<Dimensions, ParticleType>* clusters
+            cluster::Cluster<Dimensions, ParticleType>* clusters,
+            parallel::ThreadPool*                       pool = nullptr
         );
     }  // namespace statistics
 }  // namespace nbs
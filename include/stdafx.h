@@ -4,8 +4,11 @@
 #pragma once
 
 // Basics
+#include <cassert>
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <random>
 
 // Generics
@@ -18,12 +21,40 @@
 // Algorithms
 #include <algorithm>
 
+// Numerics
+#include <bit>
+#include <complex>
+#include <numbers>
+
+// Containers
+#include <array>
+#include <span>
+#include <vector>
+
+// Functional
+#include <functional>
+
+// Threading
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
 // Ranges
 #include <ranges>
 
 // Streams
 #include <iostream>
 
+// SIMD
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#endif
+
 // GL Maths
 #define GLM_ENABLE_EXPERIMENTAL
 
@@ -41,4 +72,6 @@
 #include "precision.hpp"
 #include "types.hpp"
 
+#include "simd.hpp"
+
 #endif  // N_BODY_SIM_STDAFX_H
@@ -4,6 +4,8 @@
 
 #include "clustering/clustering.hpp"
 
+#include "diagnostics/diagnostics.hpp"
+
 #include "2D_clustering_viewer.hpp"
 #include "my_particles.hpp"
 
@@ -11,7 +13,22 @@
 
 #include "statistics/average_cluster_distance.hpp"
 
-#include "forces/gravity.hpp"
+#include "forces/direct_kernel.hpp"
+#include "forces/ewald/ewald.hpp"
+#include "forces/fmm/fmm.hpp"
+#include "forces/laws.hpp"
+#include "forces/p3m/p3m.hpp"
+#include "forces/pm/pm.hpp"
+#include "forces/short_range.hpp"
+#include "forces/solver.hpp"
+
+#include "integrators/integrators.hpp"
+
+#include "parallel/parallel.hpp"
+
+#include "spatial/cell_list.hpp"
+#include "spatial/curve_sort.hpp"
+#include "spatial/radix_tree.hpp"
 
 using namespace nbs;
 
@@ -46,16 +63,18 @@ void do_a_cluster_job_a1(
     // Set up particles.
     for (size_t i = 0; i < 7500; ++i) {
         particles[i].cluster_metadata_idx = i;
-        particles[i].position             = A1_DATA[i];
+        particles[i].position             = vec<2, NBS_PRECISION>(A1_DATA[i]);
     }
 
     // Allocate clusters.
     clusters = new cluster::Cluster<2, MyParticle2D>[ClusterCount * 2];
 
+    parallel::ThreadPool pool;
+
     nbs::i64 total_us = 0;
     for (int iteration = 0; iteration < Iterations; ++iteration) {
         // Do kpp initialisation.
-        cluster::kpp<2, MyParticle2D, options>(particles, clusters);
+        cluster::kpp<2, MyParticle2D, options>(particles, clusters, nullptr, &pool);
 
         // // Quick check.
         // std::cout << "    kpp centroids:" << std::endl;
@@ -77,7 +96,7 @@ void do_a_cluster_job_a1(
         auto start = std::chrono::high_resolution_clock::now();
         // Do k_means.
         cluster::k_means<2, MyParticle2D, options>(
-            particles, clusters, clusters + ClusterCount, buffers
+            particles, clusters, clusters + ClusterCount, buffers, nullptr, &pool
         );
         auto duration = std::chrono::high_resolution_clock::now() - start;
         total_us
@@ -94,7 +113,7 @@ void do_a_cluster_job_a1(
         << "Average particle distance to cluster: "
         << statistics::
                calculate_average_cluster_distance<2, MyParticle2D, 7500, ClusterCount>(
-                   particles, clusters + ClusterCount
+                   particles, clusters + ClusterCount, &pool
                )
         << std::endl;
 
@@ -132,6 +151,8 @@ void do_optimise_kpp_a1_job(
     f32  current_best_avg_dist = std::numeric_limits<f32>::max();
     ui32 current_best_seed     = 0;
 
+    parallel::ThreadPool pool;
+
     nbs::i64 total_us = 0;
     for (int iteration = 0; iteration < Attempts; ++iteration) {
         ui32 seed = rand_dev();
@@ -139,11 +160,11 @@ void do_optimise_kpp_a1_job(
         // Set up particles.
         for (size_t i = 0; i < 7500; ++i) {
             particles[i].cluster_metadata_idx = i;
-            particles[i].position             = A1_DATA[i];
+            particles[i].position             = vec<2, NBS_PRECISION>(A1_DATA[i]);
         }
 
         // Do kpp initialisation.
-        cluster::kpp<2, MyParticle2D, options>(particles, clusters, &seed);
+        cluster::kpp<2, MyParticle2D, options>(particles, clusters, &seed, &pool);
 
         // Front load into first cluster.
         clusters[0].particle_count  = 7500;
@@ -155,12 +176,12 @@ void do_optimise_kpp_a1_job(
 
         // Do k_means.
         cluster::k_means<2, MyParticle2D, options>(
-            particles, clusters, clusters + ClusterCount, buffers
+            particles, clusters, clusters + ClusterCount, buffers, nullptr, &pool
         );
 
         f32 avg_dist = statistics::
             calculate_average_cluster_distance<2, MyParticle2D, 7500, ClusterCount>(
-                particles, clusters + ClusterCount
+                particles, clusters + ClusterCount, &pool
             );
         if (avg_dist < current_best_avg_dist) {
             current_best_avg_dist = avg_dist;
@@ -173,11 +194,13 @@ void do_optimise_kpp_a1_job(
     // Set up particles.
     for (size_t i = 0; i < 7500; ++i) {
         particles[i].cluster_metadata_idx = i;
-        particles[i].position             = A1_DATA[i];
+        particles[i].position             = vec<2, NBS_PRECISION>(A1_DATA[i]);
     }
 
     // Do kpp initialisation.
-    cluster::kpp<2, MyParticle2D, options>(particles, clusters, &current_best_seed);
+    cluster::kpp<2, MyParticle2D, options>(
+        particles, clusters, &current_best_seed, &pool
+    );
 
     // Front load into first cluster.
     clusters[0].particle_count  = 7500;
@@ -189,7 +212,7 @@ void do_optimise_kpp_a1_job(
 
     // Do k_means.
     cluster::k_means<2, MyParticle2D, options>(
-        particles, clusters, clusters + ClusterCount, buffers
+        particles, clusters, clusters + ClusterCount, buffers, nullptr, &pool
     );
 
     // // Quick check.
@@ -220,11 +243,12 @@ void do_a_cluster_job_dim_2(
     particles = new MyParticle2D[ParticleCount];
 
     // Set up particles.
-    std::default_random_engine          generator;
-    std::uniform_real_distribution<f32> distribution(-1000.0f, 1000.0f);
+    std::default_random_engine                    generator;
+    std::uniform_real_distribution<NBS_PRECISION> distribution(-1000.0f, 1000.0f);
     for (size_t i = 0; i < ParticleCount; ++i) {
         particles[i].cluster_metadata_idx = i;
-        particles[i].position = f32v2(distribution(generator), distribution(generator));
+        particles[i].position
+            = vec<2, NBS_PRECISION>(distribution(generator), distribution(generator));
     }
 
     // Allocate clusters.
@@ -275,11 +299,11 @@ void do_a_cluster_job_dim_3() {
     MyParticle* particles = new MyParticle[ParticleCount];
 
     // Set up particles.
-    std::default_random_engine          generator;
-    std::uniform_real_distribution<f32> distribution(-1000.0f, 1000.0f);
+    std::default_random_engine                    generator;
+    std::uniform_real_distribution<NBS_PRECISION> distribution(-1000.0f, 1000.0f);
     for (size_t i = 0; i < ParticleCount; ++i) {
         particles[i].cluster_metadata_idx = i;
-        particles[i].position             = f32v3(
+        particles[i].position             = vec<3, NBS_PRECISION>(
             distribution(generator), distribution(generator), distribution(generator)
         );
     }
@@ -325,67 +349,1268 @@ void do_a_cluster_job_dim_3() {
     // clang-format on
 }
 
+// Gravity is softened within a couple of hundred units, as close encounters under
+// unsoftened gravity would need far smaller steps than the clusters' motion does.
+using A1ForceSolver = forces::ForceSolver<
+    2,
+    MyParticle2D,
+    forces::laws::PlummerGravity<static_cast<NBS_PRECISION>(100)>,
+    forces::ForceSolverOptions{ .opening_angle = 0.5f }>;
+
+// Reclusters as the simulation runs, warm started from the clusters of the last step.
+// Clusters are capped at twice the mean size, so no one cluster's direct sum holds up
+// a step. Clusters collapsing from rest drift past a quarter of their spread within a
+// step or two, so reclustering waits for a whole spread of drift, or for the spread
+// to grow by half. That reclusters on about one step in five rather than seven in
+// ten, at about twice the energy error.
+template <size_t ClusterCount>
+constexpr cluster::ReclusterOptions A1_RECLUSTER_OPTIONS{
+    .k_means = { .particle_count   = 7500,
+                .cluster_count    = ClusterCount,
+                .max_iterations   = 100,
+                .max_cluster_size = 2 * 7500 / ClusterCount },
+    .drift_threshold         = 1.0f,
+    .spread_growth_threshold = 0.5f,
+};
+
+template <size_t ClusterCount>
+using A1ReclusterBuffers
+    = cluster::ReclusterBuffers<2, A1_RECLUSTER_OPTIONS<ClusterCount>>;
+
+// Keeps particles of each cluster in Hilbert order, so the direct sums walk memory
+// in step with space.
+constexpr spatial::CurveSortOptions A1_CURVE_SORT_OPTIONS{ .particle_count = 7500 };
+
+using A1CurveSortBuffers
+    = spatial::CurveSortBuffers<MyParticle2D, A1_CURVE_SORT_OPTIONS>;
+
+// Near forces, within and between neighbouring clusters, are stepped four times for
+// each step of the slowly varying far forces.
+constexpr integrators::RespaOptions A1_RESPA_OPTIONS{ .particle_count = 7500,
+                                                      .substeps       = 4 };
+
+constexpr NBS_PRECISION A1_TIME_STEP = 100.0f * A1_RESPA_OPTIONS.substeps;
+
+using A1RespaBuffers = integrators::RespaBuffers<2, A1_RESPA_OPTIONS>;
+
+template <size_t ClusterCount>
+void do_calculate_near_forces(
+    MyParticle2D*                      particles,
+    cluster::Cluster<2, MyParticle2D>* clusters,
+    A1ForceSolver&                     solver
+) {
+    solver.calculate_forces(
+        particles, clusters, ClusterCount, nullptr, forces::ForceRange::NEAR
+    );
+}
+
+// Returns whether the solver rebuilt its interaction lists, which changes which
+// forces are near.
+template <size_t ClusterCount>
+bool do_calculate_far_forces(
+    MyParticle2D*                      particles,
+    cluster::Cluster<2, MyParticle2D>* clusters,
+    A1ForceSolver&                     solver
+) {
+    const size_t rebuilds = solver.interaction_list_counters().rebuilds;
+
+    solver.calculate_forces(
+        particles, clusters, ClusterCount, nullptr, forces::ForceRange::FAR
+    );
+
+    return solver.interaction_list_counters().rebuilds != rebuilds;
+}
+
+template <size_t ClusterCount>
+void do_initialise_respa(
+    MyParticle2D*                      particles,
+    cluster::Cluster<2, MyParticle2D>* clusters,
+    A1ForceSolver&                     solver,
+    A1RespaBuffers&                    respa_buffers,
+    parallel::ThreadPool*              pool
+) {
+    integrators::initialise_respa<2, MyParticle2D, A1_RESPA_OPTIONS>(
+        particles,
+        [&]() {
+            do_calculate_near_forces<ClusterCount>(particles, clusters, solver);
+        },
+        [&]() {
+            return do_calculate_far_forces<ClusterCount>(particles, clusters, solver);
+        },
+        respa_buffers,
+        pool
+    );
+}
+
 template <size_t ClusterCount>
 void do_run_sim_step(
-    MyParticle2D* particles, cluster::Cluster<2, MyParticle2D>* clusters
+    MyParticle2D*                           particles,
+    cluster::Cluster<2, MyParticle2D>*      clusters,
+    cluster::Cluster<2, MyParticle2D>*      scratch_clusters,
+    A1ReclusterBuffers<ClusterCount>&       recluster_buffers,
+    A1CurveSortBuffers&                     curve_sort_buffers,
+    A1ForceSolver&                          solver,
+    A1RespaBuffers&                         respa_buffers,
+    diagnostics::DiagnosticsAccumulator<2>& diagnostics_accumulator,
+    diagnostics::DiagnosticsSeries<2>&      diagnostics_series,
+    parallel::ThreadPool*                   pool
 ) {
-    for (size_t cluster_idx = 0; cluster_idx < ClusterCount; ++cluster_idx) {
-        const auto& cluster = clusters[cluster_idx];
+    auto calculate_near_forces = [&]() {
+        do_calculate_near_forces<ClusterCount>(particles, clusters, solver);
+    };
+    auto calculate_far_forces = [&]() {
+        return do_calculate_far_forces<ClusterCount>(particles, clusters, solver);
+    };
+
+    integrators::respa_step<2, MyParticle2D, A1_RESPA_OPTIONS>(
+        particles,
+        A1_TIME_STEP,
+        calculate_near_forces,
+        calculate_far_forces,
+        respa_buffers,
+        pool,
+        &diagnostics_accumulator
+    );
 
-        for (size_t offset = 0; offset < cluster.particle_count; ++offset) {
-            auto& particle = particles[cluster.particle_offset + offset];
+    diagnostics::record_diagnostics(
+        diagnostics_series,
+        A1_TIME_STEP * static_cast<NBS_PRECISION>(diagnostics_series.count + 1),
+        diagnostics::reduce_diagnostics(diagnostics_accumulator)
+    );
 
-            particle.force = {};
-        }
+    const bool reclustered = cluster::
+        recluster_if_drifted<2, MyParticle2D, A1_RECLUSTER_OPTIONS<ClusterCount>>(
+            particles, clusters, scratch_clusters, recluster_buffers, pool
+        );
+
+    if (reclustered) {
+        spatial::sort_clusters_by_curve<2, MyParticle2D, A1_CURVE_SORT_OPTIONS>(
+            particles, clusters, ClusterCount, curve_sort_buffers, pool
+        );
+
+        solver.invalidate_interaction_lists();
+
+        // Which clusters are near each other has changed, so the buffered forces
+        // must be split afresh.
+        do_initialise_respa<ClusterCount>(
+            particles, clusters, solver, respa_buffers, pool
+        );
+    }
+}
 
-        for (size_t p1_offset = 0; p1_offset < cluster.particle_count; ++p1_offset) {
-            auto& particle_1 = particles[cluster.particle_offset + p1_offset];
-            for (size_t p2_offset = p1_offset + 1; p2_offset < cluster.particle_count;
-                 ++p2_offset)
-            {
-                auto& particle_2 = particles[cluster.particle_offset + p2_offset];
-
-                f32 distance_2
-                    = math::distance2(particle_1.position, particle_2.position);
-
-                // f32 force = forces::grav_with_repulsion_6<1000>(distance_2);
-                f32 force = forces::grav(distance_2);
-
-                particle_1.force
-                    += math::normalize(particle_2.position - particle_1.position)
-                       * force;
-                particle_2.force
-                    += math::normalize(particle_1.position - particle_2.position)
-                       * force;
+template <typename ForceLaw, size_t ParticleCount, size_t Iterations>
+void do_direct_kernel_benchmark_job(const char* law_name) {
+    // Take a cluster-sized chunk of the A1 dataset.
+    MyParticle2D* particles = new MyParticle2D[ParticleCount];
+    for (size_t i = 0; i < ParticleCount; ++i) {
+        particles[i].position = vec<2, NBS_PRECISION>(A1_DATA[i]);
+    }
+
+    vec<2, NBS_PRECISION>* reference_forces = new vec<2, NBS_PRECISION>[ParticleCount];
+
+    // Pair loop as the sim step used to do it, normalising twice per pair.
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t iteration = 0; iteration < Iterations; ++iteration) {
+        for (size_t i = 0; i < ParticleCount; ++i) reference_forces[i] = {};
+
+        for (size_t p1_idx = 0; p1_idx < ParticleCount; ++p1_idx) {
+            for (size_t p2_idx = p1_idx + 1; p2_idx < ParticleCount; ++p2_idx) {
+                const auto& p1 = particles[p1_idx];
+                const auto& p2 = particles[p2_idx];
+
+                NBS_PRECISION force
+                    = ForceLaw::magnitude(math::distance2(p1.position, p2.position));
+
+                reference_forces[p1_idx] += math::normalize(p2.position - p1.position)
+                                            * force;
+                reference_forces[p2_idx] += math::normalize(p1.position - p2.position)
+                                            * force;
             }
+        }
+    }
+    auto scalar_duration = std::chrono::high_resolution_clock::now() - start;
+
+    // Tiled kernel over gathered scratch.
+    forces::DirectKernelScratch<2> scratch{};
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t iteration = 0; iteration < Iterations; ++iteration) {
+        for (size_t i = 0; i < ParticleCount; ++i) particles[i].force = {};
+
+        forces::gather_direct_kernel_scratch<2, MyParticle2D>(
+            particles, ParticleCount, scratch
+        );
+        forces::direct_sum_symmetric<2, ForceLaw>(scratch, ParticleCount);
+        forces::scatter_direct_kernel_scratch<2, MyParticle2D>(
+            scratch, ParticleCount, particles
+        );
+    }
+    auto kernel_duration = std::chrono::high_resolution_clock::now() - start;
 
-            for (size_t other_cluster_idx = 0; other_cluster_idx < ClusterCount;
-                 ++other_cluster_idx)
-            {
-                const auto& other_cluster = clusters[other_cluster_idx];
+    NBS_PRECISION max_error = 0.0f, max_force = 0.0f;
+    for (size_t i = 0; i < ParticleCount; ++i) {
+        max_error = math::max(
+            max_error, math::length(particles[i].force - reference_forces[i])
+        );
+        max_force = math::max(max_force, math::length(reference_forces[i]));
+    }
+
+    auto pairs_per_second = [](std::chrono::high_resolution_clock::duration duration) {
+        const f32 pair_count = static_cast<f32>(ParticleCount * (ParticleCount - 1) / 2)
+                               * static_cast<f32>(Iterations);
+        const f32 seconds
+            = std::chrono::duration_cast<std::chrono::duration<f32>>(duration).count();
+        return pair_count / seconds;
+    };
+
+    std::cout << law_name << ":\n"
+              << "    scalar pair loop: " << pairs_per_second(scalar_duration)
+              << " pairs/s\n"
+              << "    direct kernel:    " << pairs_per_second(kernel_duration)
+              << " pairs/s\n"
+              << "    max relative difference: " << max_error / max_force
+              << std::endl;
+
+    forces::deallocate_direct_kernel_scratch(scratch);
+
+    delete[] reference_forces;
+    delete[] particles;
+}
+
+template <
+    size_t   Dimensions,
+    typename ParticleType,
+    ui32     ParticleCount,
+    size_t   Iterations>
+void do_radix_tree_benchmark_job(parallel::ThreadPool* pool) {
+    constexpr spatial::CurveSortOptions curve_sort_options{
+        .particle_count = ParticleCount, .curve = spatial::SpaceFillingCurve::MORTON
+    };
+    constexpr spatial::RadixTreeOptions radix_tree_options{ .particle_count
+                                                            = ParticleCount };
+
+    std::default_random_engine                    generator;
+    std::uniform_real_distribution<NBS_PRECISION> distribution(0.0f, 65000.0f);
+
+    ParticleType* particles = new ParticleType[ParticleCount];
+    for (size_t i = 0; i < ParticleCount; ++i) {
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            particles[i].position[dim] = distribution(generator);
+        }
+    }
+
+    spatial::CurveSortBuffers<ParticleType, curve_sort_options> curve_sort_buffers;
+    spatial::allocate_curve_sort_buffers(curve_sort_buffers);
+
+    spatial::RadixTree<Dimensions, radix_tree_options> tree;
+    spatial::allocate_radix_tree(tree);
+
+    // Sorting an already sorted array costs as much as the first sort.
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t iteration = 0; iteration < Iterations; ++iteration) {
+        spatial::sort_by_curve<Dimensions, ParticleType, curve_sort_options>(
+            particles, curve_sort_buffers, pool
+        );
+    }
+    auto sort_duration = std::chrono::high_resolution_clock::now() - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t iteration = 0; iteration < Iterations; ++iteration) {
+        spatial::build_radix_tree<Dimensions, ParticleType, radix_tree_options>(
+            particles, tree, pool
+        );
+    }
+    auto build_duration = std::chrono::high_resolution_clock::now() - start;
+
+    auto ms_per_million = [](std::chrono::high_resolution_clock::duration duration) {
+        const f32 milliseconds
+            = std::chrono::duration_cast<std::chrono::duration<f32, std::milli>>(
+                  duration
+              )
+                  .count();
+        return milliseconds / static_cast<f32>(Iterations)
+               / (static_cast<f32>(ParticleCount) / 1e6f);
+    };
+
+    std::cout << Dimensions << "D, " << ParticleCount << " particles:\n"
+              << "    Morton sort: " << ms_per_million(sort_duration)
+              << " ms per million particles\n"
+              << "    tree build:  " << ms_per_million(build_duration)
+              << " ms per million particles\n"
+              << "    root mass:   " << tree.masses[0] << std::endl;
+
+    spatial::deallocate_radix_tree(tree);
+    spatial::deallocate_curve_sort_buffers(curve_sort_buffers);
+
+    delete[] particles;
+}
+
+// Two tight groups of three particles and a third centroid far from both, warm
+// started from final clusters left with stale counts as a previous k-means would
+// leave them, so that the third cluster is empty in the last iteration.
+template <cluster::KMeansOptions Options>
+void do_k_means_empty_cluster_job(const char* name) {
+    static_assert(Options.particle_count == 6 && Options.cluster_count == 3);
+
+    const f32v2 positions[6] = { f32v2(0.0f, 0.0f),  f32v2(1.0f, 0.0f),
+                                 f32v2(0.0f, 1.0f),  f32v2(10.0f, 0.0f),
+                                 f32v2(11.0f, 0.0f), f32v2(10.0f, 1.0f) };
+
+    MyParticle2D particles[6];
+    for (size_t i = 0; i < 6; ++i) {
+        particles[i].cluster_metadata_idx = i;
+        particles[i].position             = vec<2, NBS_PRECISION>(positions[i]);
+    }
+
+    cluster::Cluster<2, MyParticle2D> clusters[6];
+    clusters[0].centroid.position = vec<2, NBS_PRECISION>(0.0f, 0.0f);
+    clusters[1].centroid.position = vec<2, NBS_PRECISION>(10.0f, 0.0f);
+    clusters[2].centroid.position = vec<2, NBS_PRECISION>(1000.0f, 1000.0f);
+    for (size_t cluster_idx = 0; cluster_idx < 3; ++cluster_idx) {
+        clusters[cluster_idx].particle_offset     = 3 * cluster_idx;
+        clusters[cluster_idx].particle_count      = cluster_idx < 2 ? 3 : 0;
+        clusters[cluster_idx + 3].particle_offset = 3 * cluster_idx;
+        clusters[cluster_idx + 3].particle_count  = 3;
+    }
+
+    cluster::KMeansBuffers<Options> buffers;
+    cluster::allocate_kmeans_buffers<Options>(buffers);
+    for (size_t i = 0; i < 6; ++i) {
+        buffers.particle_nearest_centroid[i].idx      = i < 3 ? 0 : 1;
+        buffers.particle_nearest_centroid[i].distance = 0.0f;
+    }
 
-                f32 distance_2
-                    = math::distance2(particle_1.position, cluster.centroid.position);
+    cluster::k_means<2, MyParticle2D, Options>(
+        particles, clusters, clusters + 3, buffers
+    );
+
+    size_t total_count = 0, max_count = 0;
+    bool   in_bounds   = true;
+    for (size_t cluster_idx = 3; cluster_idx < 6; ++cluster_idx) {
+        total_count += clusters[cluster_idx].particle_count;
+        max_count    = std::max(max_count, clusters[cluster_idx].particle_count);
+        in_bounds    = in_bounds
+                    && clusters[cluster_idx].particle_offset
+                               + clusters[cluster_idx].particle_count
+                           <= 6;
+    }
+
+    std::cout << name << ":\n"
+              << "    cluster sizes:     " << clusters[3].particle_count << ", "
+              << clusters[4].particle_count << ", " << clusters[5].particle_count
+              << "\n"
+              << "    sizes sum to 6:    " << (total_count == 6 ? "yes" : "NO") << "\n"
+              << "    offsets in bounds: " << (in_bounds ? "yes" : "NO") << std::endl;
+    if constexpr (Options.max_cluster_size > 0) {
+        std::cout << "    within cap:        "
+                  << (max_count <= Options.max_cluster_size ? "yes" : "NO")
+                  << std::endl;
+    }
+
+    cluster::deallocate_kmeans_buffers<Options>(buffers);
+}
+
+// Particles streaming through a box at no more than max_speed on each axis, their
+// short-range forces summed over neighbour lists kept with ListOptions.skin, and
+// checked against those found by searching cells afresh each step.
+template <typename ShortRangeLaw, spatial::CellListOptions ListOptions, size_t Steps>
+void do_neighbour_list_reuse_job(
+    NBS_PRECISION         box_size,
+    NBS_PRECISION         max_speed,
+    NBS_PRECISION         time_step,
+    parallel::ThreadPool* pool
+) {
+    constexpr ui32                     particle_count = ListOptions.particle_count;
+    constexpr spatial::CellListOptions search_options{
+        .particle_count    = particle_count,
+        .cutoff_radius     = ListOptions.cutoff_radius,
+        .max_cells_on_axis = ListOptions.max_cells_on_axis,
+    };
+
+    std::default_random_engine                    generator;
+    std::uniform_real_distribution<NBS_PRECISION> position_distribution(0.0f, box_size);
+    std::uniform_real_distribution<NBS_PRECISION> velocity_distribution(
+        -max_speed, max_speed
+    );
+
+    MyParticle2D* particles = new MyParticle2D[particle_count];
+    for (size_t i = 0; i < particle_count; ++i) {
+        particles[i].cluster_metadata_idx = i;
+        particles[i].position             = vec<2, NBS_PRECISION>(
+            position_distribution(generator), position_distribution(generator)
+        );
+        particles[i].velocity = vec<2, NBS_PRECISION>(
+            velocity_distribution(generator), velocity_distribution(generator)
+        );
+    }
+
+    vec<2, NBS_PRECISION>* searched_forces = new vec<2, NBS_PRECISION>[particle_count];
+
+    spatial::CellList<2, search_options> searched_cell_list;
+    spatial::allocate_cell_list(searched_cell_list);
+
+    spatial::CellList<2, ListOptions> listed_cell_list;
+    spatial::allocate_cell_list(listed_cell_list);
 
-                // f32 force = forces::grav_with_repulsion_6<1000>(distance_2);
-                f32 force = forces::grav(distance_2);
+    NBS_PRECISION max_error = 0.0f, max_force = 0.0f;
+    for (size_t step = 0; step < Steps; ++step) {
+        for (size_t i = 0; i < particle_count; ++i) {
+            particles[i].position  += particles[i].velocity * time_step;
+            particles[i].force      = {};
+            particles[i].potential  = 0.0f;
+        }
+
+        spatial::update_cell_list(particles, searched_cell_list, pool);
+        forces::add_short_range_forces<2, MyParticle2D, ShortRangeLaw, search_options>(
+            particles, searched_cell_list, pool
+        );
 
-                particle_1.force
-                    += math::normalize(cluster.centroid.position - particle_1.position)
-                       * force * static_cast<f32>(other_cluster.particle_count);
+        for (size_t i = 0; i < particle_count; ++i) {
+            searched_forces[i] = particles[i].force;
+            particles[i].force = {};
+        }
+
+        spatial::update_neighbour_lists(particles, listed_cell_list, pool);
+        forces::add_listed_short_range_forces<
+            2,
+            MyParticle2D,
+            ShortRangeLaw,
+            ListOptions>(particles, listed_cell_list, pool);
+
+        for (size_t i = 0; i < particle_count; ++i) {
+            max_error = math::max(
+                max_error, math::length(particles[i].force - searched_forces[i])
+            );
+            max_force = math::max(max_force, math::length(searched_forces[i]));
+        }
+    }
+
+    const spatial::NeighbourListCounters& counters = listed_cell_list.counters;
+    std::cout << particle_count << " particles, skin " << ListOptions.skin << ":\n"
+              << "    rebuilt lists " << counters.rebuilds << " times in "
+              << counters.updates << " updates\n"
+              << "    max relative difference: " << max_error / max_force
+              << std::endl;
+
+    spatial::deallocate_cell_list(listed_cell_list);
+    spatial::deallocate_cell_list(searched_cell_list);
+
+    delete[] searched_forces;
+    delete[] particles;
+}
+
+// Newtonian forces on each particle from every other, attractive with G = 1, summed
+// pair by pair for checking faster solvers against.
+template <size_t Dimensions, typename ParticleType>
+void calculate_reference_gravity(
+    const ParticleType*                 particles,
+    size_t                              particle_count,
+    OUT vec<Dimensions, NBS_PRECISION>* reference_forces
+) {
+    for (size_t i = 0; i < particle_count; ++i) {
+        reference_forces[i] = {};
+
+        for (size_t j = 0; j < particle_count; ++j) {
+            if (i == j) continue;
+
+            const vec<Dimensions, NBS_PRECISION> to_other
+                = particles[j].position - particles[i].position;
+            const NBS_PRECISION distance_2 = math::dot(to_other, to_other);
+
+            reference_forces[i] += to_other
+                                   * (mass_of(particles[j])
+                                      / (distance_2 * std::sqrt(distance_2)));
+        }
+
+        reference_forces[i] *= mass_of(particles[i]);
+    }
+}
+
+// Reports the median and largest error of the forces on particles relative to the
+// reference forces on them.
+template <size_t Dimensions, typename ParticleType>
+void report_force_errors(
+    const char*                           name,
+    const ParticleType*                   particles,
+    size_t                                particle_count,
+    const vec<Dimensions, NBS_PRECISION>* reference_forces
+) {
+    std::vector<NBS_PRECISION> errors(particle_count);
+    for (size_t i = 0; i < particle_count; ++i) {
+        errors[i] = math::length(particles[i].force - reference_forces[i])
+                    / math::length(reference_forces[i]);
+    }
+
+    std::nth_element(errors.begin(), errors.begin() + particle_count / 2, errors.end());
+    const NBS_PRECISION median_error = errors[particle_count / 2];
+    const NBS_PRECISION max_error    = *std::max_element(errors.begin(), errors.end());
+
+    std::cout << name << ":\n"
+              << "    median relative error: " << median_error << "\n"
+              << "    max relative error:    " << max_error << std::endl;
+}
+
+template <size_t Dimensions, typename ParticleType, forces::fmm::FMMOptions Options>
+void do_fmm_accuracy_job(parallel::ThreadPool* pool) {
+    constexpr size_t particle_count = Options.particle_count;
+
+    std::default_random_engine                    generator;
+    std::uniform_real_distribution<NBS_PRECISION> distribution(0.0f, 1000.0f);
+
+    ParticleType* particles = new ParticleType[particle_count];
+    for (size_t i = 0; i < particle_count; ++i) {
+        particles[i].cluster_metadata_idx = i;
+        for (size_t dim = 0; dim < Dimensions; ++dim) {
+            particles[i].position[dim] = distribution(generator);
+        }
+    }
+
+    vec<Dimensions, NBS_PRECISION>* reference_forces
+        = new vec<Dimensions, NBS_PRECISION>[particle_count];
+    calculate_reference_gravity<Dimensions>(
+        particles, particle_count, reference_forces
+    );
+
+    forces::fmm::FMMBuffers<Dimensions, Options> buffers;
+    forces::fmm::allocate_fmm_buffers<Dimensions, Options>(buffers);
+
+    forces::fmm::calculate_forces<Dimensions, ParticleType, Options>(
+        particles, buffers, pool
+    );
+
+    std::cout << Dimensions << "D, " << particle_count << " particles, order "
+              << Options.expansion_order << ", depth " << Options.tree_depth << "\n";
+    report_force_errors<Dimensions>(
+        "FMM against direct sum", particles, particle_count, reference_forces
+    );
+
+    forces::fmm::deallocate_fmm_buffers<Dimensions, Options>(buffers);
+
+    delete[] reference_forces;
+    delete[] particles;
+}
+
+// Particles placed uniformly in the unit cube, against a direct sum if isolated or an
+// Ewald sum if periodic.
+template <forces::pm::PMOptions Options>
+void do_pm_accuracy_job(const char* name, parallel::ThreadPool* pool) {
+    constexpr size_t particle_count = Options.particle_count;
+    constexpr bool   periodic
+        = Options.boundary == forces::pm::Boundary::PERIODIC;
+
+    std::default_random_engine                    generator;
+    std::uniform_real_distribution<NBS_PRECISION> distribution(0.0f, 1.0f);
+
+    MyParticle* particles = new MyParticle[particle_count];
+    for (size_t i = 0; i < particle_count; ++i) {
+        particles[i].cluster_metadata_idx = i;
+        for (size_t dim = 0; dim < 3; ++dim) {
+            particles[i].position[dim] = distribution(generator);
+        }
+    }
+
+    vec<3, NBS_PRECISION>* reference_forces = new vec<3, NBS_PRECISION>[particle_count];
+    if constexpr (periodic) {
+        constexpr forces::ewald::EwaldOptions ewald_options{
+            .particle_count = particle_count, .box_size = Options.box_size
+        };
+
+        forces::ewald::EwaldTable<ewald_options> table;
+        forces::ewald::allocate_ewald_table(table, pool);
+
+        forces::ewald::calculate_forces<MyParticle, ewald_options>(
+            particles, table, pool
+        );
+        for (size_t i = 0; i < particle_count; ++i) {
+            reference_forces[i] = particles[i].force;
+        }
+
+        forces::ewald::deallocate_ewald_table(table);
+    } else {
+        calculate_reference_gravity<3>(particles, particle_count, reference_forces);
+    }
+
+    forces::pm::PMBuffers<3, Options> buffers;
+    forces::pm::allocate_pm_buffers<3, Options>(buffers, pool);
+
+    forces::pm::calculate_forces<3, MyParticle, Options>(particles, buffers, pool);
+
+    report_force_errors<3>(name, particles, particle_count, reference_forces);
+
+    forces::pm::deallocate_pm_buffers<3, Options>(buffers);
+
+    delete[] reference_forces;
+    delete[] particles;
+}
+
+// A clustered cloud of ten Gaussian blobs, for which the mesh alone resolves the
+// forces poorly, against a direct sum, with and without the short-range sums.
+template <forces::p3m::P3MOptions Options>
+void do_p3m_accuracy_job(parallel::ThreadPool* pool) {
+    constexpr size_t particle_count = Options.mesh.particle_count;
+
+    constexpr forces::pm::PMOptions mesh_alone_options{
+        .particle_count = particle_count,
+        .grid_size      = Options.mesh.grid_size,
+        .assignment     = Options.mesh.assignment,
+    };
+
+    std::default_random_engine              generator;
+    std::normal_distribution<NBS_PRECISION> blob_distribution(0.0f, 0.08f);
+
+    MyParticle* particles = new MyParticle[particle_count];
+    for (size_t i = 0; i < particle_count; ++i) {
+        const NBS_PRECISION blob_idx = static_cast<NBS_PRECISION>(i % 10);
+
+        particles[i].cluster_metadata_idx = i;
+        particles[i].position             = vec<3, NBS_PRECISION>(
+            std::sin(blob_idx) + blob_distribution(generator),
+            std::cos(2.0f * blob_idx) + blob_distribution(generator),
+            std::sin(3.0f * blob_idx) + blob_distribution(generator)
+        );
+    }
+
+    vec<3, NBS_PRECISION>* reference_forces = new vec<3, NBS_PRECISION>[particle_count];
+    calculate_reference_gravity<3>(particles, particle_count, reference_forces);
+
+    forces::p3m::P3MBuffers<3, Options> buffers;
+    forces::p3m::allocate_p3m_buffers<3, Options>(buffers, pool);
+
+    forces::p3m::calculate_forces<3, MyParticle, Options>(particles, buffers, pool);
+
+    report_force_errors<3>(
+        "P3M against direct sum", particles, particle_count, reference_forces
+    );
+
+    forces::p3m::deallocate_p3m_buffers<3, Options>(buffers);
+
+    forces::pm::PMBuffers<3, mesh_alone_options> mesh_alone_buffers;
+    forces::pm::allocate_pm_buffers<3, mesh_alone_options>(mesh_alone_buffers, pool);
+
+    forces::pm::calculate_forces<3, MyParticle, mesh_alone_options>(
+        particles, mesh_alone_buffers, pool
+    );
+
+    report_force_errors<3>(
+        "PM alone against direct sum", particles, particle_count, reference_forces
+    );
+
+    forces::pm::deallocate_pm_buffers<3, mesh_alone_options>(mesh_alone_buffers);
+
+    delete[] reference_forces;
+    delete[] particles;
+}
+
+// Forces on particles in the periodic box [0, box_size)^3 from every other particle
+// and all of their images, attractive with G = 1, by classic Ewald summation in
+// double precision, independent of the Ewald table: real-space sums over the nearest
+// 27 images and reciprocal-space sums over 21^3 wave vectors.
+template <typename ParticleType>
+void calculate_reference_ewald_gravity(
+    const ParticleType*        particles,
+    size_t                     particle_count,
+    f64                        box_size,
+    OUT vec<3, NBS_PRECISION>* reference_forces
+) {
+    constexpr i32 max_image = 1;
+    constexpr i32 max_wave  = 10;
+
+    const f64 alpha       = 6.0 / box_size;
+    const f64 wave_number = 2.0 * std::numbers::pi / box_size;
+
+    std::vector<f64v3> positions(particle_count);
+    std::vector<f64v3> forces(particle_count, f64v3{});
+    for (size_t i = 0; i < particle_count; ++i) {
+        for (size_t dim = 0; dim < 3; ++dim) {
+            positions[i][dim] = static_cast<f64>(particles[i].position[dim]);
+        }
+    }
+
+    // Real-space sums, each pair screened by erfc beyond a fraction of the box.
+    for (size_t i = 0; i < particle_count; ++i) {
+        for (size_t j = 0; j < particle_count; ++j) {
+            if (i == j) continue;
+
+            const f64 mass_product = static_cast<f64>(mass_of(particles[i]))
+                                     * static_cast<f64>(mass_of(particles[j]));
+
+            for (i32 x = -max_image; x <= max_image; ++x) {
+                for (i32 y = -max_image; y <= max_image; ++y) {
+                    for (i32 z = -max_image; z <= max_image; ++z) {
+                        const f64v3 to_image = positions[j] - positions[i]
+                                               + f64v3(x, y, z) * box_size;
+                        const f64 distance = math::length(to_image);
+
+                        const f64 magnitude
+                            = std::erfc(alpha * distance) / (distance * distance)
+                              + 2.0 * alpha / std::sqrt(std::numbers::pi)
+                                    * std::exp(-alpha * alpha * distance * distance)
+                                    / distance;
+
+                        forces[i] += to_image * (mass_product * magnitude / distance);
+                    }
+                }
             }
         }
+    }
 
-        for (size_t offset = 0; offset < cluster.particle_count; ++offset) {
-            auto& particle = particles[cluster.particle_offset + offset];
+    // Reciprocal-space sums, through the structure factor of each wave vector.
+    for (i32 x = -max_wave; x <= max_wave; ++x) {
+        for (i32 y = -max_wave; y <= max_wave; ++y) {
+            for (i32 z = -max_wave; z <= max_wave; ++z) {
+                if (x == 0 && y == 0 && z == 0) continue;
+
+                const f64v3 wave   = f64v3(x, y, z) * wave_number;
+                const f64   wave_2 = math::dot(wave, wave);
+                const f64   weight = 4.0 * std::numbers::pi
+                                   / (box_size * box_size * box_size * wave_2)
+                                   * std::exp(-wave_2 / (4.0 * alpha * alpha));
+
+                std::complex<f64> structure_factor = 0.0;
+                for (size_t j = 0; j < particle_count; ++j) {
+                    const f64 mass = static_cast<f64>(mass_of(particles[j]));
+
+                    structure_factor
+                        += mass * std::polar(1.0, math::dot(wave, positions[j]));
+                }
+
+                for (size_t i = 0; i < particle_count; ++i) {
+                    const f64 phase = std::imag(
+                        std::polar(1.0, -math::dot(wave, positions[i]))
+                        * structure_factor
+                    );
+
+                    forces[i] += wave
+                                 * (static_cast<f64>(mass_of(particles[i])) * weight
+                                    * phase);
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < particle_count; ++i) {
+        for (size_t dim = 0; dim < 3; ++dim) {
+            reference_forces[i][dim] = forces[i][dim];
+        }
+    }
+}
 
-            const f32 t_fact = 100.0f;
+// Particles placed uniformly in a periodic box, with forces from the Ewald table
+// against an independent Ewald sum.
+template <forces::ewald::EwaldOptions Options>
+void do_ewald_accuracy_job(parallel::ThreadPool* pool) {
+    constexpr size_t particle_count = Options.particle_count;
 
-            particle.velocity += particle.force * t_fact;
-            particle.position
-                += particle.velocity * t_fact - 0.5f * particle.force * t_fact * t_fact;
+    std::default_random_engine                    generator;
+    std::uniform_real_distribution<NBS_PRECISION> distribution(0.0f, Options.box_size);
+
+    MyParticle* particles = new MyParticle[particle_count];
+    for (size_t i = 0; i < particle_count; ++i) {
+        particles[i].cluster_metadata_idx = i;
+        for (size_t dim = 0; dim < 3; ++dim) {
+            particles[i].position[dim] = distribution(generator);
         }
     }
+
+    vec<3, NBS_PRECISION>* reference_forces = new vec<3, NBS_PRECISION>[particle_count];
+    calculate_reference_ewald_gravity(
+        particles, particle_count, Options.box_size, reference_forces
+    );
+
+    forces::ewald::EwaldTable<Options> table;
+    forces::ewald::allocate_ewald_table(table, pool);
+
+    forces::ewald::calculate_forces<MyParticle, Options>(particles, table, pool);
+
+    report_force_errors<3>(
+        "Ewald table against Ewald sum", particles, particle_count, reference_forces
+    );
+
+    forces::ewald::deallocate_ewald_table(table);
+
+    delete[] reference_forces;
+    delete[] particles;
+}
+
+// Particles in Gaussian clumps in a periodic box, one straddling its corner, with
+// forces from the Ewald summing ForceSolver against the exact periodic sum of
+// ewald::calculate_forces.
+template <size_t ParticleCount, size_t ClusterCount>
+void do_periodic_solver_accuracy_job(parallel::ThreadPool* pool) {
+    constexpr cluster::KMeansOptions k_means_options{
+        .particle_count = ParticleCount,
+        .cluster_count  = ClusterCount,
+        .front_loaded   = true,
+        .periodic       = true,
+        .box_size       = 10,
+    };
+    constexpr forces::ewald::EwaldOptions ewald_options{
+        .particle_count = ParticleCount, .box_size = k_means_options.box_size
+    };
+
+    using PeriodicForceSolver = forces::ForceSolver<
+        3,
+        MyParticle,
+        forces::laws::Gravity,
+        forces::ForceSolverOptions{ .opening_angle = 0.5f,
+                                    .periodic      = true,
+                                    .box_size      = k_means_options.box_size }>;
+
+    constexpr NBS_PRECISION box_size = k_means_options.box_size;
+
+    std::default_random_engine                    generator;
+    std::uniform_real_distribution<NBS_PRECISION> box_distribution(0.0f, box_size);
+    std::normal_distribution<NBS_PRECISION>       clump_distribution(0.0f, 0.4f);
+
+    vec<3, NBS_PRECISION> clump_centres[8];
+    for (vec<3, NBS_PRECISION>& clump_centre : clump_centres) {
+        clump_centre = vec<3, NBS_PRECISION>(
+            box_distribution(generator),
+            box_distribution(generator),
+            box_distribution(generator)
+        );
+    }
+    clump_centres[0] = vec<3, NBS_PRECISION>(0.1f, 9.9f, 5.0f);
+
+    MyParticle* particles = new MyParticle[ParticleCount];
+    for (size_t i = 0; i < ParticleCount; ++i) {
+        particles[i].cluster_metadata_idx = i;
+        particles[i].position             = spatial::wrap_position<3>(
+            clump_centres[i % 8]
+                + vec<3, NBS_PRECISION>(
+                    clump_distribution(generator),
+                    clump_distribution(generator),
+                    clump_distribution(generator)
+                ),
+            box_size
+        );
+    }
+
+    cluster::Cluster<3, MyParticle>* clusters
+        = new cluster::Cluster<3, MyParticle>[ClusterCount * 2];
+
+    cluster::kpp<3, MyParticle, k_means_options>(particles, clusters, nullptr, pool);
+
+    clusters[0].particle_count  = ParticleCount;
+    clusters[0].particle_offset = 0;
+
+    cluster::KMeansBuffers<k_means_options> k_means_buffers;
+    cluster::allocate_kmeans_buffers<k_means_options>(k_means_buffers);
+
+    cluster::k_means<3, MyParticle, k_means_options>(
+        particles, clusters, clusters + ClusterCount, k_means_buffers, nullptr, pool
+    );
+
+    // Clustering sorts the particles, so the reference is taken after.
+    vec<3, NBS_PRECISION>* reference_forces = new vec<3, NBS_PRECISION>[ParticleCount];
+    {
+        forces::ewald::EwaldTable<ewald_options> table;
+        forces::ewald::allocate_ewald_table(table, pool);
+
+        forces::ewald::calculate_forces<MyParticle, ewald_options>(
+            particles, table, pool
+        );
+        for (size_t i = 0; i < ParticleCount; ++i) {
+            reference_forces[i] = particles[i].force;
+        }
+
+        forces::ewald::deallocate_ewald_table(table);
+    }
+
+    PeriodicForceSolver solver(ClusterCount, pool);
+    solver.calculate_forces(particles, clusters + ClusterCount, ClusterCount);
+
+    report_force_errors<3>(
+        "Periodic ForceSolver against exact periodic sum",
+        particles,
+        ParticleCount,
+        reference_forces
+    );
+
+    cluster::deallocate_kmeans_buffers<k_means_options>(k_means_buffers);
+
+    delete[] reference_forces;
+    delete[] clusters;
+    delete[] particles;
+}
+
+// Clusters the A1 dataset once and starts its particles at rest.
+template <size_t ClusterCount>
+void do_a1_at_rest_job(
+    MyParticle2D*& particles, cluster::Cluster<2, MyParticle2D>*& clusters
+) {
+    do_a_cluster_job_a1<ClusterCount, 1>(particles, clusters);
+
+    for (size_t i = 0; i < 7500; ++i) {
+        particles[i].velocity = {};
+        particles[i].force    = {};
+    }
+}
+
+// Records the diagnostics of particles with current forces and potentials, for
+// integrators that don't accumulate them as they step.
+void do_record_a1_diagnostics(
+    const MyParticle2D*                     particles,
+    NBS_PRECISION                           time,
+    diagnostics::DiagnosticsAccumulator<2>& diagnostics_accumulator,
+    diagnostics::DiagnosticsSeries<2>&      diagnostics_series
+) {
+    diagnostics::reset_diagnostics_accumulator(diagnostics_accumulator);
+
+    for (size_t i = 0; i < 7500; ++i) {
+        diagnostics::accumulate_particle_diagnostics<2>(
+            diagnostics_accumulator
+                .block_sums[i / diagnostics::DIAGNOSTICS_BLOCK_SIZE],
+            particles[i]
+        );
+    }
+
+    diagnostics::record_diagnostics(
+        diagnostics_series,
+        time,
+        diagnostics::reduce_diagnostics(diagnostics_accumulator)
+    );
+}
+
+void do_report_a1_integrator(
+    const char*                              name,
+    size_t                                   force_evaluations,
+    i64                                      force_us,
+    const diagnostics::DiagnosticsSeries<2>& diagnostics_series
+) {
+    std::cout << name << ":\n    particle force evaluations: " << force_evaluations
+              << "\n    time calculating forces:    " << force_us / 1000 << "ms"
+              << "\n    relative energy error:      "
+              << diagnostics::relative_energy_error(diagnostics_series) << std::endl;
+}
+
+i64 microseconds_since(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::high_resolution_clock::now() - start
+    )
+        .count();
+}
+
+// Steps the A1 dataset from rest for Steps steps of time_step under Integrator, with
+// the forces of every particle calculated afresh by the ForceSolver each time.
+template <typename Integrator, size_t Steps, size_t ClusterCount = 50>
+void do_a1_integrator_job(
+    const char* name, NBS_PRECISION time_step, parallel::ThreadPool* pool
+) {
+    MyParticle2D*                      particles;
+    cluster::Cluster<2, MyParticle2D>* clusters;
+
+    do_a1_at_rest_job<ClusterCount>(particles, clusters);
+
+    A1ForceSolver solver(ClusterCount, pool);
+
+    diagnostics::DiagnosticsAccumulator<2> diagnostics_accumulator;
+    diagnostics::allocate_diagnostics_accumulator(diagnostics_accumulator, 7500);
+
+    diagnostics::DiagnosticsSeries<2> diagnostics_series;
+    diagnostics::allocate_diagnostics_series(diagnostics_series, Steps);
+
+    size_t force_evaluations = 0;
+    i64    force_us          = 0;
+
+    auto calculate_forces = [&]() {
+        auto start = std::chrono::high_resolution_clock::now();
+        solver.calculate_forces(particles, clusters + ClusterCount, ClusterCount);
+        force_us          += microseconds_since(start);
+        force_evaluations += 7500;
+    };
+
+    calculate_forces();
+    do_record_a1_diagnostics(
+        particles, 0.0f, diagnostics_accumulator, diagnostics_series
+    );
+
+    for (size_t step = 0; step < Steps; ++step) {
+        Integrator::template step<2, MyParticle2D>(
+            particles, 7500, time_step, calculate_forces, pool, &diagnostics_accumulator
+        );
+
+        diagnostics::record_diagnostics(
+            diagnostics_series,
+            time_step * static_cast<NBS_PRECISION>(step + 1),
+            diagnostics::reduce_diagnostics(diagnostics_accumulator)
+        );
+    }
+
+    do_report_a1_integrator(name, force_evaluations, force_us, diagnostics_series);
+
+    diagnostics::deallocate_diagnostics_series(diagnostics_series);
+    diagnostics::deallocate_diagnostics_accumulator(diagnostics_accumulator);
+
+    delete[] clusters;
+    delete[] particles;
+}
+
+// As do_a1_integrator_job, but with block timesteps, so that each force calculation
+// only updates the forces of the particles whose steps end on it. Particles are
+// reclustered between steps once their clusters drift, the block timestep state
+// being indexed by cluster_metadata_idx, and k-means reconsidering only particles
+// that have moved.
+template <integrators::BlockTimestepOptions Options, size_t Steps>
+void do_a1_block_timestep_job(NBS_PRECISION time_step, parallel::ThreadPool* pool) {
+    MyParticle2D*                      particles;
+    cluster::Cluster<2, MyParticle2D>* clusters;
+
+    do_a1_at_rest_job<50>(particles, clusters);
+
+    A1ForceSolver solver(50, pool);
+
+    diagnostics::DiagnosticsAccumulator<2> diagnostics_accumulator;
+    diagnostics::allocate_diagnostics_accumulator(diagnostics_accumulator, 7500);
+
+    diagnostics::DiagnosticsSeries<2> diagnostics_series;
+    diagnostics::allocate_diagnostics_series(diagnostics_series, Steps);
+
+    integrators::BlockTimestepBuffers<2, Options> block_timestep_buffers;
+    integrators::allocate_block_timestep_buffers(block_timestep_buffers);
+
+    A1ReclusterBuffers<50> recluster_buffers;
+    cluster::allocate_recluster_buffers(recluster_buffers);
+    cluster::reset_drift_reference<2, MyParticle2D, A1_RECLUSTER_OPTIONS<50>>(
+        particles, clusters + 50, recluster_buffers, pool
+    );
+
+    i64 force_us = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    solver.calculate_forces(particles, clusters + 50, 50);
+    force_us += microseconds_since(start);
+
+    do_record_a1_diagnostics(
+        particles, 0.0f, diagnostics_accumulator, diagnostics_series
+    );
+
+    integrators::initialise_block_timesteps<2, MyParticle2D, Options>(
+        particles, time_step, block_timestep_buffers
+    );
+
+    size_t force_evaluations = 7500;
+    for (size_t step = 0; step < Steps; ++step) {
+        force_evaluations
+            += integrators::block_timestep<2, MyParticle2D, Options>(
+                particles,
+                time_step,
+                [&](const bool* active) {
+                    start = std::chrono::high_resolution_clock::now();
+                    solver.calculate_forces(particles, clusters + 50, 50, active);
+                    force_us += microseconds_since(start);
+                },
+                block_timestep_buffers,
+                pool
+            );
+
+        // Every particle ends a step on the last substep, so all forces and
+        // potentials are current.
+        do_record_a1_diagnostics(
+            particles,
+            time_step * static_cast<NBS_PRECISION>(step + 1),
+            diagnostics_accumulator,
+            diagnostics_series
+        );
+
+        const bool reclustered = cluster::
+            recluster_if_drifted<2, MyParticle2D, A1_RECLUSTER_OPTIONS<50>>(
+                particles, clusters + 50, clusters, recluster_buffers, pool
+            );
+
+        if (reclustered) solver.invalidate_interaction_lists();
+    }
+
+    do_report_a1_integrator(
+        "Block timesteps", force_evaluations, force_us, diagnostics_series
+    );
+
+    const cluster::ReclusterCounters& counters = recluster_buffers.counters;
+    std::cout << "    reclustered:                " << counters.reclusters
+              << " times, reconsidering " << counters.particles_reconsidered
+              << " particles" << std::endl;
+
+    cluster::deallocate_recluster_buffers(recluster_buffers);
+    integrators::deallocate_block_timestep_buffers(block_timestep_buffers);
+    diagnostics::deallocate_diagnostics_series(diagnostics_series);
+    diagnostics::deallocate_diagnostics_accumulator(diagnostics_accumulator);
+
+    delete[] clusters;
+    delete[] particles;
+}
+
+// As do_a1_integrator_job, but with RESPA, the near forces stepped
+// A1_RESPA_OPTIONS.substeps times for each step of the far forces. Near and far force
+// evaluations of a particle are counted separately, so time is the fairer measure.
+template <size_t Steps, size_t ClusterCount>
+void do_a1_respa_job(const char* name, parallel::ThreadPool* pool) {
+    MyParticle2D*                      particles;
+    cluster::Cluster<2, MyParticle2D>* clusters;
+
+    do_a1_at_rest_job<ClusterCount>(particles, clusters);
+
+    A1ForceSolver solver(ClusterCount, pool);
+
+    diagnostics::DiagnosticsAccumulator<2> diagnostics_accumulator;
+    diagnostics::allocate_diagnostics_accumulator(diagnostics_accumulator, 7500);
+
+    diagnostics::DiagnosticsSeries<2> diagnostics_series;
+    diagnostics::allocate_diagnostics_series(diagnostics_series, Steps);
+
+    A1RespaBuffers respa_buffers;
+    integrators::allocate_respa_buffers(respa_buffers);
+
+    size_t force_evaluations = 0;
+    i64    force_us          = 0;
+
+    auto calculate_near_forces = [&]() {
+        auto start = std::chrono::high_resolution_clock::now();
+        do_calculate_near_forces<ClusterCount>(
+            particles, clusters + ClusterCount, solver
+        );
+        force_us          += microseconds_since(start);
+        force_evaluations += 7500;
+    };
+    auto calculate_far_forces = [&]() {
+        auto start = std::chrono::high_resolution_clock::now();
+        const bool rebuilt = do_calculate_far_forces<ClusterCount>(
+            particles, clusters + ClusterCount, solver
+        );
+        force_us          += microseconds_since(start);
+        force_evaluations += 7500;
+        return rebuilt;
+    };
+
+    integrators::initialise_respa<2, MyParticle2D, A1_RESPA_OPTIONS>(
+        particles, calculate_near_forces, calculate_far_forces, respa_buffers, pool
+    );
+    do_record_a1_diagnostics(
+        particles, 0.0f, diagnostics_accumulator, diagnostics_series
+    );
+
+    for (size_t step = 0; step < Steps; ++step) {
+        integrators::respa_step<2, MyParticle2D, A1_RESPA_OPTIONS>(
+            particles,
+            A1_TIME_STEP,
+            calculate_near_forces,
+            calculate_far_forces,
+            respa_buffers,
+            pool,
+            &diagnostics_accumulator
+        );
+
+        diagnostics::record_diagnostics(
+            diagnostics_series,
+            A1_TIME_STEP * static_cast<NBS_PRECISION>(step + 1),
+            diagnostics::reduce_diagnostics(diagnostics_accumulator)
+        );
+    }
+
+    do_report_a1_integrator(name, force_evaluations, force_us, diagnostics_series);
+
+    integrators::deallocate_respa_buffers(respa_buffers);
+    diagnostics::deallocate_diagnostics_series(diagnostics_series);
+    diagnostics::deallocate_diagnostics_accumulator(diagnostics_accumulator);
+
+    delete[] clusters;
+    delete[] particles;
+}
+
+// Forces of the direct kernel on a cluster-sized chunk of A1 moved offset along each
+// axis, against a pair sum in f64 of the positions as given rather than as stored,
+// and the time the A1ForceSolver takes over the whole of A1 so moved. Far from the
+// origin, single precision storage loses most of the digits of the differences
+// between positions, which mixed precision keeps by storing in double precision.
+// Build with NBS_USE_MIXED_PRECISION or NBS_USE_DOUBLE_PRECISION to compare.
+template <size_t ParticleCount, size_t Iterations>
+void do_precision_job(f64 offset, parallel::ThreadPool* pool) {
+    using Law = forces::laws::PlummerGravity<static_cast<NBS_PRECISION>(100)>;
+
+    MyParticle2D* particles = new MyParticle2D[ParticleCount];
+    f64v2*        positions = new f64v2[ParticleCount];
+    for (size_t i = 0; i < ParticleCount; ++i) {
+        positions[i]          = f64v2(A1_DATA[i]) + f64v2(offset);
+        particles[i].position = vec<2, NBS_PRECISION>(positions[i]);
+    }
+
+    f64v2* reference_forces = new f64v2[ParticleCount];
+    for (size_t i = 0; i < ParticleCount; ++i) {
+        reference_forces[i] = {};
+
+        for (size_t j = 0; j < ParticleCount; ++j) {
+            if (i == j) continue;
+
+            const f64v2 to_other   = positions[j] - positions[i];
+            const f64   distance_2 = math::dot(to_other, to_other)
+                                   + static_cast<f64>(Law::softening_2);
+
+            reference_forces[i] += to_other / (distance_2 * std::sqrt(distance_2));
+        }
+    }
+
+    forces::DirectKernelScratch<2> scratch{};
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t iteration = 0; iteration < Iterations; ++iteration) {
+        for (size_t i = 0; i < ParticleCount; ++i) particles[i].force = {};
+
+        forces::gather_direct_kernel_scratch<2, MyParticle2D>(
+            particles, ParticleCount, scratch
+        );
+        forces::direct_sum_symmetric<2, Law>(scratch, ParticleCount);
+        forces::scatter_direct_kernel_scratch<2, MyParticle2D>(
+            scratch, ParticleCount, particles
+        );
+    }
+    const i64 kernel_us = microseconds_since(start);
+
+    std::vector<f64> errors(ParticleCount);
+    for (size_t i = 0; i < ParticleCount; ++i) {
+        errors[i] = math::length(f64v2(particles[i].force) - reference_forces[i])
+                    / math::length(reference_forces[i]);
+    }
+
+    std::nth_element(errors.begin(), errors.begin() + ParticleCount / 2, errors.end());
+    const f64 median_error = errors[ParticleCount / 2];
+    const f64 max_error    = *std::max_element(errors.begin(), errors.end());
+
+    const f64 pair_count = static_cast<f64>(ParticleCount * (ParticleCount - 1) / 2)
+                           * static_cast<f64>(Iterations);
+
+    MyParticle2D*                      a1_particles;
+    cluster::Cluster<2, MyParticle2D>* a1_clusters;
+
+    do_a1_at_rest_job<50>(a1_particles, a1_clusters);
+    for (size_t i = 0; i < 7500; ++i) {
+        a1_particles[i].position = vec<2, NBS_PRECISION>(
+            f64v2(a1_particles[i].position) + f64v2(offset)
+        );
+    }
+
+    A1ForceSolver solver(50, pool);
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t iteration = 0; iteration < Iterations; ++iteration) {
+        solver.calculate_forces(a1_particles, a1_clusters + 50, 50);
+    }
+    const i64 solver_us = microseconds_since(start);
+
+    std::cout << "A1 moved by " << offset << ":\n"
+              << "    direct kernel median relative error: " << median_error << "\n"
+              << "    direct kernel max relative error:    " << max_error << "\n"
+              << "    direct kernel:                       "
+              << pair_count / (static_cast<f64>(kernel_us) / 1e6) << " pairs/s\n"
+              << "    ForceSolver on all of A1:            "
+              << static_cast<f64>(solver_us) / 1000.0 / static_cast<f64>(Iterations)
+              << "ms" << std::endl;
+
+    forces::deallocate_direct_kernel_scratch(scratch);
+
+    delete[] a1_clusters;
+    delete[] a1_particles;
+    delete[] reference_forces;
+    delete[] positions;
+    delete[] particles;
 }
 
 void do_2D_uniform_distribution_case() {
@@ -444,29 +1669,392 @@ void do_a1_dataset_optimise_kpp_case() {
         particles[i].force    = {};
     }
 
+    parallel::ThreadPool pool;
+    A1ForceSolver        solver(50, &pool);
+
+    A1ReclusterBuffers<50> recluster_buffers;
+    cluster::allocate_recluster_buffers(recluster_buffers);
+    cluster::reset_drift_reference<2, MyParticle2D, A1_RECLUSTER_OPTIONS<50>>(
+        particles, clusters + 50, recluster_buffers, &pool
+    );
+
+    A1CurveSortBuffers curve_sort_buffers;
+    spatial::allocate_curve_sort_buffers(curve_sort_buffers);
+    spatial::sort_clusters_by_curve<2, MyParticle2D, A1_CURVE_SORT_OPTIONS>(
+        particles, clusters + 50, 50, curve_sort_buffers, &pool
+    );
+
+    diagnostics::DiagnosticsAccumulator<2> diagnostics_accumulator;
+    diagnostics::allocate_diagnostics_accumulator(diagnostics_accumulator, 7500);
+
+    diagnostics::DiagnosticsSeries<2> diagnostics_series;
+    diagnostics::allocate_diagnostics_series(diagnostics_series, 160);
+
+    A1RespaBuffers respa_buffers;
+    integrators::allocate_respa_buffers(respa_buffers);
+
+    // Integrators expect forces to be current before the first step.
+    do_initialise_respa<50>(
+        particles, clusters + 50, solver, respa_buffers, &pool
+    );
+
     for (size_t i = 0; i < 10; ++i) {
-        do_run_sim_step<50>(particles, clusters + 50);
+        do_run_sim_step<50>(
+            particles,
+            clusters + 50,
+            clusters,
+            recluster_buffers,
+            curve_sort_buffers,
+            solver,
+            respa_buffers,
+            diagnostics_accumulator,
+            diagnostics_series,
+            &pool
+        );
     }
 
     make_2d_cluster_view(particles, clusters, &clip_rect);
 
     for (size_t i = 0; i < 20; ++i) {
-        do_run_sim_step<50>(particles, clusters + 50);
+        do_run_sim_step<50>(
+            particles,
+            clusters + 50,
+            clusters,
+            recluster_buffers,
+            curve_sort_buffers,
+            solver,
+            respa_buffers,
+            diagnostics_accumulator,
+            diagnostics_series,
+            &pool
+        );
     }
 
     make_2d_cluster_view(particles, clusters, &clip_rect);
 
     for (size_t i = 0; i < 50; ++i) {
-        do_run_sim_step<50>(particles, clusters + 50);
+        do_run_sim_step<50>(
+            particles,
+            clusters + 50,
+            clusters,
+            recluster_buffers,
+            curve_sort_buffers,
+            solver,
+            respa_buffers,
+            diagnostics_accumulator,
+            diagnostics_series,
+            &pool
+        );
     }
 
     make_2d_cluster_view(particles, clusters, &clip_rect);
 
     for (size_t i = 0; i < 80; ++i) {
-        do_run_sim_step<50>(particles, clusters + 50);
+        do_run_sim_step<50>(
+            particles,
+            clusters + 50,
+            clusters,
+            recluster_buffers,
+            curve_sort_buffers,
+            solver,
+            respa_buffers,
+            diagnostics_accumulator,
+            diagnostics_series,
+            &pool
+        );
     }
 
     make_2d_cluster_view(particles, clusters, &clip_rect);
+
+    const cluster::ReclusterCounters& counters = recluster_buffers.counters;
+    std::cout << "Reclustered " << counters.reclusters << " times in "
+              << counters.checks << " steps ("
+              << 100.0f * static_cast<f32>(counters.reclusters)
+                     / static_cast<f32>(counters.checks)
+              << "%), reconsidering " << counters.particles_reconsidered
+              << " particles" << std::endl;
+
+    const forces::InteractionListCounters& interaction_counters
+        = solver.interaction_list_counters();
+    std::cout << "Rebuilt interaction lists " << interaction_counters.rebuilds
+              << " times in " << interaction_counters.checks << " force calculations"
+              << std::endl;
+
+    const diagnostics::Diagnostics<2>& last_diagnostics
+        = diagnostics::recorded_diagnostics(diagnostics_series);
+    std::cout << "Relative energy error: "
+              << diagnostics::relative_energy_error(diagnostics_series)
+              << ", virial ratio: " << diagnostics::virial_ratio(last_diagnostics)
+              << ", momentum: " << math::length(last_diagnostics.momentum)
+              << std::endl;
+
+    diagnostics::deallocate_diagnostics_series(diagnostics_series);
+    diagnostics::deallocate_diagnostics_accumulator(diagnostics_accumulator);
+    spatial::deallocate_curve_sort_buffers(curve_sort_buffers);
+    cluster::deallocate_recluster_buffers(recluster_buffers);
+    integrators::deallocate_respa_buffers(respa_buffers);
+}
+
+void do_direct_kernel_benchmark_case() {
+    do_direct_kernel_benchmark_job<forces::laws::Gravity, 1000, 20>("grav");
+    do_direct_kernel_benchmark_job<forces::laws::GravityWithRepulsion6<1000>, 1000, 20>(
+        "grav_with_repulsion_6"
+    );
+}
+
+void do_fmm_accuracy_case() {
+    parallel::ThreadPool pool;
+
+    do_fmm_accuracy_job<
+        2,
+        MyParticle2D,
+        forces::fmm::FMMOptions{
+            .particle_count = 2000, .expansion_order = 4, .tree_depth = 3 }>(&pool);
+    do_fmm_accuracy_job<
+        3,
+        MyParticle,
+        forces::fmm::FMMOptions{
+            .particle_count = 2000, .expansion_order = 4, .tree_depth = 3 }>(&pool);
+}
+
+void do_pm_accuracy_case() {
+    parallel::ThreadPool pool;
+
+    do_pm_accuracy_job<
+        forces::pm::PMOptions{ .particle_count = 2000, .grid_size = 64 }>(
+        "Isolated PM against direct sum", &pool
+    );
+    do_pm_accuracy_job<forces::pm::PMOptions{
+        .particle_count = 2000,
+        .grid_size      = 64,
+        .assignment     = forces::pm::MassAssignment::TRIANGULAR_SHAPED_CLOUD,
+        .boundary       = forces::pm::Boundary::PERIODIC,
+        .box_size       = 1 }>("Periodic PM against Ewald sum", &pool);
+}
+
+void do_p3m_accuracy_case() {
+    parallel::ThreadPool pool;
+
+    do_p3m_accuracy_job<forces::p3m::P3MOptions{
+        .mesh = { .particle_count = 4000, .grid_size = 64, .split_scale = 0.05f } }>(
+        &pool
+    );
+}
+
+void do_ewald_accuracy_case() {
+    parallel::ThreadPool pool;
+
+    do_ewald_accuracy_job<forces::ewald::EwaldOptions{ .particle_count = 200,
+                                                       .box_size       = 1 }>(&pool);
+    do_periodic_solver_accuracy_job<3000, 40>(&pool);
+}
+
+// Each integrator makes about the same number of force evaluations over the same
+// span of time, Yoshida taking three a step.
+void do_a1_integrators_case() {
+    parallel::ThreadPool pool;
+
+    do_a1_integrator_job<integrators::Leapfrog, 320>("Leapfrog", 25.0f, &pool);
+    do_a1_integrator_job<integrators::VelocityVerlet, 320>(
+        "Velocity Verlet", 25.0f, &pool
+    );
+    do_a1_integrator_job<integrators::Yoshida4, 100>("Yoshida", 80.0f, &pool);
+}
+
+void do_a1_block_timestep_case() {
+    parallel::ThreadPool pool;
+
+    do_a1_integrator_job<integrators::Leapfrog, 640>("Leapfrog", 25.0f, &pool);
+    do_a1_block_timestep_job<
+        integrators::BlockTimestepOptions{ .particle_count = 7500, .max_rung = 4 },
+        40>(400.0f, &pool);
+}
+
+// Run once per precision configuration, the default being single precision.
+void do_precision_case() {
+    parallel::ThreadPool pool;
+
+    std::cout << "Storing particles in " << 8 * sizeof(NBS_PRECISION)
+              << "-bit precision, computing direct forces in "
+              << 8 * sizeof(NBS_COMPUTE_PRECISION) << "-bit precision" << std::endl;
+
+    do_precision_job<1000, 20>(0.0, &pool);
+    do_precision_job<1000, 20>(1e8, &pool);
+}
+
+void do_radix_tree_benchmark_case() {
+    parallel::ThreadPool pool;
+
+    do_radix_tree_benchmark_job<2, MyParticle2D, 1000000, 10>(&pool);
+    do_radix_tree_benchmark_job<3, MyParticle, 1000000, 10>(&pool);
+}
+
+void do_load_balance_benchmark_case() {
+    constexpr size_t cluster_count = 50;
+    constexpr size_t iterations    = 20;
+
+    MyParticle2D*                      particles;
+    cluster::Cluster<2, MyParticle2D>* clusters;
+
+    do_a_cluster_job_a1<cluster_count, 1>(particles, clusters);
+
+    const cluster::Cluster<2, MyParticle2D>* a1_clusters = clusters + cluster_count;
+
+    size_t min_cluster_size = 7500, max_cluster_size = 0;
+    for (size_t cluster_idx = 0; cluster_idx < cluster_count; ++cluster_idx) {
+        min_cluster_size
+            = std::min(min_cluster_size, a1_clusters[cluster_idx].particle_count);
+        max_cluster_size
+            = std::max(max_cluster_size, a1_clusters[cluster_idx].particle_count);
+    }
+
+    parallel::ThreadPool pool;
+    const ui32           worker_count = pool.thread_count();
+
+    forces::DirectKernelScratch<2>* scratch
+        = new forces::DirectKernelScratch<2>[worker_count]{};
+    f32* busy_seconds = new f32[worker_count];
+
+    // Direct sum within each cluster, costing its size squared.
+    auto cluster_work = [&](size_t cluster_idx, ui32 worker_idx) {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        const auto& cluster = a1_clusters[cluster_idx];
+        forces::gather_direct_kernel_scratch<2, MyParticle2D>(
+            particles + cluster.particle_offset,
+            cluster.particle_count,
+            scratch[worker_idx]
+        );
+        forces::direct_sum_symmetric<2, forces::laws::Gravity>(
+            scratch[worker_idx], cluster.particle_count
+        );
+
+        busy_seconds[worker_idx]
+            += std::chrono::duration_cast<std::chrono::duration<f32>>(
+                   std::chrono::high_resolution_clock::now() - start
+            )
+                   .count();
+    };
+
+    auto report = [&](const char*                                 name,
+                      std::chrono::high_resolution_clock::duration duration) {
+        f32 max_busy = 0.0f, total_busy = 0.0f;
+        for (ui32 worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+            max_busy    = std::max(max_busy, busy_seconds[worker_idx]);
+            total_busy += busy_seconds[worker_idx];
+        }
+
+        std::cout << "    " << name << " "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(duration)
+                             .count()
+                         / iterations
+                  << "us per pass, busiest worker at "
+                  << max_busy / (total_busy / static_cast<f32>(worker_count))
+                  << "x the mean" << std::endl;
+
+        std::fill_n(busy_seconds, worker_count, 0.0f);
+    };
+
+    std::cout << "Direct sums over " << cluster_count << " A1 clusters of "
+              << min_cluster_size << " to " << max_cluster_size << " particles on "
+              << worker_count << " workers:" << std::endl;
+
+    std::fill_n(busy_seconds, worker_count, 0.0f);
+
+    // Each worker takes an equal run of clusters.
+    auto static_job = [&](ui32 worker_idx) {
+        const size_t begin = cluster_count * worker_idx / worker_count;
+        const size_t end   = cluster_count * (worker_idx + 1) / worker_count;
+        for (size_t cluster_idx = begin; cluster_idx < end; ++cluster_idx) {
+            cluster_work(cluster_idx, worker_idx);
+        }
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t iteration = 0; iteration < iterations; ++iteration) {
+        pool.run(static_job);
+    }
+    report("static partition:", std::chrono::high_resolution_clock::now() - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t iteration = 0; iteration < iterations; ++iteration) {
+        parallel::parallel_for(&pool, 0, cluster_count, 1, cluster_work);
+    }
+    report("work stealing:   ", std::chrono::high_resolution_clock::now() - start);
+
+    for (ui32 worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+        forces::deallocate_direct_kernel_scratch(scratch[worker_idx]);
+    }
+    delete[] scratch;
+    delete[] busy_seconds;
+
+    delete[] particles;
+    delete[] clusters;
+}
+
+void do_k_means_empty_cluster_case() {
+    constexpr cluster::KMeansOptions options
+        = { .particle_count = 6, .cluster_count = 3, .max_iterations = 100 };
+
+    do_k_means_empty_cluster_job<options>("uncapped");
+
+    // Only with the empty cluster is there room for the particles capping moves.
+    constexpr cluster::KMeansOptions capped_options = { .particle_count   = 6,
+                                                        .cluster_count    = 3,
+                                                        .max_iterations   = 100,
+                                                        .max_cluster_size = 2 };
+
+    do_k_means_empty_cluster_job<capped_options>("capped at 2");
+}
+
+void do_neighbour_list_reuse_case() {
+    using ShortRangeLaw = forces::laws::Repulsion6<1000>;
+
+    // Particles move no further than max_step_displacement in a step, so lists need
+    // rebuilding only every steps_per_rebuild steps once the skin is twice as far as
+    // particles go in that many steps.
+    constexpr f32    max_speed = 0.01f;
+    constexpr f32    time_step = 1.0f;
+    constexpr f32    max_step_displacement
+        = std::numbers::sqrt2_v<f32> * max_speed * time_step;
+    constexpr size_t steps_per_rebuild = 10;
+
+    constexpr spatial::CellListOptions options{
+        .particle_count    = 4000,
+        .cutoff_radius     = ShortRangeLaw::cutoff_radius,
+        .max_cells_on_axis = 128,
+        .skin = 2.0f * static_cast<f32>(steps_per_rebuild) * max_step_displacement,
+    };
+
+    parallel::ThreadPool pool;
+
+    do_neighbour_list_reuse_job<ShortRangeLaw, options, 100>(
+        64.0f, max_speed, time_step, &pool
+    );
+}
+
+// RESPA against leapfrog stepping all forces at its substep and at its step, over
+// the same span, for the clusters of the A1 simulation and for five times as many.
+void do_a1_respa_case() {
+    constexpr f32 substep = A1_TIME_STEP / A1_RESPA_OPTIONS.substeps;
+
+    parallel::ThreadPool pool;
+
+    do_a1_integrator_job<integrators::Leapfrog, 160, 50>(
+        "Leapfrog at RESPA's substep, 50 clusters", substep, &pool
+    );
+    do_a1_integrator_job<integrators::Leapfrog, 40, 50>(
+        "Leapfrog at RESPA's step, 50 clusters", A1_TIME_STEP, &pool
+    );
+    do_a1_respa_job<40, 50>("RESPA, 50 clusters", &pool);
+
+    do_a1_integrator_job<integrators::Leapfrog, 160, 250>(
+        "Leapfrog at RESPA's substep, 250 clusters", substep, &pool
+    );
+    do_a1_integrator_job<integrators::Leapfrog, 40, 250>(
+        "Leapfrog at RESPA's step, 250 clusters", A1_TIME_STEP, &pool
+    );
+    do_a1_respa_job<40, 250>("RESPA, 250 clusters", &pool);
 }
 
 int main() {
@@ -476,6 +2064,19 @@ int main() {
                  "  - A1 Dataset Case              (3)\n"
                  "  - A1 Dataset Performance Case  (4)\n"
                  "  - A1 Dataset Optimise KPP Case (5)\n"
+                 "  - FMM Accuracy Check           (6)\n"
+                 "  - Direct Kernel Benchmark      (7)\n"
+                 "  - A1 Integrators Check         (8)\n"
+                 "  - A1 Block Timestep Check      (9)\n"
+                 "  - PM Accuracy Check            (a)\n"
+                 "  - P3M Accuracy Check           (b)\n"
+                 "  - Ewald Accuracy Check         (c)\n"
+                 "  - Precision Check              (d)\n"
+                 "  - Radix Tree Benchmark         (e)\n"
+                 "  - Load Balance Benchmark       (f)\n"
+                 "  - K-Means Empty Cluster Check  (g)\n"
+                 "  - Neighbour List Reuse Check   (h)\n"
+                 "  - A1 RESPA Check               (i)\n"
               << std::endl;
 
     char resp;
@@ -491,5 +2092,31 @@ int main() {
         do_a1_dataset_performance_case();
     } else if (resp == '5') {
         do_a1_dataset_optimise_kpp_case();
+    } else if (resp == '6') {
+        do_fmm_accuracy_case();
+    } else if (resp == '7') {
+        do_direct_kernel_benchmark_case();
+    } else if (resp == '8') {
+        do_a1_integrators_case();
+    } else if (resp == '9') {
+        do_a1_block_timestep_case();
+    } else if (resp == 'a') {
+        do_pm_accuracy_case();
+    } else if (resp == 'b') {
+        do_p3m_accuracy_case();
+    } else if (resp == 'c') {
+        do_ewald_accuracy_case();
+    } else if (resp == 'd') {
+        do_precision_case();
+    } else if (resp == 'e') {
+        do_radix_tree_benchmark_case();
+    } else if (resp == 'f') {
+        do_load_balance_benchmark_case();
+    } else if (resp == 'g') {
+        do_k_means_empty_cluster_case();
+    } else if (resp == 'h') {
+        do_neighbour_list_reuse_case();
+    } else if (resp == 'i') {
+        do_a1_respa_case();
     }
 }
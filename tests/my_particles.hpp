@@ -3,17 +3,20 @@
 
 #pragma once
 
+// Particle state is held in NBS_PRECISION, so that the tests run under any of the
+// precision configurations in precision.hpp.
 struct MyParticle2D {
-    nbs::f32v2 position;
-    size_t     cluster_metadata_idx;
-    nbs::f32v2 force;
-    nbs::f32v2 velocity;
+    nbs::vec<2, NBS_PRECISION> position;
+    size_t                     cluster_metadata_idx;
+    nbs::vec<2, NBS_PRECISION> force;
+    nbs::vec<2, NBS_PRECISION> velocity;
+    NBS_PRECISION              potential;
 };
 
 struct MyParticle {
-    nbs::f32v3 position;
-    size_t     cluster_metadata_idx;
-    nbs::f32v2 force;
+    nbs::vec<3, NBS_PRECISION> position;
+    size_t                     cluster_metadata_idx;
+    nbs::vec<3, NBS_PRECISION> force;
 };
 
 #endif  // N_BODY_SIM_TESTS_MY_PARTICLES_HPP